@@ -54,6 +54,9 @@ namespace c
     void handle_event_count(int event);
     int handle_event(int event, void *edata);
 
+    /// The plugin event function of @a c if it is a plugin continuation, else @c nullptr.
+    static const void *event_function(const Continuation *c);
+
   protected:
     virtual void clear();
     virtual void free();
@@ -39,16 +39,90 @@
 
 #pragma once
 
+#include <atomic>
 #include <new>
 #include <cstdlib>
 #include <utility>
 #include "tscore/ink_queue.h"
 #include "tscore/ink_defs.h"
 #include "tscore/ink_resource.h"
+#include "tscore/numa.h"
 #include <execinfo.h>
 
 #define RND16(_x) (((_x) + 15) & ~15)
 
+/** Full magazines of free blocks passed between the per thread caches of one allocator.
+
+    A magazine is a chain of free blocks linked through their first word. Moving a whole magazine
+    in or out of the depot takes one lock, where moving the blocks through the allocator free pool
+    takes an atomic operation for each of them (a single one for a bulk free).
+ */
+class MagazineDepot
+{
+public:
+  static constexpr int CAPACITY = 16; ///< Magazines held, more go back to the free pool.
+
+  /** Take a full magazine.
+
+      Magazines of another NUMA node than the calling thread are left for the threads of that node.
+
+      @param head set to the first block of the magazine.
+      @param count set to the number of blocks in the magazine.
+      @return @c false if the depot has no magazine for the calling thread.
+   */
+  bool
+  get(void *&head, int &count)
+  {
+    if (n.load(std::memory_order_relaxed) == 0) {
+      return false;
+    }
+
+    ink_scoped_mutex_lock lock(mutex);
+    int last = n.load(std::memory_order_relaxed) - 1;
+    for (int i = last; i >= 0; --i) {
+      if (!ats_numa_remote(magazines[i].head)) {
+        head         = magazines[i].head;
+        count        = magazines[i].count;
+        magazines[i] = magazines[last];
+        n.store(last, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** Store a full magazine, the chain must end with @c nullptr.
+
+      @return @c false if the depot is full.
+   */
+  bool
+  put(void *head, int count)
+  {
+    if (n.load(std::memory_order_relaxed) == CAPACITY) {
+      return false;
+    }
+
+    ink_scoped_mutex_lock lock(mutex);
+    int i = n.load(std::memory_order_relaxed);
+    if (i == CAPACITY) {
+      return false;
+    }
+    magazines[i] = {head, count};
+    n.store(i + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+private:
+  struct Magazine {
+    void *head;
+    int count;
+  };
+
+  ink_mutex mutex = PTHREAD_MUTEX_INITIALIZER;
+  std::atomic<int> n{0}; ///< Number of magazines, read without the lock to skip an empty or full depot.
+  Magazine magazines[CAPACITY];
+};
+
 /** Allocator for fixed size memory blocks. */
 class FreelistAllocator
 {
@@ -122,6 +196,9 @@ public:
     return *this;
   }
 
+  /// Magazines of the per thread caches of this allocator.
+  MagazineDepot depot;
+
 protected:
   InkFreeList *fl;
 };
@@ -215,6 +292,9 @@ public:
     return *this;
   }
 
+  /// Magazines of the per thread caches of this allocator.
+  MagazineDepot depot;
+
 private:
   unsigned int element_size;
   unsigned int alignment;
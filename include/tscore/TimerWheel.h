@@ -0,0 +1,390 @@
+/** @file
+
+  Hierarchical timing wheel.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include "tscore/ink_assert.h"
+#include "tscore/ink_hrtime.h"
+#include "tscore/List.h"
+
+#include <array>
+#include <cstdint>
+
+/// Counters of a @c TimerWheel, which may be shared by several wheels.
+struct TimerWheelStats {
+  int64_t timers  = 0; ///< Elements in the wheel.
+  int64_t expired = 0; ///< Elements which expired.
+  ink_hrtime lag  = 0; ///< Sum of the delays between the expiration time and expiration.
+};
+
+/// Layout of a @c TimerWheel, independent of the element type.
+struct TimerWheelBase {
+  static constexpr int SLOT_BITS     = 8;
+  static constexpr int SLOTS         = 1 << SLOT_BITS; ///< Slots per level.
+  static constexpr int LEVELS        = 4;              ///< Covers 2^32 ticks.
+  static constexpr uint32_t READY    = LEVELS * SLOTS; ///< Slot of the expired elements.
+  static constexpr uint32_t OVERFLOW = READY + 1;      ///< Slot of the elements beyond the last level.
+  static constexpr uint32_t NO_SLOT  = OVERFLOW + 1;   ///< Not in a wheel.
+  /// Ticks between sweeps of one slot of the upper levels.
+  static constexpr int64_t SWEEP_TICKS = 16;
+};
+
+/// Link cell for elements of a @c TimerWheel.
+template <class C> struct TimerWheelLink : public Link<C> {
+  ink_hrtime expire_at = 0;                       ///< Expiration time, valid while in a wheel.
+  uint32_t slot        = TimerWheelBase::NO_SLOT; ///< Slot in the wheel.
+};
+
+/// Element access of a @c TimerWheel through the @c TimerWheelLink member @a F of @a C.
+template <class C, TimerWheelLink<C> C::*F> struct TimerWheelLinkAccess {
+  static C *&
+  next(C *c)
+  {
+    return (c->*F).next;
+  }
+  static C *&
+  prev(C *c)
+  {
+    return (c->*F).prev;
+  }
+  static ink_hrtime &
+  expire_at(C *c)
+  {
+    return (c->*F).expire_at;
+  }
+  static uint32_t
+  slot(const C *c)
+  {
+    return (c->*F).slot;
+  }
+  static void
+  set_slot(C *c, uint32_t slot)
+  {
+    (c->*F).slot = slot;
+  }
+};
+
+/** Hierarchical timing wheel of intrusive elements.
+
+    Time is cut in ticks of the wheel granularity. Each of the @c LEVELS levels has @c SLOTS slots,
+    a slot of level @a n covering @c SLOTS^n ticks. An element is placed in the level of the
+    highest digit in which its expiration tick differs from the current tick, so inserting and
+    removing an element is constant time. As the current tick advances the slots of the upper
+    levels are spread over the lower levels once they are reached, and the elements of a reached
+    slot of the lowest level are ready. An element may become ready up to one tick early.
+
+    Element access is by @a A, which provides the static functions of @c TimerWheelLinkAccess.
+    The wheel does not own its elements.
+ */
+template <class C, class A> class TimerWheel : public TimerWheelBase
+{
+public:
+  explicit TimerWheel(ink_hrtime granularity, ink_hrtime now = ink_get_hrtime())
+    : _granularity(granularity), _now(now / granularity), _now_time(now)
+  {
+  }
+
+  // noncopyable, the elements link back to the wheel slots.
+  TimerWheel(const TimerWheel &)            = delete;
+  TimerWheel &operator=(const TimerWheel &) = delete;
+
+  /// Add @a c to expire at @a at.
+  void insert(C *c, ink_hrtime at);
+  /// Take @a c out of the wheel.
+  void remove(C *c);
+  /// Whether @a c is in a wheel.
+  static bool in(const C *c);
+
+  /** Move the current time up to @a now, making the elements which expired ready.
+
+      Elements met while spreading out upper level slots and a few others each call are passed to
+      @a discard, a functor returning @c true if it disposed of the element, for example because
+      it was cancelled. It must not change the wheel.
+   */
+  template <typename F> void advance(ink_hrtime now, F &&discard);
+
+  /// Take the next ready element out of the wheel, @c nullptr if there is none.
+  C *pop_ready();
+
+  /// Time at which an element may be ready next, no later than the expiration of any element.
+  ink_hrtime earliest() const;
+
+  /// Number of elements in the wheel.
+  int64_t
+  size() const
+  {
+    return _count;
+  }
+
+  /// Count elements in @a stats, in addition to the wheel's own count.
+  void
+  set_stats(TimerWheelStats *stats)
+  {
+    stats->timers += _count;
+    _stats         = stats;
+  }
+
+private:
+  struct Slot {
+    C *head = nullptr;
+    C *tail = nullptr;
+  };
+
+  int64_t
+  _tick(ink_hrtime t) const
+  {
+    return t / _granularity;
+  }
+
+  void _place(C *c);
+  void _link(uint32_t slot, C *c);
+  void _unlink(C *c);
+  template <typename F> void _spread(uint32_t slot, F &discard);
+  int _next_occupied(int level, int after) const;
+
+  ink_hrtime _granularity;
+  int64_t _now;         ///< Current tick.
+  ink_hrtime _now_time; ///< Time of the last advance.
+  int64_t _count      = 0;
+  int64_t _next_sweep = 0;     ///< Tick of the next sweep.
+  uint32_t _sweep     = SLOTS; ///< Next slot to sweep, in the upper levels.
+
+  std::array<Slot, NO_SLOT> _slots;
+  std::array<uint64_t, LEVELS * SLOTS / 64> _occupied = {}; ///< Bit per non-empty slot of a level.
+
+  TimerWheelStats _own_stats;
+  TimerWheelStats *_stats = &_own_stats;
+};
+
+template <class C, class A>
+inline bool
+TimerWheel<C, A>::in(const C *c)
+{
+  return A::slot(c) != NO_SLOT;
+}
+
+template <class C, class A>
+inline void
+TimerWheel<C, A>::_link(uint32_t slot, C *c)
+{
+  Slot &s = _slots[slot];
+
+  A::next(c) = nullptr;
+  A::prev(c) = s.tail;
+  if (s.tail) {
+    A::next(s.tail) = c;
+  } else {
+    s.head = c;
+    if (slot < READY) {
+      _occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+    }
+  }
+  s.tail = c;
+  A::set_slot(c, slot);
+}
+
+template <class C, class A>
+inline void
+TimerWheel<C, A>::_unlink(C *c)
+{
+  uint32_t slot = A::slot(c);
+  Slot &s       = _slots[slot];
+
+  ink_assert(slot < NO_SLOT);
+  if (A::prev(c)) {
+    A::next(A::prev(c)) = A::next(c);
+  } else {
+    s.head = A::next(c);
+  }
+  if (A::next(c)) {
+    A::prev(A::next(c)) = A::prev(c);
+  } else {
+    s.tail = A::prev(c);
+  }
+  if (s.head == nullptr && slot < READY) {
+    _occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+  }
+  A::next(c) = A::prev(c) = nullptr;
+  A::set_slot(c, NO_SLOT);
+}
+
+template <class C, class A>
+inline void
+TimerWheel<C, A>::_place(C *c)
+{
+  int64_t tick = _tick(A::expire_at(c));
+
+  if (tick <= _now) {
+    _link(READY, c);
+    return;
+  }
+
+  // The highest digit in which the expiration differs from now picks the level. The slot of
+  // that digit is ahead of the current one, so it is reached no later than the expiration.
+  uint64_t diff = static_cast<uint64_t>(tick ^ _now);
+  int level     = (63 - __builtin_clzll(diff)) / SLOT_BITS;
+
+  if (level >= LEVELS) {
+    _link(OVERFLOW, c);
+  } else {
+    _link(level * SLOTS + ((tick >> (level * SLOT_BITS)) & (SLOTS - 1)), c);
+  }
+}
+
+template <class C, class A>
+inline void
+TimerWheel<C, A>::insert(C *c, ink_hrtime at)
+{
+  A::expire_at(c) = at;
+  _place(c);
+  ++_count;
+  ++_stats->timers;
+}
+
+template <class C, class A>
+inline void
+TimerWheel<C, A>::remove(C *c)
+{
+  _unlink(c);
+  --_count;
+  --_stats->timers;
+}
+
+template <class C, class A>
+inline C *
+TimerWheel<C, A>::pop_ready()
+{
+  C *c = _slots[READY].head;
+
+  if (c != nullptr) {
+    remove(c);
+    ++_stats->expired;
+    if (_now_time > A::expire_at(c)) {
+      _stats->lag += _now_time - A::expire_at(c);
+    }
+  }
+  return c;
+}
+
+template <class C, class A>
+inline int
+TimerWheel<C, A>::_next_occupied(int level, int after) const
+{
+  for (int i = after + 1; i < SLOTS;) {
+    int slot      = level * SLOTS + i;
+    uint64_t bits = _occupied[slot / 64] >> (slot % 64);
+    if (bits) {
+      return i + __builtin_ctzll(bits);
+    }
+    i += 64 - (slot % 64);
+  }
+  return -1;
+}
+
+template <class C, class A>
+template <typename F>
+inline void
+TimerWheel<C, A>::_spread(uint32_t slot, F &discard)
+{
+  C *c = _slots[slot].head;
+
+  _slots[slot] = Slot{};
+  if (slot < READY) {
+    _occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+  }
+  while (c != nullptr) {
+    C *next = A::next(c);
+    A::set_slot(c, NO_SLOT);
+    if (discard(c)) {
+      --_count;
+      --_stats->timers;
+    } else {
+      _place(c);
+    }
+    c = next;
+  }
+}
+
+template <class C, class A>
+template <typename F>
+void
+TimerWheel<C, A>::advance(ink_hrtime now, F &&discard)
+{
+  int64_t target = _tick(now);
+
+  _now_time = now;
+  while (_now < target) {
+    // Skip to the next tick with ready elements or upper level slots to spread out, at the
+    // latest the next boundary of the first level.
+    int slot     = _next_occupied(0, _now & (SLOTS - 1));
+    int64_t next = slot < 0 ? ((_now >> SLOT_BITS) + 1) << SLOT_BITS : (_now & ~int64_t(SLOTS - 1)) + slot;
+
+    if (next > target) {
+      _now = target;
+      break;
+    }
+    _now = next;
+
+    if ((_now & ((int64_t(1) << (LEVELS * SLOT_BITS)) - 1)) == 0) {
+      _spread(OVERFLOW, discard);
+    }
+    for (int level = LEVELS - 1; level > 0; --level) {
+      if ((_now & ((int64_t(1) << (level * SLOT_BITS)) - 1)) == 0) {
+        _spread(level * SLOTS + ((_now >> (level * SLOT_BITS)) & (SLOTS - 1)), discard);
+      }
+    }
+    for (C *c; (c = _slots[_now & (SLOTS - 1)].head) != nullptr;) {
+      _unlink(c);
+      _link(READY, c);
+    }
+  }
+
+  // Elements far in the future are otherwise only looked at once their slot is reached.
+  if (_now >= _next_sweep) {
+    _spread(_sweep, discard);
+    _sweep      = _sweep + 1 < READY ? _sweep + 1 : SLOTS;
+    _next_sweep = _now + SWEEP_TICKS;
+  }
+}
+
+template <class C, class A>
+ink_hrtime
+TimerWheel<C, A>::earliest() const
+{
+  if (_slots[READY].head) {
+    return _now_time;
+  }
+  // Elements of a level expire before those of the levels above, so the first occupied slot of
+  // the lowest occupied level starts no later than the first expiration.
+  for (int level = 0; level < LEVELS; ++level) {
+    int shift = level * SLOT_BITS;
+    if (int slot = _next_occupied(level, (_now >> shift) & (SLOTS - 1)); slot >= 0) {
+      int64_t tick = (((_now >> shift) & ~int64_t(SLOTS - 1)) + slot) << shift;
+      return tick * _granularity;
+    }
+  }
+  if (_slots[OVERFLOW].head) {
+    return (((_now >> (LEVELS * SLOT_BITS)) + 1) << (LEVELS * SLOT_BITS)) * _granularity;
+  }
+  return _now_time + HRTIME_FOREVER;
+}
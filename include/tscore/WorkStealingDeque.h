@@ -0,0 +1,132 @@
+/** @file
+
+  Bounded work stealing deque.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/** Chase-Lev deque of pointers with a fixed capacity.
+
+    One owner thread pushes and pops at the bottom, any thread steals at the top, so the owner
+    works LIFO and thieves take the oldest elements. This follows "Correct and Efficient
+    Work-Stealing for Weak Memory Models" (Lê et al.), without growing the buffer: @c push fails
+    if the deque is full.
+
+    @a N must be a power of 2.
+ */
+template <class T, size_t N> class WorkStealingDeque
+{
+  static_assert(N > 0 && (N & (N - 1)) == 0, "Capacity must be a power of 2");
+
+public:
+  static constexpr size_t CAPACITY = N;
+
+  /// Add @a t at the bottom, owner only. @return @c false if the deque is full.
+  bool
+  push(T *t)
+  {
+    int64_t b = _bottom.load(std::memory_order_relaxed);
+    int64_t s = _top.load(std::memory_order_acquire);
+
+    if (b - s >= static_cast<int64_t>(N)) {
+      return false;
+    }
+    _slots[b & MASK].store(t, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// Take the newest element, owner only. @return @c nullptr if the deque is empty.
+  T *
+  pop()
+  {
+    int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t s = _top.load(std::memory_order_relaxed);
+    T *t      = nullptr;
+
+    if (s <= b) {
+      t = _slots[b & MASK].load(std::memory_order_relaxed);
+      if (s == b) {
+        // Last element, race the thieves for it.
+        if (!_top.compare_exchange_strong(s, s + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+          t = nullptr;
+        }
+        _bottom.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return t;
+  }
+
+  /** Take the oldest element, any thread.
+
+      @return @c nullptr if the deque is empty or another thread took the element first.
+   */
+  T *
+  steal()
+  {
+    int64_t s = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = _bottom.load(std::memory_order_acquire);
+
+    if (s < b) {
+      T *t = _slots[s & MASK].load(std::memory_order_relaxed);
+      if (_top.compare_exchange_strong(s, s + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return t;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Number of elements, exact only for the owner.
+  size_t
+  size() const
+  {
+    int64_t b = _bottom.load(std::memory_order_relaxed);
+    int64_t s = _top.load(std::memory_order_relaxed);
+    return b > s ? b - s : 0;
+  }
+
+  bool
+  empty() const
+  {
+    return size() == 0;
+  }
+
+private:
+  static constexpr int64_t MASK = N - 1;
+
+  // The thieves write _top, the owner _bottom, keep them on separate cache lines.
+  std::atomic<int64_t> _top{0};
+  char _pad0[64 - sizeof(std::atomic<int64_t>)];
+  std::atomic<int64_t> _bottom{0};
+  char _pad1[64 - sizeof(std::atomic<int64_t>)];
+  std::array<std::atomic<T *>, N> _slots{};
+};
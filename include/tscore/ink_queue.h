@@ -182,6 +182,11 @@ union head_p {
 #error "unsupported processor"
 #endif
 
+/// The free items of one NUMA node, each on its own cache line.
+struct alignas(64) InkFreeListNode {
+  head_p head;
+};
+
 struct _InkFreeList {
   head_p head;
   const char *name;
@@ -190,6 +195,7 @@ struct _InkFreeList {
   uint32_t hugepages_failure;
   bool use_hugepages;
   int advice;
+  InkFreeListNode *nodes; ///< Free items by NUMA node, nullptr unless the NUMA arenas are in use.
 };
 
 typedef struct ink_freelist_ops InkFreeListOps;
@@ -212,6 +218,11 @@ void ink_freelist_madvise_init(InkFreeList **fl, const char *name, uint32_t type
 void *ink_freelist_new(InkFreeList *f);
 void ink_freelist_free(InkFreeList *f, void *item);
 void ink_freelist_free_bulk(InkFreeList *f, void *head, void *tail, size_t num_item);
+/*
+ * Split the free items of every freelist by NUMA node, call once after
+ * ats_numa_init() while still single threaded.
+ */
+void ink_freelists_numa_init();
 void ink_freelists_dump(FILE *f);
 void ink_freelists_dump_baselinerel(FILE *f);
 void ink_freelists_snap_baseline();
@@ -0,0 +1,70 @@
+/** @file
+
+  NUMA node local memory arenas.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Each NUMA node gets a slice of one contiguous address range whose pages are bound to that
+  node. Memory carved from a slice is node local no matter which thread first touches it, and
+  the node that owns any pointer is found with a subtraction and a shift.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// Log2 of the address space reserved for each node's arena (64GB).
+static constexpr int ATS_NUMA_ARENA_SHIFT = 36;
+/// Most nodes that get an arena, bounding the reservation.
+static constexpr int ATS_NUMA_MAX_NODES = 64;
+
+extern char *ats_numa_arena_base;
+extern size_t ats_numa_arena_size;
+
+/// The arena index of the node the calling thread is bound to, or -1 if it may run on several nodes.
+extern thread_local int ats_numa_thread_node;
+
+/// Reserve the arenas if @a enabled and the host has more than one NUMA node.
+void ats_numa_init(int enabled);
+/// Reserve arenas for @a nodes nodes without binding their memory, so the routing by node can be tested on any host.
+void ats_numa_init_unbound(int nodes);
+/// Whether the arenas are in use.
+bool ats_numa_enabled();
+/// Number of nodes with an arena, 0 if disabled.
+int ats_numa_node_count();
+/// The arena index of the node for the processor @a cpu, or -1 if unknown.
+int ats_numa_cpu_node(int cpu);
+/// Allocate @a size bytes, page aligned, from the arena of @a node. Returns nullptr if the arena is exhausted.
+void *ats_numa_alloc(size_t size, int node);
+
+/// The arena index of the node that owns @a ptr, or -1 if it was not allocated from an arena.
+inline int
+ats_numa_node_of(const void *ptr)
+{
+  uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - reinterpret_cast<uintptr_t>(ats_numa_arena_base);
+  return offset < ats_numa_arena_size ? static_cast<int>(offset >> ATS_NUMA_ARENA_SHIFT) : -1;
+}
+
+/// Whether @a ptr is arena memory of a node other than the one the calling thread is bound to.
+inline bool
+ats_numa_remote(const void *ptr)
+{
+  int node = ats_numa_node_of(ptr);
+  return node >= 0 && node != ats_numa_thread_node;
+}
@@ -534,35 +534,36 @@ AIOThreadInfo::aio_thread_main(AIOThreadInfo *thr_info)
 namespace
 {
 
+// @a fd is either the file descriptor or, if IOSQE_FIXED_FILE is set on @a sqe, the fixed file index.
 void
-prep_read(io_uring_sqe *sqe, AIOCallbackInternal *op)
+prep_read(io_uring_sqe *sqe, int fd, AIOCallbackInternal *op)
 {
-  io_uring_prep_read(sqe, op->aiocb.aio_fildes, op->aiocb.aio_buf, op->aiocb.aio_nbytes, op->aiocb.aio_offset);
+  io_uring_prep_read(sqe, fd, op->aiocb.aio_buf, op->aiocb.aio_nbytes, op->aiocb.aio_offset);
 }
 
 void
-prep_readv(io_uring_sqe *sqe, AIOCallbackInternal *op)
+prep_readv(io_uring_sqe *sqe, int fd, AIOCallbackInternal *op)
 {
   op->iov.iov_len  = op->aiocb.aio_nbytes;
   op->iov.iov_base = op->aiocb.aio_buf;
-  io_uring_prep_readv(sqe, op->aiocb.aio_fildes, &op->iov, 1, op->aiocb.aio_offset);
+  io_uring_prep_readv(sqe, fd, &op->iov, 1, op->aiocb.aio_offset);
 }
 
 void
-prep_write(io_uring_sqe *sqe, AIOCallbackInternal *op)
+prep_write(io_uring_sqe *sqe, int fd, AIOCallbackInternal *op)
 {
-  io_uring_prep_write(sqe, op->aiocb.aio_fildes, op->aiocb.aio_buf, op->aiocb.aio_nbytes, op->aiocb.aio_offset);
+  io_uring_prep_write(sqe, fd, op->aiocb.aio_buf, op->aiocb.aio_nbytes, op->aiocb.aio_offset);
 }
 
 void
-prep_writev(io_uring_sqe *sqe, AIOCallbackInternal *op)
+prep_writev(io_uring_sqe *sqe, int fd, AIOCallbackInternal *op)
 {
   op->iov.iov_len  = op->aiocb.aio_nbytes;
   op->iov.iov_base = op->aiocb.aio_buf;
-  io_uring_prep_writev(sqe, op->aiocb.aio_fildes, &op->iov, 1, op->aiocb.aio_offset);
+  io_uring_prep_writev(sqe, fd, &op->iov, 1, op->aiocb.aio_offset);
 }
 
-using prep_op = void (*)(io_uring_sqe *, AIOCallbackInternal *);
+using prep_op = void (*)(io_uring_sqe *, int, AIOCallbackInternal *);
 
 prep_op prep_ops[] = {
   nullptr,
@@ -583,6 +584,34 @@ setup_prep_ops(IOUringContext *ur)
   }
 }
 
+/*
+ * Prepare @a op against the registered files and buffers where possible. Fixed files save the fd
+ * lookup and reference counting on every op, and READ/WRITE_FIXED avoid pinning the user pages for
+ * each transfer.
+ */
+void
+prep_op_fixed(IOUringContext *ur, io_uring_sqe *sqe, AIOCallbackInternal *op, int op_type)
+{
+  int fd         = op->aiocb.aio_fildes;
+  int file_index = ur->fixed_file(fd);
+  if (file_index >= 0) {
+    fd = file_index;
+  }
+
+  int buf_index = ur->fixed_buffer(op->aiocb.aio_buf, op->aiocb.aio_nbytes);
+  if (buf_index < 0) {
+    prep_ops[op_type](sqe, fd, op);
+  } else if (op_type == LIO_READ) {
+    io_uring_prep_read_fixed(sqe, fd, op->aiocb.aio_buf, op->aiocb.aio_nbytes, op->aiocb.aio_offset, buf_index);
+  } else {
+    io_uring_prep_write_fixed(sqe, fd, op->aiocb.aio_buf, op->aiocb.aio_nbytes, op->aiocb.aio_offset, buf_index);
+  }
+
+  if (file_index >= 0) {
+    sqe->flags |= IOSQE_FIXED_FILE;
+  }
+}
+
 void
 io_uring_prep_ops_internal(AIOCallbackInternal *op_in, int op_type)
 {
@@ -594,7 +623,7 @@ io_uring_prep_ops_internal(AIOCallbackInternal *op_in, int op_type)
 
     ink_release_assert(sqe != nullptr);
 
-    prep_ops[op_type](sqe, op);
+    prep_op_fixed(ur, sqe, op, op_type);
 
     op->aiocb.aio_lio_opcode = op_type;
     if (op->then) {
@@ -658,6 +687,20 @@ AIOCallbackInternal::handle_complete(io_uring_cqe *cqe)
 
 #endif
 
+void
+ink_aio_register_fixed(const std::vector<int> &fds, const std::vector<iovec> &buffers)
+{
+#if TS_USE_LINUX_IO_URING
+  if (use_io_uring) {
+    IOUringContext::set_fixed_resources(fds, buffers);
+    Note("io_uring: registered %zu fixed files and %zu fixed buffers for AIO", fds.size(), buffers.size());
+  }
+#else
+  (void)fds;
+  (void)buffers;
+#endif
+}
+
 int
 ink_aio_read(AIOCallback *op_in, int fromAPI)
 {
@@ -34,6 +34,9 @@
 #include "I_EventSystem.h"
 #include "records/I_RecProcess.h"
 
+#include <sys/uio.h>
+#include <vector>
+
 static constexpr ts::ModuleVersion AIO_MODULE_PUBLIC_VERSION(1, 0, ts::ModuleVersion::PUBLIC);
 
 #define AIO_EVENT_DONE (AIO_EVENT_EVENTS_START + 0)
@@ -82,4 +85,13 @@ void ink_aio_set_callback(Continuation *error_callback);
 int ink_aio_read(AIOCallback *op,
                  int fromAPI = 0); // fromAPI is a boolean to indicate if this is from an API call such as upload proxy feature
 int ink_aio_write(AIOCallback *op, int fromAPI = 0);
+
+/** Declare the file descriptors and buffers that carry most of the disk I/O.
+
+    With the io_uring backend these are registered as fixed files and fixed buffers on each ring, and
+    operations on them use IOSQE_FIXED_FILE and READ/WRITE_FIXED. This may be called at most once and
+    the descriptors and memory must remain valid for the life of the process. It has no effect with
+    the thread backend.
+ */
+void ink_aio_register_fixed(const std::vector<int> &fds, const std::vector<iovec> &buffers);
 AIOCallback *new_AIOCallback();
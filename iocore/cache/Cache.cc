@@ -63,6 +63,7 @@ int cache_config_ram_cache_algorithm           = 1;
 int cache_config_ram_cache_compress            = 0;
 int cache_config_ram_cache_compress_percent    = 90;
 int cache_config_ram_cache_use_seen_filter     = 1;
+int cache_config_ram_cache_shards              = 0;
 int cache_config_http_max_alts                 = 3;
 int cache_config_log_alternate_eviction        = 0;
 int cache_config_dir_sync_frequency            = 60;
@@ -78,6 +79,9 @@ int cache_config_force_sector_size             = 0;
 int cache_config_target_fragment_size          = DEFAULT_TARGET_FRAGMENT_SIZE;
 int cache_config_agg_write_backlog             = AGG_SIZE * 2;
 int cache_config_enable_checksum               = 0;
+int cache_config_dir_probe_filter              = 0;
+int cache_config_dir_optimistic_probe          = 0;
+int cache_config_dir_read_concurrency          = 4;
 int cache_config_alt_rewrite_max_size          = 4096;
 int cache_config_read_while_writer             = 0;
 int cache_config_mutex_retry_delay             = 2;
@@ -92,7 +96,6 @@ CacheDisk **gdisks                      = nullptr;
 int gndisks                             = 0;
 static std::atomic<int> initialize_disk = 0;
 Cache *caches[NUM_CACHE_FRAG_TYPES]     = {nullptr};
-CacheSync *cacheDirSync                 = nullptr;
 static Store theCacheStore;
 int CacheProcessor::initialized          = CACHE_INITIALIZING;
 uint32_t CacheProcessor::cache_ready     = 0;
@@ -135,6 +138,11 @@ struct VolInitInfo {
   off_t recover_pos;
   AIOCallbackInternal vol_aio[4];
   char *vol_h_f;
+  // directory read in pieces, see Vol::read_dir()
+  AIOCallbackInternal *dir_aio = nullptr;
+  int dir_aio_count            = 0;
+  int dir_aio_pending          = 0;
+  bool dir_aio_failed          = false;
 
   VolInitInfo()
   {
@@ -149,6 +157,11 @@ struct VolInitInfo {
       i.action = nullptr;
       i.mutex.clear();
     }
+    for (int i = 0; i < dir_aio_count; i++) {
+      dir_aio[i].action = nullptr;
+      dir_aio[i].mutex.clear();
+    }
+    delete[] dir_aio;
     free(vol_h_f);
   }
 };
@@ -159,6 +172,7 @@ int cplist_reconfigure();
 static int create_volume(int volume_number, off_t size_in_blocks, int scheme, CacheVol *cp);
 static void rebuild_host_table(Cache *cache);
 void register_cache_stats(RecRawStatBlock *rsb, const char *prefix);
+void register_stripe_stats(Vol *vol, int volume, int stripe);
 
 // Global list of the volumes created
 Queue<CacheVol> cp_list;
@@ -817,6 +831,25 @@ CacheProcessor::diskInitialized()
   }
 }
 
+// Hand the span descriptors and the stripe aggregation buffers, through which every cache write goes,
+// to AIO so they can be registered with io_uring.
+static void
+register_aio_fixed()
+{
+  std::vector<int> fds;
+  std::vector<iovec> buffers;
+
+  for (int i = 0; i < gndisks; i++) {
+    if (gdisks[i]->online) {
+      fds.push_back(gdisks[i]->fd);
+    }
+  }
+  for (int i = 0; i < gnvol; i++) {
+    buffers.push_back({gvol[i]->agg_buffer, AGG_SIZE});
+  }
+  ink_aio_register_fixed(fds, buffers);
+}
+
 void
 CacheProcessor::cacheInitialized()
 {
@@ -879,15 +912,24 @@ CacheProcessor::cacheInitialized()
 
     if (gnvol) {
       // new ram_caches, with algorithm from the config
+      RamCache *(*new_ram_cache)() = nullptr;
+      switch (cache_config_ram_cache_algorithm) {
+      default:
+      case RAM_CACHE_ALGORITHM_CLFUS:
+        new_ram_cache = new_RamCacheCLFUS;
+        break;
+      case RAM_CACHE_ALGORITHM_LRU:
+        new_ram_cache = new_RamCacheLRU;
+        break;
+      case RAM_CACHE_ALGORITHM_TINYLFU:
+        new_ram_cache = new_RamCacheTinyLFU;
+        break;
+      }
       for (i = 0; i < gnvol; i++) {
-        switch (cache_config_ram_cache_algorithm) {
-        default:
-        case RAM_CACHE_ALGORITHM_CLFUS:
-          gvol[i]->ram_cache = new_RamCacheCLFUS();
-          break;
-        case RAM_CACHE_ALGORITHM_LRU:
-          gvol[i]->ram_cache = new_RamCacheLRU();
-          break;
+        if (cache_config_ram_cache_shards > 1) {
+          gvol[i]->ram_cache = new_RamCacheSharded(cache_config_ram_cache_shards, new_ram_cache);
+        } else {
+          gvol[i]->ram_cache = new_ram_cache();
         }
       }
       // let us calculate the Size
@@ -981,6 +1023,11 @@ CacheProcessor::cacheInitialized()
       case CACHE_COMPRESSION_LIBLZMA:
 #ifndef HAVE_LZMA_H
         Fatal("lzma not available for RAM cache compression");
+#endif
+        break;
+      case CACHE_COMPRESSION_ZSTD:
+#ifndef HAVE_ZSTD_H
+        Fatal("zstd not available for RAM cache compression");
 #endif
         break;
       }
@@ -998,6 +1045,8 @@ CacheProcessor::cacheInitialized()
     }
   }
   if (cache_init_ok) {
+    register_aio_fixed();
+
     // Initialize virtual cache
     CacheProcessor::initialized = CACHE_INITIALIZED;
     CacheProcessor::cache_ready = caches_ready;
@@ -1219,6 +1268,11 @@ Vol::init(char *s, off_t blocks, off_t dir_skip, bool clear)
     raw_dir = static_cast<char *>(ats_memalign(ats_pagesize(), this->dirlen()));
   }
 
+  // Both on disk copies of the directory start out of date, the first sync of each writes it all.
+  ats_free(dir_dirty);
+  dir_dirty = static_cast<uint8_t *>(ats_malloc(segments));
+  memset(dir_dirty, DIR_SYNC_ALL_COPIES, segments);
+
   dir    = reinterpret_cast<Dir *>(raw_dir + this->headerlen());
   header = reinterpret_cast<VolHeaderFooter *>(raw_dir);
   footer = reinterpret_cast<VolHeaderFooter *>(raw_dir + this->dirlen() - ROUND_TO_STORE_BLOCK(sizeof(VolHeaderFooter)));
@@ -1229,6 +1283,7 @@ Vol::init(char *s, off_t blocks, off_t dir_skip, bool clear)
   }
 
   init_info           = new VolInitInfo();
+  init_start          = ink_get_hrtime();
   int footerlen       = ROUND_TO_STORE_BLOCK(sizeof(VolHeaderFooter));
   off_t footer_offset = this->dirlen() - footerlen;
   // try A
@@ -1293,6 +1348,16 @@ Vol::handle_dir_read(int event, void *data)
 
   if (event == AIO_EVENT_DONE) {
     if (static_cast<size_t>(op->aio_result) != op->aiocb.aio_nbytes) {
+      init_info->dir_aio_failed = true;
+    }
+    int pending = --init_info->dir_aio_pending;
+    CACHE_STRIPE_SET_DYN_STAT(this, cache_stripe_init_progress_stat,
+                              VOL_INIT_PROGRESS_HEADER + (VOL_INIT_PROGRESS_DIR - VOL_INIT_PROGRESS_HEADER) *
+                                                           (init_info->dir_aio_count - pending) / init_info->dir_aio_count);
+    if (pending) {
+      return EVENT_CONT;
+    }
+    if (init_info->dir_aio_failed) {
       Note("Directory read failed: clearing cache directory %s", this->hash_text.get());
       clear_dir();
       return EVENT_DONE;
@@ -1320,6 +1385,12 @@ Vol::handle_dir_read(int event, void *data)
 int
 Vol::recover_data()
 {
+  CACHE_STRIPE_SET_DYN_STAT(this, cache_stripe_init_progress_stat, VOL_INIT_PROGRESS_DIR);
+  // The directory was read in pieces with their own callbacks, recovery reads the data through io.
+  io.aiocb.aio_fildes = fd;
+  io.action           = this;
+  io.thread           = AIO_CALLBACK_THREAD_ANY;
+  io.then             = nullptr;
   SET_HANDLER(&Vol::handle_recover_from_data);
   return handle_recover_from_data(EVENT_IMMEDIATE, nullptr);
 }
@@ -1608,6 +1679,7 @@ Ldone : {
   init_info->vol_aio[2].aiocb.aio_nbytes = footerlen;
   init_info->vol_aio[2].aiocb.aio_offset = ss + dirlen - footerlen;
 
+  CACHE_STRIPE_SET_DYN_STAT(this, cache_stripe_init_progress_stat, VOL_INIT_PROGRESS_RECOVERED);
   SET_HANDLER(&Vol::handle_recover_write_dir);
   ink_assert(ink_aio_write(init_info->vol_aio));
   return EVENT_CONT;
@@ -1636,6 +1708,36 @@ Vol::handle_recover_write_dir(int /* event ATS_UNUSED */, void * /* data ATS_UNU
   return dir_init_done(EVENT_IMMEDIATE, nullptr);
 }
 
+/* Read the directory copy at @a offset into raw_dir. The read is split into
+   proxy.config.cache.dir.read_concurrency store block aligned pieces which are issued together,
+   so the AIO threads of the disk load a large directory in parallel. */
+void
+Vol::read_dir(off_t offset)
+{
+  size_t dirlen = this->dirlen();
+  int n         = std::max(cache_config_dir_read_concurrency, 1);
+  size_t piece  = ROUND_TO_STORE_BLOCK((dirlen + n - 1) / n);
+  n             = (dirlen + piece - 1) / piece;
+
+  init_info->dir_aio         = new AIOCallbackInternal[n];
+  init_info->dir_aio_count   = n;
+  init_info->dir_aio_pending = n;
+  init_info->dir_aio_failed  = false;
+  SET_HANDLER(&Vol::handle_dir_read);
+  for (int i = 0; i < n; i++) {
+    AIOCallback *aio      = &init_info->dir_aio[i];
+    size_t pos            = i * piece;
+    aio->aiocb.aio_fildes = fd;
+    aio->aiocb.aio_buf    = raw_dir + pos;
+    aio->aiocb.aio_nbytes = std::min(piece, dirlen - pos);
+    aio->aiocb.aio_offset = offset + pos;
+    aio->action           = this;
+    aio->thread           = AIO_CALLBACK_THREAD_ANY;
+    aio->then             = nullptr;
+    ink_assert(ink_aio_read(aio));
+  }
+}
+
 int
 Vol::handle_header_read(int event, void *data)
 {
@@ -1654,31 +1756,21 @@ Vol::handle_header_read(int event, void *data)
       }
       op = op->then;
     }
-
-    io.aiocb.aio_fildes = fd;
-    io.aiocb.aio_nbytes = this->dirlen();
-    io.aiocb.aio_buf    = raw_dir;
-    io.action           = this;
-    io.thread           = AIO_CALLBACK_THREAD_ANY;
-    io.then             = nullptr;
+    CACHE_STRIPE_SET_DYN_STAT(this, cache_stripe_init_progress_stat, VOL_INIT_PROGRESS_HEADER);
 
     if (hf[0]->sync_serial == hf[1]->sync_serial &&
         (hf[0]->sync_serial >= hf[2]->sync_serial || hf[2]->sync_serial != hf[3]->sync_serial)) {
-      SET_HANDLER(&Vol::handle_dir_read);
       if (is_dbg_ctl_enabled(dbg_ctl_cache_init)) {
         Note("using directory A for '%s'", hash_text.get());
       }
-      io.aiocb.aio_offset = skip;
-      ink_assert(ink_aio_read(&io));
+      read_dir(skip);
     }
     // try B
     else if (hf[2]->sync_serial == hf[3]->sync_serial) {
-      SET_HANDLER(&Vol::handle_dir_read);
       if (is_dbg_ctl_enabled(dbg_ctl_cache_init)) {
         Note("using directory B for '%s'", hash_text.get());
       }
-      io.aiocb.aio_offset = skip + this->dirlen();
-      ink_assert(ink_aio_read(&io));
+      read_dir(skip + this->dirlen());
     } else {
       Note("no good directory, clearing '%s' since sync_serials on both A and B copies are invalid", hash_text.get());
       Note("Header A: %d\nFooter A: %d\n Header B: %d\n Footer B %d\n", hf[0]->sync_serial, hf[1]->sync_serial, hf[2]->sync_serial,
@@ -1704,6 +1796,17 @@ Vol::dir_init_done(int /* event ATS_UNUSED */, void * /* data ATS_UNUSED */)
     int vol_no = gnvol++;
     ink_assert(!gvol[vol_no]);
     gvol[vol_no] = this;
+    CACHE_STRIPE_SET_DYN_STAT(this, cache_stripe_init_progress_stat, VOL_INIT_PROGRESS_DONE);
+    if (init_start) {
+      CACHE_STRIPE_SET_DYN_STAT(this, cache_stripe_init_time_stat, ink_hrtime_to_msec(ink_get_hrtime() - init_start));
+    }
+    if (cache_config_dir_probe_filter) {
+      dir_build_tag_filter(this);
+    }
+    // A sharded RAM cache reads fragments without the stripe lock, which needs the same probe.
+    if (cache_config_dir_optimistic_probe || cache_config_ram_cache_shards > 1) {
+      dir_init_optimistic_probe(this);
+    }
     SET_HANDLER(&Vol::aggWrite);
     cache->vol_initialized(fd != -1);
     return EVENT_DONE;
@@ -2031,6 +2134,7 @@ Cache::open(bool clear, bool /* fix ATS_UNUSED */)
             blocks                      = q->b->len;
 
             bool vol_clear = clear || d->cleared || q->new_block;
+            register_stripe_stats(cp->vols[vol_no], cp->vol_number, vol_no);
             cp->vols[vol_no]->init(d->path, blocks, q->b->offset, vol_clear);
             vol_no++;
             cache_size += blocks;
@@ -2294,21 +2398,39 @@ Cache::lookup(Continuation *cont, const CacheKey *key, CacheFragType type, const
 
   Vol *vol          = key_to_vol(key, hostname, host_len);
   ProxyMutex *mutex = cont->mutex.get();
-  CacheVC *c        = new_CacheVC(cont);
-  SET_CONTINUATION_HANDLER(c, &CacheVC::openReadStartHead);
-  c->vio.op    = VIO::READ;
-  c->base_stat = cache_lookup_active_stat;
-  CACHE_INCREMENT_DYN_STAT(c->base_stat + CACHE_STAT_ACTIVE);
-  c->first_key = c->key = *key;
-  c->frag_type          = type;
-  c->f.lookup           = 1;
-  c->vol                = vol;
-  c->last_collision     = nullptr;
+  CacheVC *c        = nullptr;
+  {
+    CACHE_TRY_LOCK(lock, vol->mutex, mutex->thread_holding);
+    if (!lock.is_locked()) {
+      CACHE_STRIPE_INCREMENT_DYN_STAT(vol, cache_stripe_lock_contention_stat);
+      // A definite miss can be answered without waiting for the stripe lock.
+      if (dir_absent_unlocked(key, vol)) {
+        CACHE_STRIPE_INCREMENT_DYN_STAT(vol, cache_stripe_unlocked_miss_stat);
+        CACHE_INCREMENT_DYN_STAT(cache_lookup_failure_stat);
+        cont->handleEvent(CACHE_EVENT_LOOKUP_FAILED, nullptr);
+        return ACTION_RESULT_DONE;
+      }
+    }
+    c = new_CacheVC(cont);
+    SET_CONTINUATION_HANDLER(c, &CacheVC::openReadStartHead);
+    c->vio.op    = VIO::READ;
+    c->base_stat = cache_lookup_active_stat;
+    CACHE_INCREMENT_DYN_STAT(c->base_stat + CACHE_STAT_ACTIVE);
+    c->first_key = c->key = *key;
+    c->frag_type          = type;
+    c->f.lookup           = 1;
+    c->vol                = vol;
+    c->last_collision     = nullptr;
 
-  if (c->handleEvent(EVENT_INTERVAL, nullptr) == EVENT_CONT) {
-    return &c->_action;
-  } else {
-    return ACTION_RESULT_DONE;
+    if (!lock.is_locked()) {
+      CONT_SCHED_LOCK_RETRY(c);
+      return &c->_action;
+    }
+    if (c->handleEvent(EVENT_INTERVAL, nullptr) == EVENT_CONT) {
+      return &c->_action;
+    } else {
+      return ACTION_RESULT_DONE;
+    }
   }
 }
 
@@ -2320,6 +2442,7 @@ CacheVC::removeEvent(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
   {
     MUTEX_TRY_LOCK(lock, vol->mutex, mutex->thread_holding);
     if (!lock.is_locked()) {
+      CACHE_STRIPE_INCREMENT_DYN_STAT(vol, cache_stripe_lock_contention_stat);
       VC_SCHED_LOCK_RETRY();
     }
     if (_action.cancelled) {
@@ -3012,6 +3135,15 @@ register_cache_stats(RecRawStatBlock *rsb, const char *prefix)
   REG_INT("ram_cache.bytes_used", cache_ram_cache_bytes_stat);
   REG_INT("ram_cache.hits", cache_ram_cache_hits_stat);
   REG_INT("ram_cache.misses", cache_ram_cache_misses_stat);
+  REG_INT("ram_cache.admission_rejects", cache_ram_cache_admission_rejects_stat);
+  REG_INT("ram_cache.compress.fastlz.bytes_saved", cache_ram_cache_fastlz_bytes_saved_stat);
+  REG_INT("ram_cache.compress.fastlz.time", cache_ram_cache_fastlz_time_stat);
+  REG_INT("ram_cache.compress.libz.bytes_saved", cache_ram_cache_libz_bytes_saved_stat);
+  REG_INT("ram_cache.compress.libz.time", cache_ram_cache_libz_time_stat);
+  REG_INT("ram_cache.compress.liblzma.bytes_saved", cache_ram_cache_liblzma_bytes_saved_stat);
+  REG_INT("ram_cache.compress.liblzma.time", cache_ram_cache_liblzma_time_stat);
+  REG_INT("ram_cache.compress.zstd.bytes_saved", cache_ram_cache_zstd_bytes_saved_stat);
+  REG_INT("ram_cache.compress.zstd.time", cache_ram_cache_zstd_time_stat);
   REG_INT("pread_count", cache_pread_count_stat);
   REG_INT("percent_full", cache_percent_full_stat);
   REG_INT("lookup.active", cache_lookup_active_stat);
@@ -3055,6 +3187,7 @@ register_cache_stats(RecRawStatBlock *rsb, const char *prefix)
   REG_INT("wrap_count", cache_directory_wrap_stat);
   REG_INT("sync.count", cache_directory_sync_count_stat);
   REG_INT("sync.bytes", cache_directory_sync_bytes_stat);
+  REG_INT("sync.skipped_bytes", cache_directory_sync_skipped_bytes_stat);
   REG_INT("sync.time", cache_directory_sync_time_stat);
   REG_INT("span.errors.read", cache_span_errors_read_stat);
   REG_INT("span.errors.write", cache_span_errors_write_stat);
@@ -3063,6 +3196,23 @@ register_cache_stats(RecRawStatBlock *rsb, const char *prefix)
   REG_INT("span.online", cache_span_online_stat);
 }
 
+// Stripes are numbered in the order Cache::open creates them for the volume, which is stable for a given storage layout.
+void
+register_stripe_stats(Vol *vol, int volume, int stripe)
+{
+  char prefix[256];
+  snprintf(prefix, sizeof(prefix), "proxy.process.cache.volume_%d.stripe_%d", volume, stripe);
+
+  RecRawStatBlock *rsb = vol->stripe_rsb = RecAllocateRawStatBlock(static_cast<int>(cache_stripe_stat_count));
+  REG_INT("lock_contention", cache_stripe_lock_contention_stat);
+  REG_INT("unlocked_miss", cache_stripe_unlocked_miss_stat);
+  REG_INT("unlocked_ram_hits", cache_stripe_unlocked_ram_hit_stat);
+  REG_INT("dir_sync.bytes", cache_stripe_dir_sync_bytes_stat);
+  REG_INT("dir_sync.time", cache_stripe_dir_sync_time_stat);
+  REG_INT("init.progress", cache_stripe_init_progress_stat);
+  REG_INT("init.time", cache_stripe_init_time_stat);
+}
+
 int
 FragmentSizeUpdateCb(const char * /* name ATS_UNUSED */, RecDataT /* data_type ATS_UNUSED */, RecData data, void *cookie)
 {
@@ -3090,6 +3240,8 @@ ink_cache_init(ts::ModuleVersion v)
   REC_EstablishStaticConfigInt32(cache_config_ram_cache_compress, "proxy.config.cache.ram_cache.compress");
   REC_EstablishStaticConfigInt32(cache_config_ram_cache_compress_percent, "proxy.config.cache.ram_cache.compress_percent");
   REC_ReadConfigInt32(cache_config_ram_cache_use_seen_filter, "proxy.config.cache.ram_cache.use_seen_filter");
+  REC_EstablishStaticConfigInt32(cache_config_ram_cache_shards, "proxy.config.cache.ram_cache.shards");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.ram_cache.shards = %d", cache_config_ram_cache_shards);
 
   REC_EstablishStaticConfigInt32(cache_config_http_max_alts, "proxy.config.cache.limits.http.max_alts");
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.limits.http.max_alts = %d", cache_config_http_max_alts);
@@ -3148,6 +3300,15 @@ ink_cache_init(ts::ModuleVersion v)
   REC_EstablishStaticConfigInt32(cache_config_enable_checksum, "proxy.config.cache.enable_checksum");
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.enable_checksum = %d", cache_config_enable_checksum);
 
+  REC_EstablishStaticConfigInt32(cache_config_dir_probe_filter, "proxy.config.cache.dir.probe_filter");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.dir.probe_filter = %d", cache_config_dir_probe_filter);
+
+  REC_EstablishStaticConfigInt32(cache_config_dir_optimistic_probe, "proxy.config.cache.dir.optimistic_probe");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.dir.optimistic_probe = %d", cache_config_dir_optimistic_probe);
+
+  REC_EstablishStaticConfigInt32(cache_config_dir_read_concurrency, "proxy.config.cache.dir.read_concurrency");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.dir.read_concurrency = %d", cache_config_dir_read_concurrency);
+
   REC_EstablishStaticConfigInt32(cache_config_alt_rewrite_max_size, "proxy.config.cache.alt_rewrite_max_size");
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.alt_rewrite_max_size = %d", cache_config_alt_rewrite_max_size);
 
@@ -57,6 +57,7 @@ namespace
 DbgCtl dbg_ctl_cache_dir_sync{"dir_sync"};
 DbgCtl dbg_ctl_cache_check_dir{"cache_check_dir"};
 DbgCtl dbg_ctl_dir_clean{"dir_clean"};
+DbgCtl dbg_ctl_cache_init{"cache_init"};
 
 #ifdef DEBUG
 
@@ -123,6 +124,7 @@ OpenDir::open_write(CacheVC *cont, int allow_if_writers, int max_writers)
   cont->od           = od;
   cont->write_vector = &od->vector;
   bucket[b].push(od);
+  bucket_entries[b].fetch_add(1, std::memory_order_release);
   return 1;
 }
 
@@ -162,6 +164,7 @@ OpenDir::close_write(CacheVC *cont)
     unsigned int h = cont->first_key.slice32(0);
     int b          = h % OPEN_DIR_BUCKETS;
     bucket[b].remove(cont->od);
+    bucket_entries[b].fetch_sub(1, std::memory_order_release);
     delayed_readers.append(cont->od->readers);
     signal_readers(0, nullptr);
     cont->od->vector.clear();
@@ -184,6 +187,13 @@ OpenDir::open_read(const CryptoHash *key) const
   return nullptr;
 }
 
+// Unlike open_read this does not need the stripe lock, and only tells whether a writer for the key might exist.
+bool
+OpenDir::may_have_writer(const CryptoHash *key) const
+{
+  return bucket_entries[key->slice32(0) % OPEN_DIR_BUCKETS].load(std::memory_order_acquire) != 0;
+}
+
 int
 OpenDirEntry::wait(CacheVC *cont, int msec)
 {
@@ -199,6 +209,55 @@ OpenDirEntry::wait(CacheVC *cont, int msec)
 // Cache Directory
 //
 
+namespace
+{
+
+/* Directory segments are only modified with the stripe lock held. When optimistic probes are
+   enabled each segment also has a sequence number which is odd while the segment is being
+   modified, so dir_absent_unlocked() can detect that it raced with a writer. A writer that
+   finds the segment already odd is nested inside another writer on the same segment and
+   leaves the sequence number alone. */
+class DirSegmentWriteGuard
+{
+public:
+  DirSegmentWriteGuard(Vol *vol, int s)
+  {
+    if (vol->dir_dirty) {
+      vol->dir_dirty[s] = DIR_SYNC_ALL_COPIES;
+    }
+    if (vol->dir_seq && !(vol->dir_seq[s].load(std::memory_order_relaxed) & 1)) {
+      _seq = &vol->dir_seq[s];
+      _seq->store(_seq->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+  }
+
+  ~DirSegmentWriteGuard()
+  {
+    if (_seq) {
+      _seq->store(_seq->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+  }
+
+private:
+  std::atomic<uint32_t> *_seq = nullptr;
+};
+
+// Longest bucket chain dir_absent_unlocked() will walk, the same limit dir_bucket_length() uses.
+constexpr int DIR_UNLOCKED_MAX_CHAIN = 100;
+
+// Copy a directory entry that a writer may be modifying. Each word is loaded atomically so the copy is
+// not a data race, whether the words are consistent with each other is left to the sequence check.
+inline void
+dir_load_relaxed(Dir *to, const Dir *from)
+{
+  for (size_t i = 0; i < countof(from->w); i++) {
+    to->w[i] = __atomic_load_n(&from->w[i], __ATOMIC_RELAXED);
+  }
+}
+
+} // end anonymous namespace
+
 // return value 1 means no loop
 // zero indicates loop
 int
@@ -235,6 +294,7 @@ dir_bucket_loop_check(Dir *start_dir, Dir *seg)
 void
 dir_init_segment(int s, Vol *vol)
 {
+  DirSegmentWriteGuard guard(vol, s);
   vol->header->freelist[s] = 0;
   Dir *seg                 = vol->dir_segment(s);
   int l, b;
@@ -400,6 +460,7 @@ dir_clean_bucket(Dir *b, int s, Vol *vol)
 void
 dir_clean_segment(int s, Vol *vol)
 {
+  DirSegmentWriteGuard guard(vol, s);
   Dir *seg = vol->dir_segment(s);
   for (int64_t i = 0; i < vol->buckets; i++) {
     dir_clean_bucket(dir_bucket(i, seg), s, vol);
@@ -422,6 +483,7 @@ dir_clear_range(off_t start, off_t end, Vol *vol)
   for (off_t i = 0; i < vol->buckets * DIR_DEPTH * vol->segments; i++) {
     Dir *e = dir_index(vol, i);
     if (dir_offset(e) >= static_cast<int64_t>(start) && dir_offset(e) < static_cast<int64_t>(end)) {
+      DirSegmentWriteGuard guard(vol, i / (vol->buckets * DIR_DEPTH));
       CACHE_DEC_DIR_USED(vol->mutex);
       dir_set_offset(e, 0); // delete
     }
@@ -553,6 +615,44 @@ dir_free_entry(Dir *e, int s, Vol *vol)
   vol->header->freelist[s] = eo;
 }
 
+static inline std::atomic<uint32_t> *
+dir_tag_filter(Vol *vol, int s, int b)
+{
+  return vol->tag_filter ? &vol->tag_filter[static_cast<int64_t>(s) * vol->buckets + b] : nullptr;
+}
+
+// Writers hold the stripe lock, the release store is for dir_scan_unlocked().
+static inline void
+dir_tag_filter_add(std::atomic<uint32_t> *filter, unsigned int tag)
+{
+  filter->store(filter->load(std::memory_order_relaxed) | dir_tag_filter_bit(tag), std::memory_order_release);
+}
+
+/* Rebuild the per bucket tag summaries from the directory. Called once the
+   directory has been read or recovered, before the stripe takes traffic. */
+void
+dir_build_tag_filter(Vol *vol)
+{
+  if (!vol->tag_filter) {
+    vol->tag_filter = new std::atomic<uint32_t>[static_cast<int64_t>(vol->segments) * vol->buckets];
+  }
+  for (int s = 0; s < vol->segments; s++) {
+    Dir *seg = vol->dir_segment(s);
+    for (int b = 0; b < vol->buckets; b++) {
+      uint32_t bits = 0;
+      int l         = 0;
+      for (Dir *e = dir_bucket(b, seg); e && l <= vol->buckets * DIR_DEPTH; e = next_dir(e, seg), l++) {
+        if (dir_offset(e)) {
+          bits |= dir_tag_filter_bit(dir_tag(e));
+        }
+      }
+      vol->tag_filter[static_cast<int64_t>(s) * vol->buckets + b].store(bits, std::memory_order_relaxed);
+    }
+  }
+  Dbg(dbg_ctl_cache_init, "built directory tag filter for vol %d: %d segments, %" PRId64 " buckets", vol->fd, vol->segments,
+      static_cast<int64_t>(vol->buckets));
+}
+
 int
 dir_probe(const CacheKey *key, Vol *vol, Dir *result, Dir **last_collision)
 {
@@ -566,6 +666,13 @@ dir_probe(const CacheKey *key, Vol *vol, Dir *result, Dir **last_collision)
   if (dir_bucket_loop_fix(dir_bucket(b, seg), s, vol))
     return 0;
 #endif
+  // No entry in this bucket can carry the key's tag, and with no collision to resume from there is
+  // nothing to walk.
+  if (std::atomic<uint32_t> *filter = dir_tag_filter(vol, s, b);
+      filter && !collision && !(filter->load(std::memory_order_relaxed) & dir_tag_filter_bit(DIR_MASK_TAG(key->slice32(2))))) {
+    DDbg(dbg_ctl_dir_probe_miss, "filtered %X %X on vol %d bucket %d at %p", key->slice32(0), key->slice32(1), vol->fd, b, seg);
+    return 0;
+  }
 Lagain:
   e = dir_bucket(b, seg);
   if (dir_offset(e)) {
@@ -596,6 +703,7 @@ Lagain:
           ink_assert(dir_offset(e) * CACHE_BLOCK_SIZE < vol->len);
           return 1;
         } else { // delete the invalid entry
+          DirSegmentWriteGuard guard(vol, s);
           CACHE_DEC_DIR_USED(vol->mutex);
           e = dir_delete_entry(e, p, s, vol);
           continue;
@@ -619,6 +727,83 @@ Lagain:
   return 0;
 }
 
+void
+dir_init_optimistic_probe(Vol *vol)
+{
+  if (!vol->dir_seq) {
+    vol->dir_seq = new std::atomic<uint32_t>[vol->segments]();
+  }
+}
+
+/* Walk the key's bucket without taking the stripe lock. Returns 1 and copies the first entry with
+   a matching tag to @a result, 0 if there is no such entry, or -1 if a writer was modifying the
+   segment during the walk, in which case nothing read can be trusted. */
+static int
+dir_scan_unlocked(const CacheKey *key, Vol *vol, Dir *result)
+{
+  int s          = key->slice32(0) % vol->segments;
+  int b          = key->slice32(1) % vol->buckets;
+  Dir *seg       = vol->dir_segment(s);
+  unsigned int t = DIR_MASK_TAG(key->slice32(2));
+  int found      = 0;
+
+  uint32_t seq = vol->dir_seq[s].load(std::memory_order_acquire);
+  if (seq & 1) {
+    return -1;
+  }
+  std::atomic<uint32_t> *filter = dir_tag_filter(vol, s, b);
+  if (!filter || (filter->load(std::memory_order_acquire) & dir_tag_filter_bit(t))) {
+    Dir *e = dir_bucket(b, seg);
+    Dir d;
+    dir_load_relaxed(&d, e);
+    if (dir_offset(&d)) {
+      // A walk racing a writer can follow a half updated chain, bound it and let the sequence check reject it.
+      for (int l = 0; e && !found && l < DIR_UNLOCKED_MAX_CHAIN; l++) {
+        if (dir_offset(&d) && dir_tag(&d) == t) {
+          dir_assign(result, &d);
+          found = 1;
+        }
+        if ((e = next_dir(&d, seg))) {
+          dir_load_relaxed(&d, e);
+        }
+      }
+      if (!found && e) { // gave up on an overlong chain
+        return -1;
+      }
+    }
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (vol->dir_seq[s].load(std::memory_order_relaxed) != seq) {
+    return -1;
+  }
+  return found;
+}
+
+/* Check whether the key is absent from the directory without taking the stripe lock. Returns true
+   only if the key's bucket had no entry with a matching tag, no writer was modifying the segment
+   during the walk, and the key has no open writer; anything else needs the locked dir_probe. */
+bool
+dir_absent_unlocked(const CacheKey *key, Vol *vol)
+{
+  Dir e;
+  if (!vol->dir_seq || dir_scan_unlocked(key, vol, &e) != 0) {
+    return false;
+  }
+  return !vol->open_dir.may_have_writer(key);
+}
+
+/* Find a directory entry for the key without taking the stripe lock. Returns 1 with a copy of the
+   first entry with a matching tag, which may be a collision or already stale, so the caller must
+   verify whatever it reads through it. */
+int
+dir_probe_unlocked(const CacheKey *key, Vol *vol, Dir *result)
+{
+  if (!vol->dir_seq) {
+    return 0;
+  }
+  return dir_scan_unlocked(key, vol, result) > 0;
+}
+
 int
 dir_insert(const CacheKey *key, Vol *vol, Dir *to_part)
 {
@@ -626,6 +811,7 @@ dir_insert(const CacheKey *key, Vol *vol, Dir *to_part)
   int s  = key->slice32(0) % vol->segments, l;
   int bi = key->slice32(1) % vol->buckets;
   ink_assert(dir_approx_size(to_part) <= MAX_FRAG_SIZE + sizeof(Doc));
+  DirSegmentWriteGuard guard(vol, s);
   Dir *seg = vol->dir_segment(s);
   Dir *e   = nullptr;
   Dir *b   = dir_bucket(bi, seg);
@@ -676,6 +862,9 @@ Llink:
 Lfill:
   dir_assign_data(e, to_part);
   dir_set_tag(e, key->slice32(2));
+  if (std::atomic<uint32_t> *filter = dir_tag_filter(vol, s, bi); filter) {
+    dir_tag_filter_add(filter, dir_tag(e));
+  }
   ink_assert(vol->vol_offset(e) < (vol->skip + vol->len));
   DDbg(dbg_ctl_dir_insert, "insert %p %X into vol %d bucket %d at %p tag %X %X boffset %" PRId64 "", e, key->slice32(0), vol->fd,
        bi, e, key->slice32(1), dir_tag(e), dir_offset(e));
@@ -696,6 +885,7 @@ dir_overwrite(const CacheKey *key, Vol *vol, Dir *dir, Dir *overwrite, bool must
   Dir *b         = dir_bucket(bi, seg);
   unsigned int t = DIR_MASK_TAG(key->slice32(2));
   int res        = 1;
+  DirSegmentWriteGuard guard(vol, s);
 #ifdef LOOP_CHECK_MODE
   int loop_count     = 0;
   bool loop_possible = true;
@@ -762,6 +952,9 @@ Llink:
 Lfill:
   dir_assign_data(e, dir);
   dir_set_tag(e, t);
+  if (std::atomic<uint32_t> *filter = dir_tag_filter(vol, s, bi); filter) {
+    dir_tag_filter_add(filter, t);
+  }
   ink_assert(vol->vol_offset(e) < vol->skip + vol->len);
   DDbg(dbg_ctl_dir_overwrite, "overwrite %p %X into vol %d bucket %d at %p tag %X %X boffset %" PRId64 "", e, key->slice32(0),
        vol->fd, bi, e, t, dir_tag(e), dir_offset(e));
@@ -778,6 +971,7 @@ dir_delete(const CacheKey *key, Vol *vol, Dir *del)
   int b    = key->slice32(1) % vol->buckets;
   Dir *seg = vol->dir_segment(s);
   Dir *e = nullptr, *p = nullptr;
+  DirSegmentWriteGuard guard(vol, s);
 #ifdef LOOP_CHECK_MODE
   int loop_count = 0;
 #endif
@@ -923,8 +1117,58 @@ dir_lookaside_remove(const CacheKey *key, Vol *vol)
 void
 dir_sync_init()
 {
-  cacheDirSync          = new CacheSync;
-  cacheDirSync->trigger = eventProcessor.schedule_in(cacheDirSync, HRTIME_SECONDS(cache_config_dir_sync_frequency));
+  // One sync per disk, so the directories on different disks are written in parallel.
+  for (int i = 0; i < gnvol; i++) {
+    Vol *vol = gvol[i];
+    for (int j = 0; j < i && !vol->dir_sync; j++) {
+      if (gvol[j]->disk == vol->disk) {
+        vol->dir_sync = gvol[j]->dir_sync;
+      }
+    }
+    if (!vol->dir_sync) {
+      vol->dir_sync          = new CacheSync;
+      vol->dir_sync->trigger = eventProcessor.schedule_in(vol->dir_sync, HRTIME_SECONDS(cache_config_dir_sync_frequency));
+    }
+  }
+}
+
+/* Find the next part of the directory body at or after @a pos to write. The freelist is always
+   written, directory segments only if they are in @a segs. Returns false if nothing is left,
+   otherwise sets @a pos and @a len to a store block aligned range of about SYNC_MAX_WRITE bytes
+   at most. */
+static bool
+dir_sync_next_range(Vol *vol, const std::vector<bool> &segs, off_t *pos, int *len)
+{
+  off_t body_start = ROUND_TO_STORE_BLOCK(sizeof(VolHeaderFooter));
+  off_t body_end   = vol->dirlen() - body_start;
+  off_t dir_start  = vol->headerlen();
+  off_t seg_len    = vol->buckets * DIR_DEPTH * SIZEOF_DIR;
+  off_t p          = std::max(*pos, body_start);
+  off_t end        = 0;
+
+  if (p >= body_end) {
+    return false;
+  }
+  if (p < dir_start) { // freelist
+    end = dir_start;
+  } else {
+    int s = (p - dir_start) / seg_len;
+    while (s < vol->segments && !segs[s]) {
+      s++;
+    }
+    if (s >= vol->segments) {
+      return false;
+    }
+    p     = std::max(p, (dir_start + s * seg_len) & ~static_cast<off_t>(STORE_BLOCK_SIZE - 1));
+    int e = s + 1;
+    while (e < vol->segments && segs[e] && dir_start + (e + 1) * seg_len - p <= SYNC_MAX_WRITE) {
+      e++;
+    }
+    end = dir_start + e * seg_len;
+  }
+  *pos = p;
+  *len = std::min(ROUND_TO_STORE_BLOCK(end), body_end) - p;
+  return true;
 }
 
 void
@@ -1078,6 +1322,9 @@ CacheSync::mainEvent(int event, Event *e)
   }
 
 Lrestart:
+  while (vol_idx < gnvol && gvol[vol_idx]->dir_sync != this) {
+    ++vol_idx;
+  }
   if (vol_idx >= gnvol) {
     vol_idx = 0;
     if (buf) {
@@ -1105,10 +1352,14 @@ Lrestart:
     // AIO Thread
     if (io.aio_result != static_cast<int64_t>(io.aiocb.aio_nbytes)) {
       Warning("vol write error during directory sync '%s'", gvol[vol_idx]->hash_text.get());
+      // The copy on disk is now unknown, write all of it next time.
+      memset(vol->dir_dirty, DIR_SYNC_ALL_COPIES, vol->segments);
       event = EVENT_NONE;
       goto Ldone;
     }
     CACHE_SUM_DYN_STAT(cache_directory_sync_bytes_stat, io.aio_result);
+    CACHE_STRIPE_SUM_DYN_STAT(vol, cache_stripe_dir_sync_bytes_stat, io.aio_result);
+    sync_bytes += io.aio_result;
 
     trigger = eventProcessor.schedule_in(this, SYNC_DELAY);
     return EVENT_CONT;
@@ -1178,32 +1429,43 @@ Lrestart:
       vol->footer->sync_serial = vol->header->sync_serial;
       CHECK_DIR(d);
       memcpy(buf, vol->raw_dir, dirlen);
+      // Take the segments the copy being overwritten is missing, later changes mark them again.
+      uint8_t copy = SYNC_COPY(vol->header->sync_serial);
+      segs.assign(vol->segments, false);
+      for (int s = 0; s < vol->segments; s++) {
+        if (vol->dir_dirty[s] & copy) {
+          segs[s]             = true;
+          vol->dir_dirty[s] &= ~copy;
+        }
+      }
+      sync_bytes                = 0;
       vol->dir_sync_in_progress = true;
     }
     size_t B    = vol->header->sync_serial & 1;
     off_t start = vol->skip + (B ? dirlen : 0);
+    int l       = 0;
 
     if (!writepos) {
       // write header
       aio_write(vol->fd, buf + writepos, headerlen, start + writepos);
       writepos += headerlen;
-    } else if (writepos < static_cast<off_t>(dirlen) - headerlen) {
-      // write part of body
-      int l = SYNC_MAX_WRITE;
-      if (writepos + l > static_cast<off_t>(dirlen) - headerlen) {
-        l = dirlen - headerlen - writepos;
-      }
+    } else if (writepos < static_cast<off_t>(dirlen) - headerlen && dir_sync_next_range(vol, segs, &writepos, &l)) {
+      // write the next changed part of body
       aio_write(vol->fd, buf + writepos, l, start + writepos);
       writepos += l;
     } else if (writepos < static_cast<off_t>(dirlen)) {
-      ink_assert(writepos == (off_t)dirlen - headerlen);
       // write footer
+      writepos = dirlen - headerlen;
       aio_write(vol->fd, buf + writepos, headerlen, start + writepos);
       writepos += headerlen;
     } else {
+      ink_hrtime elapsed        = ink_get_hrtime() - start_time;
       vol->dir_sync_in_progress = false;
       CACHE_INCREMENT_DYN_STAT(cache_directory_sync_count_stat);
-      CACHE_SUM_DYN_STAT(cache_directory_sync_time_stat, ink_get_hrtime() - start_time);
+      CACHE_SUM_DYN_STAT(cache_directory_sync_time_stat, elapsed);
+      CACHE_SUM_DYN_STAT(cache_directory_sync_skipped_bytes_stat, dirlen - sync_bytes);
+      CACHE_STRIPE_SUM_DYN_STAT(vol, cache_stripe_dir_sync_time_stat, elapsed);
+      Dbg(dbg_ctl_cache_dir_sync, "Dir %s: wrote %" PRId64 " of %zu bytes", vol->hash_text.get(), sync_bytes, dirlen);
       start_time = 0;
       goto Ldone;
     }
@@ -56,6 +56,14 @@ Cache::open_read(Continuation *cont, const CacheKey *key, CacheFragType type, co
   CacheVC *c        = nullptr;
   {
     CACHE_TRY_LOCK(lock, vol->mutex, mutex->thread_holding);
+    if (!lock.is_locked()) {
+      CACHE_STRIPE_INCREMENT_DYN_STAT(vol, cache_stripe_lock_contention_stat);
+      // A definite miss can be answered without waiting for the stripe lock.
+      if (dir_absent_unlocked(key, vol)) {
+        CACHE_STRIPE_INCREMENT_DYN_STAT(vol, cache_stripe_unlocked_miss_stat);
+        goto Lmiss;
+      }
+    }
     if (!lock.is_locked() || (od = vol->open_read(key)) || dir_probe(key, vol, &result, &last_collision)) {
       c = new_CacheVC(cont);
       SET_CONTINUATION_HANDLER(c, &CacheVC::openReadStartHead);
@@ -123,6 +131,14 @@ Cache::open_read(Continuation *cont, const CacheKey *key, CacheHTTPHdr *request,
 
   {
     CACHE_TRY_LOCK(lock, vol->mutex, mutex->thread_holding);
+    if (!lock.is_locked()) {
+      CACHE_STRIPE_INCREMENT_DYN_STAT(vol, cache_stripe_lock_contention_stat);
+      // A definite miss can be answered without waiting for the stripe lock.
+      if (dir_absent_unlocked(key, vol)) {
+        CACHE_STRIPE_INCREMENT_DYN_STAT(vol, cache_stripe_unlocked_miss_stat);
+        goto Lmiss;
+      }
+    }
     if (!lock.is_locked() || (od = vol->open_read(key)) || dir_probe(key, vol, &result, &last_collision)) {
       c            = new_CacheVC(cont);
       c->first_key = c->key = c->earliest_key = *key;
@@ -659,6 +675,7 @@ int
 CacheVC::openReadMain(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
 {
   cancel_trigger();
+Lnext:
   Doc *doc         = reinterpret_cast<Doc *>(buf->data());
   int64_t ntodo    = vio.ntodo();
   int64_t bytes    = doc->len - doc_pos;
@@ -820,6 +837,31 @@ Lread : {
   // EVENT_IMMEDIATE events. So, we have to cancel that trigger and set
   // a new EVENT_INTERVAL event.
   cancel_trigger();
+  // A thread safe RAM cache can serve the next fragment without the stripe lock. The directory
+  // entry may be stale or a collision, so only a fragment whose own key matches is accepted. A
+  // compressed hit has already been decompressed by the RAM cache, so it is used as well.
+  if (vol->ram_cache->thread_safe()) {
+    Dir ram_dir;
+    Ptr<IOBufferData> ram_buf;
+    int ram_hit_state = 0;
+    if (dir_probe_unlocked(&key, vol, &ram_dir) &&
+        (ram_hit_state = vol->ram_cache->get(&key, &ram_buf, static_cast<uint64_t>(dir_offset(&ram_dir)))) >=
+          RAM_HIT_COMPRESS_NONE) {
+      Doc *ram_doc = reinterpret_cast<Doc *>(ram_buf->data());
+      if (ram_doc->magic == DOC_MAGIC && ram_doc->key == key && !ram_doc->hlen) {
+        CACHE_STRIPE_INCREMENT_DYN_STAT(vol, cache_stripe_unlocked_ram_hit_stat);
+        buf = std::move(ram_buf);
+        dir_assign(&dir, &ram_dir);
+        f.doc_from_ram_cache = true;
+        f.compressed_in_ram  = ram_hit_state > RAM_HIT_COMPRESS_NONE;
+        fragment++;
+        doc_pos = ram_doc->prefix_len();
+        next_CacheKey(&key, &key);
+        SET_HANDLER(&CacheVC::openReadMain);
+        goto Lnext;
+      }
+    }
+  }
   CACHE_TRY_LOCK(lock, vol->mutex, mutex->thread_holding);
   if (!lock.is_locked()) {
     SET_HANDLER(&CacheVC::openReadMain);
@@ -882,6 +924,7 @@ CacheVC::openReadStartEarliest(int /* event ATS_UNUSED */, Event * /* e ATS_UNUS
   {
     CACHE_TRY_LOCK(lock, vol->mutex, mutex->thread_holding);
     if (!lock.is_locked()) {
+      CACHE_STRIPE_INCREMENT_DYN_STAT(vol, cache_stripe_lock_contention_stat);
       VC_SCHED_LOCK_RETRY();
     }
     if (!buf) {
@@ -1086,6 +1129,7 @@ CacheVC::openReadStartHead(int event, Event *e)
   {
     CACHE_TRY_LOCK(lock, vol->mutex, mutex->thread_holding);
     if (!lock.is_locked()) {
+      CACHE_STRIPE_INCREMENT_DYN_STAT(vol, cache_stripe_lock_contention_stat);
       VC_SCHED_LOCK_RETRY();
     }
     if (!buf) {
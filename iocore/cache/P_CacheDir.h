@@ -28,6 +28,8 @@
 #include "I_EventSystem.h"
 #include "I_Continuation.h"
 
+#include <vector>
+
 struct Vol;
 struct InterimCacheVol;
 struct CacheVC;
@@ -55,9 +57,11 @@ struct CacheVC;
 #define DIR_OFFSET_BITS         40
 #define DIR_OFFSET_MAX          ((((off_t)1) << DIR_OFFSET_BITS) - 1)
 
-#define SYNC_MAX_WRITE     (2 * 1024 * 1024)
-#define SYNC_DELAY         HRTIME_MSECONDS(500)
-#define DO_NOT_REMOVE_THIS 0
+#define SYNC_MAX_WRITE      (2 * 1024 * 1024)
+#define SYNC_DELAY          HRTIME_MSECONDS(500)
+#define SYNC_COPY(_serial)  (1 << ((_serial)&1)) // Vol::dir_dirty bit of the directory copy a sync serial writes
+#define DIR_SYNC_ALL_COPIES 3
+#define DO_NOT_REMOVE_THIS  0
 
 // Debugging Options
 
@@ -73,13 +77,16 @@ struct CacheVC;
 #endif
 
 #define dir_index(_e, _i) ((Dir *)((char *)(_e)->dir + (SIZEOF_DIR * (_i))))
-#define dir_assign(_e, _x)   \
-  do {                       \
-    (_e)->w[0] = (_x)->w[0]; \
-    (_e)->w[1] = (_x)->w[1]; \
-    (_e)->w[2] = (_x)->w[2]; \
-    (_e)->w[3] = (_x)->w[3]; \
-    (_e)->w[4] = (_x)->w[4]; \
+// Directory words are written under the stripe lock but read without it by dir_probe_unlocked(),
+// so they are stored atomically. The segment sequence numbers order them, relaxed is enough.
+#define dir_set_word(_e, _i, _v) __atomic_store_n(&(_e)->w[_i], (uint16_t)(_v), __ATOMIC_RELAXED)
+#define dir_assign(_e, _x)           \
+  do {                               \
+    dir_set_word(_e, 0, (_x)->w[0]); \
+    dir_set_word(_e, 1, (_x)->w[1]); \
+    dir_set_word(_e, 2, (_x)->w[2]); \
+    dir_set_word(_e, 3, (_x)->w[3]); \
+    dir_set_word(_e, 4, (_x)->w[4]); \
   } while (0)
 #define dir_assign_data(_e, _x)         \
   do {                                  \
@@ -96,13 +103,13 @@ struct CacheVC;
   (_d->header->phase == dir_phase(_e) ? vol_in_phase_valid(_d, _e) : vol_out_of_phase_write_valid(_d, _e))
 #define dir_agg_buf_valid(_d, _e) (_d->header->phase == dir_phase(_e) && _d->vol_in_phase_agg_buf_valid(_e))
 #define dir_is_empty(_e)          (!dir_offset(_e))
-#define dir_clear(_e) \
-  do {                \
-    (_e)->w[0] = 0;   \
-    (_e)->w[1] = 0;   \
-    (_e)->w[2] = 0;   \
-    (_e)->w[3] = 0;   \
-    (_e)->w[4] = 0;   \
+#define dir_clear(_e)       \
+  do {                      \
+    dir_set_word(_e, 0, 0); \
+    dir_set_word(_e, 1, 0); \
+    dir_set_word(_e, 2, 0); \
+    dir_set_word(_e, 3, 0); \
+    dir_set_word(_e, 4, 0); \
   } while (0)
 #define dir_clean(_e) dir_set_offset(_e, 0)
 
@@ -144,18 +151,18 @@ struct Dir {
 
 #define dir_offset(_e) \
   ((int64_t)(((uint64_t)(_e)->w[0]) | (((uint64_t)((_e)->w[1] & 0xFF)) << 16) | (((uint64_t)(_e)->w[4]) << 24)))
-#define dir_set_offset(_e, _o)                                              \
-  do {                                                                      \
-    (_e)->w[0] = (uint16_t)_o;                                              \
-    (_e)->w[1] = (uint16_t)((((_o) >> 16) & 0xFF) | ((_e)->w[1] & 0xFF00)); \
-    (_e)->w[4] = (uint16_t)((_o) >> 24);                                    \
+#define dir_set_offset(_e, _o)                                                      \
+  do {                                                                              \
+    dir_set_word(_e, 0, (uint16_t)_o);                                              \
+    dir_set_word(_e, 1, (uint16_t)((((_o) >> 16) & 0xFF) | ((_e)->w[1] & 0xFF00))); \
+    dir_set_word(_e, 4, (uint16_t)((_o) >> 24));                                    \
   } while (0)
 #define dir_bit(_e, _w, _b)         ((uint32_t)(((_e)->w[_w] >> (_b)) & 1))
-#define dir_set_bit(_e, _w, _b, _v) (_e)->w[_w] = (uint16_t)(((_e)->w[_w] & ~(1 << (_b))) | (((_v) ? 1 : 0) << (_b)))
+#define dir_set_bit(_e, _w, _b, _v) dir_set_word(_e, _w, (uint16_t)(((_e)->w[_w] & ~(1 << (_b))) | (((_v) ? 1 : 0) << (_b))))
 #define dir_big(_e)                 ((uint32_t)((((_e)->w[1]) >> 8) & 0x3))
-#define dir_set_big(_e, _v)         (_e)->w[1] = (uint16_t)(((_e)->w[1] & 0xFCFF) | (((uint16_t)(_v)) & 0x3) << 8)
+#define dir_set_big(_e, _v)         dir_set_word(_e, 1, (uint16_t)(((_e)->w[1] & 0xFCFF) | (((uint16_t)(_v)) & 0x3) << 8))
 #define dir_size(_e)                ((uint32_t)(((_e)->w[1]) >> 10))
-#define dir_set_size(_e, _v)        (_e)->w[1] = (uint16_t)(((_e)->w[1] & ((1 << 10) - 1)) | ((_v) << 10))
+#define dir_set_size(_e, _v)        dir_set_word(_e, 1, (uint16_t)(((_e)->w[1] & ((1 << 10) - 1)) | ((_v) << 10)))
 #define dir_set_approx_size(_e, _s)                   \
   do {                                                \
     if ((_s) <= DIR_SIZE_WITH_BLOCK(0)) {             \
@@ -181,7 +188,7 @@ struct Dir {
         (_s <= DIR_SIZE_WITH_BLOCK(2) ? ROUND_TO(_s, DIR_BLOCK_SIZE(2)) : ROUND_TO(_s, DIR_BLOCK_SIZE(3)))))
 #define dir_tag(_e) ((uint32_t)((_e)->w[2] & ((1 << DIR_TAG_WIDTH) - 1)))
 #define dir_set_tag(_e, _t) \
-  (_e)->w[2] = (uint16_t)(((_e)->w[2] & ~((1 << DIR_TAG_WIDTH) - 1)) | ((_t) & ((1 << DIR_TAG_WIDTH) - 1)))
+  dir_set_word(_e, 2, (uint16_t)(((_e)->w[2] & ~((1 << DIR_TAG_WIDTH) - 1)) | ((_t) & ((1 << DIR_TAG_WIDTH) - 1))))
 #define dir_phase(_e)          dir_bit(_e, 2, 12)
 #define dir_set_phase(_e, _v)  dir_set_bit(_e, 2, 12, _v)
 #define dir_head(_e)           dir_bit(_e, 2, 13)
@@ -190,9 +197,9 @@ struct Dir {
 #define dir_set_pinned(_e, _v) dir_set_bit(_e, 2, 14, _v)
 // Bit 2:15 is unused.
 #define dir_next(_e)         (_e)->w[3]
-#define dir_set_next(_e, _o) (_e)->w[3] = (uint16_t)(_o)
+#define dir_set_next(_e, _o) dir_set_word(_e, 3, _o)
 #define dir_prev(_e)         (_e)->w[2]
-#define dir_set_prev(_e, _o) (_e)->w[2] = (uint16_t)(_o)
+#define dir_set_prev(_e, _o) dir_set_word(_e, 2, _o)
 
 // INKqa11166 - Cache can not store 2 HTTP alternates simultaneously.
 // To allow this, move the vector from the CacheVC to the OpenDirEntry.
@@ -232,15 +239,19 @@ struct OpenDirEntry {
 struct OpenDir : public Continuation {
   Queue<CacheVC, Link_CacheVC_opendir_link> delayed_readers;
   DLL<OpenDirEntry> bucket[OPEN_DIR_BUCKETS];
+  std::atomic<uint16_t> bucket_entries[OPEN_DIR_BUCKETS] = {}; // entries per bucket, readable without the stripe lock
 
   int open_write(CacheVC *c, int allow_if_writers, int max_writers);
   int close_write(CacheVC *c);
   OpenDirEntry *open_read(const CryptoHash *key) const;
+  bool may_have_writer(const CryptoHash *key) const;
   int signal_readers(int event, Event *e);
 
   OpenDir();
 };
 
+// Writes the directories of the stripes on one disk, each directory sync writes only the
+// segments changed since the copy it overwrites was last written.
 struct CacheSync : public Continuation {
   int vol_idx    = 0;
   char *buf      = nullptr;
@@ -250,6 +261,8 @@ struct CacheSync : public Continuation {
   AIOCallbackInternal io;
   Event *trigger        = nullptr;
   ink_hrtime start_time = 0;
+  std::vector<bool> segs; // segments to write in this sync, taken from Vol::dir_dirty
+  int64_t sync_bytes = 0;
   int mainEvent(int event, Event *e);
   void aio_write(int fd, char *b, int n, off_t o);
 
@@ -276,6 +289,10 @@ void dir_clear_range(off_t start, off_t end, Vol *vol);
 int dir_segment_accounted(int s, Vol *vol, int offby = 0, int *free = nullptr, int *used = nullptr, int *empty = nullptr,
                           int *valid = nullptr, int *agg_valid = nullptr, int *avg_size = nullptr);
 uint64_t dir_entries_used(Vol *vol);
+void dir_build_tag_filter(Vol *vol);
+void dir_init_optimistic_probe(Vol *vol);
+bool dir_absent_unlocked(const CacheKey *key, Vol *vol);
+int dir_probe_unlocked(const CacheKey *key, Vol *vol, Dir *result);
 void sync_cache_dir_on_shutdown();
 
 // Inline Functions
@@ -288,6 +305,15 @@ dir_compare_tag(const Dir *e, const CacheKey *key)
   return (dir_tag(e) == DIR_MASK_TAG(key->slice32(2)));
 }
 
+// The tag filter keeps a 32 bit summary per bucket with bit (tag % 32) set for every entry in the
+// bucket chain. Bits can be stale, but a tag in the chain always has its bit set, so a clear bit lets
+// dir_probe report a miss with a single load instead of walking the chain through the segment.
+inline uint32_t
+dir_tag_filter_bit(unsigned int tag)
+{
+  return 1u << (tag & 31);
+}
+
 inline Dir *
 dir_from_offset(int64_t i, Dir *seg)
 {
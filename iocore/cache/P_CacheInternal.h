@@ -107,6 +107,16 @@ enum {
   cache_direntries_used_stat,
   cache_ram_cache_hits_stat,
   cache_ram_cache_misses_stat,
+  cache_ram_cache_admission_rejects_stat,
+  // per codec RAM cache compression stats, in CACHE_COMPRESSION_* order
+  cache_ram_cache_fastlz_bytes_saved_stat,
+  cache_ram_cache_libz_bytes_saved_stat,
+  cache_ram_cache_liblzma_bytes_saved_stat,
+  cache_ram_cache_zstd_bytes_saved_stat,
+  cache_ram_cache_fastlz_time_stat,
+  cache_ram_cache_libz_time_stat,
+  cache_ram_cache_liblzma_time_stat,
+  cache_ram_cache_zstd_time_stat,
   cache_pread_count_stat,
   cache_percent_full_stat,
   cache_lookup_active_stat,
@@ -149,6 +159,7 @@ enum {
   cache_directory_sync_count_stat,
   cache_directory_sync_time_stat,
   cache_directory_sync_bytes_stat,
+  cache_directory_sync_skipped_bytes_stat,
   /* AIO read/write error counters */
   cache_span_errors_read_stat,
   cache_span_errors_write_stat,
@@ -162,6 +173,18 @@ enum {
   cache_stat_count
 };
 
+// per stripe stats, kept in Vol::stripe_rsb
+enum {
+  cache_stripe_lock_contention_stat,
+  cache_stripe_unlocked_miss_stat,
+  cache_stripe_unlocked_ram_hit_stat,
+  cache_stripe_dir_sync_bytes_stat,
+  cache_stripe_dir_sync_time_stat,
+  cache_stripe_init_progress_stat,
+  cache_stripe_init_time_stat,
+  cache_stripe_stat_count
+};
+
 extern RecRawStatBlock *cache_rsb;
 
 #define GLOBAL_CACHE_SET_DYN_STAT(x, y) RecSetGlobalRawStatSum(cache_rsb, (x), (y))
@@ -169,6 +192,28 @@ extern RecRawStatBlock *cache_rsb;
 #define CACHE_SET_DYN_STAT(x, y) \
   RecSetGlobalRawStatSum(cache_rsb, (x), (y)) RecSetGlobalRawStatSum(vol->cache_vol->vol_rsb, (x), (y))
 
+#define CACHE_STRIPE_SUM_DYN_STAT(_v, x, y)                                     \
+  do {                                                                          \
+    if ((_v)->stripe_rsb) {                                                     \
+      RecIncrRawStat((_v)->stripe_rsb, this_ethread(), (int)(x), (int64_t)(y)); \
+    }                                                                           \
+  } while (0);
+
+#define CACHE_STRIPE_INCREMENT_DYN_STAT(_v, x) CACHE_STRIPE_SUM_DYN_STAT(_v, x, 1)
+
+#define CACHE_STRIPE_SET_DYN_STAT(_v, x, y)                             \
+  do {                                                                  \
+    if ((_v)->stripe_rsb) {                                             \
+      RecSetGlobalRawStatSum((_v)->stripe_rsb, (int)(x), (int64_t)(y)); \
+    }                                                                   \
+  } while (0);
+
+// stripe initialization milestones, in percent, reported in cache_stripe_init_progress_stat
+#define VOL_INIT_PROGRESS_HEADER    5
+#define VOL_INIT_PROGRESS_DIR       60
+#define VOL_INIT_PROGRESS_RECOVERED 90
+#define VOL_INIT_PROGRESS_DONE      100
+
 #define CACHE_INCREMENT_DYN_STAT(x)                                              \
   do {                                                                           \
     RecIncrRawStat(cache_rsb, mutex->thread_holding, (int)(x), 1);               \
@@ -218,12 +263,16 @@ extern int cache_config_max_doc_size;
 extern int cache_config_min_average_object_size;
 extern int cache_config_agg_write_backlog;
 extern int cache_config_enable_checksum;
+extern int cache_config_dir_probe_filter;
+extern int cache_config_dir_optimistic_probe;
+extern int cache_config_dir_read_concurrency;
 extern int cache_config_alt_rewrite_max_size;
 extern int cache_config_read_while_writer;
 extern int cache_config_agg_write_backlog;
 extern int cache_config_ram_cache_compress;
 extern int cache_config_ram_cache_compress_percent;
 extern int cache_config_ram_cache_use_seen_filter;
+extern int cache_config_ram_cache_shards;
 extern int cache_config_hit_evacuate_percent;
 extern int cache_config_hit_evacuate_size_limit;
 extern int cache_config_force_sector_size;
@@ -543,7 +592,6 @@ struct CacheRemoveCont : public Continuation {
 
 // Global Data
 extern ClassAllocator<CacheVC> cacheVConnectionAllocator;
-extern CacheSync *cacheDirSync;
 // Function Prototypes
 int cache_write(CacheVC *, CacheHTTPInfoVector *);
 int get_alternate_index(CacheHTTPInfoVector *cache_vector, CacheKey key);
@@ -818,6 +866,7 @@ Vol::open_write_lock(CacheVC *cont, int allow_if_writers, int max_writers)
   EThread *t = cont->mutex->thread_holding;
   CACHE_TRY_LOCK(lock, mutex, t);
   if (!lock.is_locked()) {
+    CACHE_STRIPE_INCREMENT_DYN_STAT(this, cache_stripe_lock_contention_stat);
     return -1;
   }
   return open_write(cont, allow_if_writers, max_writers);
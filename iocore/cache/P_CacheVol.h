@@ -160,6 +160,13 @@ struct Vol : public Continuation {
 
   VolInitInfo *init_info = nullptr;
 
+  std::atomic<uint32_t> *tag_filter = nullptr; // per bucket tag summary used by dir_probe, see dir_build_tag_filter()
+  std::atomic<uint32_t> *dir_seq    = nullptr; // per segment sequence numbers, see dir_absent_unlocked()
+  RecRawStatBlock *stripe_rsb       = nullptr; // per stripe stats, see register_stripe_stats()
+  uint8_t *dir_dirty                = nullptr; // per segment, directory copies on disk missing changes, see dir_sync_next_range()
+  CacheSync *dir_sync               = nullptr; // directory sync of this stripe's disk
+  ink_hrtime init_start             = 0;
+
   CacheDisk *disk            = nullptr;
   Cache *cache               = nullptr;
   CacheVol *cache_vol        = nullptr;
@@ -201,6 +208,7 @@ struct Vol : public Continuation {
   int handle_recover_from_data(int event, void *data);
   int handle_recover_write_dir(int event, void *data);
   int handle_header_read(int event, void *data);
+  void read_dir(off_t offset);
 
   int dir_init_done(int event, void *data);
 
@@ -253,7 +261,13 @@ struct Vol : public Continuation {
     SET_HANDLER(&Vol::aggWrite);
   }
 
-  ~Vol() override { ats_free(agg_buffer); }
+  ~Vol() override
+  {
+    ats_free(agg_buffer);
+    delete[] tag_filter;
+    delete[] dir_seq;
+    ats_free(dir_dirty);
+  }
 };
 
 struct AIO_Callback_handler : public Continuation {
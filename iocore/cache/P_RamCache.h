@@ -36,9 +36,21 @@ public:
   virtual int fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey)                         = 0;
   virtual int64_t size() const                                                                               = 0;
 
+  // true if get, put and fixup may be called without holding the stripe lock
+  virtual bool
+  thread_safe() const
+  {
+    return false;
+  }
+
   virtual void init(int64_t max_bytes, Vol *vol) = 0;
   virtual ~RamCache(){};
+
+  // If set, this guards the cache contents instead of the stripe lock.
+  Ptr<ProxyMutex> mutex;
 };
 
 RamCache *new_RamCacheLRU();
 RamCache *new_RamCacheCLFUS();
+RamCache *new_RamCacheTinyLFU();
+RamCache *new_RamCacheSharded(int nshards, RamCache *(*new_shard)());
@@ -31,12 +31,24 @@
 #ifdef HAVE_LZMA_H
 #include <lzma.h>
 #endif
+#ifdef HAVE_ZSTD_H
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
+#include <algorithm>
+#include <string>
+#include <vector>
 
 #define REQUIRED_COMPRESSION 0.9 // must get to this size or declared incompressible
 #define REQUIRED_SHRINK      0.8 // must get to this size or keep original buffer (with padding)
 #define HISTORY_HYSTERIA     10  // extra temporary history
 #define ENTRY_OVERHEAD       256 // per-entry overhead to consider when computing cache value/size
 #define LZMA_BASE_MEMLIMIT   (64 * 1024 * 1024)
+#define ZSTD_LEVEL           3
+#define ZSTD_DICT_SIZE       (64 * 1024) // trained dictionary capacity
+#define ZSTD_SAMPLE_SIZE     (4 * 1024)  // bytes sampled from the front of each entry
+#define ZSTD_SAMPLES         1000        // entries sampled before training a dictionary
 // #define CHECK_ACOUNTING 1 // very expensive double checking of all sizes
 
 #define REQUEUE_HITS(_h)              ((_h) ? ((_h)-1) : 0)
@@ -46,6 +58,9 @@
 #define AVERAGE_VALUE_OVER 100
 #define REQUEUE_LIMIT      100
 
+// per codec stats are laid out in CACHE_COMPRESSION_* order
+#define COMPRESS_STAT(_stat, _ctype) ((_stat) + (_ctype)-CACHE_COMPRESSION_FASTLZ)
+
 #ifdef DEBUG
 
 namespace
@@ -79,10 +94,91 @@ struct RamCacheCLFUSEntry {
   Ptr<IOBufferData> data;
 };
 
+#ifdef HAVE_ZSTD_H
+// Fragments carrying the marshalled HTTP headers and plain body fragments have very different
+// content, so each kind gets its own dictionary.
+enum { ZSTD_DICT_HEAD, ZSTD_DICT_BODY, ZSTD_DICT_KINDS };
+
+// A newly trained dictionary, built by the compressor without the cache lock.
+struct RamCacheZstdTrained {
+  ZSTD_CDict *cdict = nullptr;
+  ZSTD_DDict *ddict = nullptr;
+  unsigned id       = 0;
+};
+
+// A zstd dictionary trained from samples of the entries of one RAM cache. The samples are only
+// used by the compressor, the dictionary is published under the cache lock and never replaced,
+// so entries compressed with it stay readable.
+struct RamCacheZstdDict {
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  bool done = false; // training ran, a failure keeps compressing without a dictionary
+
+  ZSTD_CDict *cdict = nullptr;
+  ZSTD_DDict *ddict = nullptr;
+  unsigned id       = 0;
+
+  bool train(const char *data, uint32_t len, RamCacheZstdTrained &trained);
+
+  void
+  publish(const RamCacheZstdTrained &trained)
+  {
+    cdict = trained.cdict;
+    ddict = trained.ddict;
+    id    = trained.id;
+  }
+
+  ~RamCacheZstdDict()
+  {
+    ZSTD_freeCDict(cdict);
+    ZSTD_freeDDict(ddict);
+  }
+};
+
+// Collect a sample and, once enough are in, train the dictionary. Returns true when a new
+// dictionary was trained into @a trained, for the caller to publish.
+bool
+RamCacheZstdDict::train(const char *data, uint32_t len, RamCacheZstdTrained &trained)
+{
+  if (done) {
+    return false;
+  }
+  size_t n = std::min<size_t>(len, ZSTD_SAMPLE_SIZE);
+  samples.append(data, n);
+  sample_sizes.push_back(n);
+  if (sample_sizes.size() < ZSTD_SAMPLES) {
+    return false;
+  }
+  done = true;
+  std::string dict(ZSTD_DICT_SIZE, '\0');
+  size_t dlen = ZDICT_trainFromBuffer(dict.data(), dict.size(), samples.data(), sample_sizes.data(), sample_sizes.size());
+  samples.clear();
+  samples.shrink_to_fit();
+  sample_sizes.clear();
+  sample_sizes.shrink_to_fit();
+  if (ZDICT_isError(dlen)) {
+    DDbg(dbg_ctl_ram_cache, "zstd dictionary training failed: %s", ZDICT_getErrorName(dlen));
+    return false;
+  }
+  trained.cdict = ZSTD_createCDict(dict.data(), dlen, ZSTD_LEVEL);
+  trained.ddict = ZSTD_createDDict(dict.data(), dlen);
+  trained.id    = ZDICT_getDictID(dict.data(), dlen);
+  DDbg(dbg_ctl_ram_cache, "zstd dictionary %u trained, %zu bytes", trained.id, dlen);
+  return true;
+}
+
+static int
+zstd_dict_kind(const char *data, uint32_t len)
+{
+  return len >= sizeof(Doc) && reinterpret_cast<const Doc *>(data)->hlen ? ZSTD_DICT_HEAD : ZSTD_DICT_BODY;
+}
+#endif
+
 class RamCacheCLFUS : public RamCache
 {
 public:
   RamCacheCLFUS() {}
+  ~RamCacheCLFUS() override;
 
   // returns 1 on found/stored, 0 on not found/stored, if provided auxkey1 and auxkey2 must match
   int get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey = 0) override;
@@ -110,6 +206,13 @@ private:
   uint16_t *_seen                 = nullptr;
   int _ncompressed                = 0;
   RamCacheCLFUSEntry *_compressed = nullptr; // first uncompressed lru[0] entry
+#ifdef HAVE_ZSTD_H
+  RamCacheZstdDict _zstd_dict[ZSTD_DICT_KINDS];
+  ZSTD_CCtx *_zstd_cctx = nullptr; // compressor only
+  ZSTD_DCtx *_zstd_dctx = nullptr; // under the cache lock
+
+  bool _zstd_decompress(char *dst, uint32_t len, const char *src, uint32_t compressed_len);
+#endif
 
   void _resize_hashtable();
   void _victimize(RamCacheCLFUSEntry *e);
@@ -160,6 +263,11 @@ RamCacheCLFUSCompressor::mainEvent(int /* event ATS_UNUSED */, Event *e)
   case CACHE_COMPRESSION_LIBLZMA:
 #ifndef HAVE_LZMA_H
     Warning("lzma not available for RAM cache compression");
+#endif
+    break;
+  case CACHE_COMPRESSION_ZSTD:
+#ifndef HAVE_ZSTD_H
+    Warning("zstd not available for RAM cache compression");
 #endif
     break;
   }
@@ -218,6 +326,14 @@ RamCacheCLFUS::init(int64_t abytes, Vol *avol)
   }
 }
 
+RamCacheCLFUS::~RamCacheCLFUS()
+{
+#ifdef HAVE_ZSTD_H
+  ZSTD_freeCCtx(this->_zstd_cctx);
+  ZSTD_freeDCtx(this->_zstd_dctx);
+#endif
+}
+
 #ifdef CHECK_ACOUNTING
 static void
 check_accounting(RamCacheCLFUS *c)
@@ -262,7 +378,8 @@ RamCacheCLFUS::get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey
         e->hits++;
         uint32_t ram_hit_state = RAM_HIT_COMPRESS_NONE;
         if (e->flag_bits.compressed) {
-          b = static_cast<char *>(ats_malloc(e->len));
+          ink_hrtime start = ink_get_hrtime();
+          b                = static_cast<char *>(ats_malloc(e->len));
           switch (e->flag_bits.compressed) {
           default:
             goto Lfailed;
@@ -294,8 +411,18 @@ RamCacheCLFUS::get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey
             ram_hit_state = RAM_HIT_COMPRESS_LIBLZMA;
             break;
           }
+#endif
+#ifdef HAVE_ZSTD_H
+          case CACHE_COMPRESSION_ZSTD:
+            if (!this->_zstd_decompress(b, e->len, e->data->data(), e->compressed_len)) {
+              goto Lfailed;
+            }
+            ram_hit_state = RAM_HIT_COMPRESS_ZSTD;
+            break;
 #endif
           }
+          CACHE_SUM_DYN_STAT_THREAD(COMPRESS_STAT(cache_ram_cache_fastlz_time_stat, e->flag_bits.compressed),
+                                    ink_get_hrtime() - start);
           IOBufferData *data = new_xmalloc_IOBufferData(b, e->len);
           data->_mem_type    = DEFAULT_ALLOC;
           if (!e->flag_bits.copy) { // don't bother if we have to copy anyway
@@ -339,6 +466,34 @@ Lfailed:
   goto Lerror;
 }
 
+#ifdef HAVE_ZSTD_H
+bool
+RamCacheCLFUS::_zstd_decompress(char *dst, uint32_t len, const char *src, uint32_t compressed_len)
+{
+  if (!this->_zstd_dctx) {
+    this->_zstd_dctx = ZSTD_createDCtx();
+  }
+  // Entries compressed before a dictionary was trained carry no dictionary id.
+  unsigned id  = ZSTD_getDictID_fromFrame(src, compressed_len);
+  size_t dlen  = 0;
+  bool matched = false;
+  for (auto const &d : this->_zstd_dict) {
+    if (id && d.ddict && d.id == id) {
+      dlen    = ZSTD_decompress_usingDDict(this->_zstd_dctx, dst, len, src, compressed_len, d.ddict);
+      matched = true;
+      break;
+    }
+  }
+  if (!matched) {
+    if (id) {
+      return false;
+    }
+    dlen = ZSTD_decompressDCtx(this->_zstd_dctx, dst, len, src, compressed_len);
+  }
+  return !ZSTD_isError(dlen) && dlen == len;
+}
+#endif
+
 void
 RamCacheCLFUS::_tick()
 {
@@ -421,7 +576,8 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
     return;
   }
   ink_assert(vol != nullptr);
-  MUTEX_TAKE_LOCK(vol->mutex, thread);
+  ProxyMutex *lock = mutex ? mutex.get() : vol->mutex.get();
+  MUTEX_TAKE_LOCK(lock, thread);
   if (!this->_compressed) {
     this->_compressed  = this->_lru[0].head;
     this->_ncompressed = 0;
@@ -455,15 +611,30 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
       case CACHE_COMPRESSION_LIBLZMA:
         l = e->len;
         break;
+#endif
+#ifdef HAVE_ZSTD_H
+      case CACHE_COMPRESSION_ZSTD:
+        l = static_cast<uint32_t>(ZSTD_compressBound(e->len));
+        break;
 #endif
       }
       // store transient data for lock release
       Ptr<IOBufferData> edata = e->data;
       uint32_t elen           = e->len;
       CryptoHash key          = e->key;
-      MUTEX_UNTAKE_LOCK(vol->mutex, thread);
-      b           = static_cast<char *>(ats_malloc(l));
-      bool failed = false;
+#ifdef HAVE_ZSTD_H
+      RamCacheZstdTrained trained;
+      int kind          = 0;
+      ZSTD_CDict *cdict = nullptr;
+      if (ctype == CACHE_COMPRESSION_ZSTD) {
+        kind  = zstd_dict_kind(edata->data(), elen);
+        cdict = this->_zstd_dict[kind].cdict;
+      }
+#endif
+      MUTEX_UNTAKE_LOCK(lock, thread);
+      ink_hrtime start = ink_get_hrtime();
+      b                = static_cast<char *>(ats_malloc(l));
+      bool failed      = false;
       switch (ctype) {
       default:
         goto Lfailed;
@@ -495,8 +666,32 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
         break;
       }
 #endif
+#ifdef HAVE_ZSTD_H
+      case CACHE_COMPRESSION_ZSTD: {
+        if (this->_zstd_dict[kind].train(edata->data(), elen, trained)) {
+          cdict = trained.cdict;
+        }
+        if (!this->_zstd_cctx) {
+          this->_zstd_cctx = ZSTD_createCCtx();
+        }
+        size_t ll = cdict ? ZSTD_compress_usingCDict(this->_zstd_cctx, b, l, edata->data(), elen, cdict) :
+                            ZSTD_compressCCtx(this->_zstd_cctx, b, l, edata->data(), elen, ZSTD_LEVEL);
+        if (ZSTD_isError(ll)) {
+          failed = true;
+        }
+        l = static_cast<uint32_t>(ll);
+        break;
+      }
+#endif
+      }
+      ink_hrtime elapsed = ink_get_hrtime() - start;
+      MUTEX_TAKE_LOCK(lock, thread);
+      CACHE_SUM_DYN_STAT_THREAD(COMPRESS_STAT(cache_ram_cache_fastlz_time_stat, ctype), elapsed);
+#ifdef HAVE_ZSTD_H
+      if (trained.cdict) {
+        this->_zstd_dict[kind].publish(trained);
       }
-      MUTEX_TAKE_LOCK(vol->mutex, thread);
+#endif
       // see if the entry is till around
       {
         if (failed) {
@@ -527,6 +722,7 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
         bb                      = static_cast<char *>(ats_malloc(l));
         memcpy(bb, b, l);
         ats_free(b);
+        CACHE_SUM_DYN_STAT_THREAD(COMPRESS_STAT(cache_ram_cache_fastlz_bytes_saved_stat, ctype), e->len - l);
         e->compressed_len  = l;
         int64_t delta      = (static_cast<int64_t>(l)) - static_cast<int64_t>(e->size);
         this->_bytes      += delta;
@@ -560,7 +756,7 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
     this->_compressed = e->lru_link.next;
     this->_ncompressed++;
   }
-  MUTEX_UNTAKE_LOCK(vol->mutex, thread);
+  MUTEX_UNTAKE_LOCK(lock, thread);
   return;
 }
 
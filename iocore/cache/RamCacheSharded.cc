@@ -0,0 +1,116 @@
+/** @file
+
+  RAM cache partitioned by key into independently locked shards.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+// Each shard is a complete RAM cache of the configured algorithm with its own mutex, holding
+// an equal share of the stripe's RAM cache budget. Because every operation takes the shard
+// mutex the cache no longer relies on the stripe lock, so readers which can locate a fragment
+// without the stripe lock can also get it from RAM without the stripe lock.
+
+#include "P_Cache.h"
+
+#include <memory>
+#include <vector>
+
+struct RamCacheSharded : public RamCache {
+  int get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey = 0) override;
+  int put(CryptoHash *key, IOBufferData *data, uint32_t len, bool copy = false, uint64_t auxkey = 0) override;
+  int fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey) override;
+  int64_t size() const override;
+
+  bool
+  thread_safe() const override
+  {
+    return true;
+  }
+
+  void init(int64_t max_bytes, Vol *vol) override;
+
+  RamCacheSharded(int nshards, RamCache *(*new_shard)());
+
+  // private
+  std::vector<std::unique_ptr<RamCache>> shards;
+
+  RamCache *
+  shard_for(const CryptoHash *key) const
+  {
+    return shards[key->slice32(2) % shards.size()].get();
+  }
+};
+
+RamCacheSharded::RamCacheSharded(int nshards, RamCache *(*new_shard)())
+{
+  for (int i = 0; i < nshards; i++) {
+    RamCache *shard = new_shard();
+    shard->mutex    = new_ProxyMutex();
+    shards.emplace_back(shard);
+  }
+}
+
+void
+RamCacheSharded::init(int64_t abytes, Vol *avol)
+{
+  for (auto &shard : shards) {
+    shard->init(abytes / static_cast<int64_t>(shards.size()), avol);
+  }
+}
+
+int
+RamCacheSharded::get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey)
+{
+  RamCache *shard = shard_for(key);
+  SCOPED_MUTEX_LOCK(lock, shard->mutex, this_ethread());
+  return shard->get(key, ret_data, auxkey);
+}
+
+int
+RamCacheSharded::put(CryptoHash *key, IOBufferData *data, uint32_t len, bool copy, uint64_t auxkey)
+{
+  RamCache *shard = shard_for(key);
+  SCOPED_MUTEX_LOCK(lock, shard->mutex, this_ethread());
+  return shard->put(key, data, len, copy, auxkey);
+}
+
+int
+RamCacheSharded::fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey)
+{
+  RamCache *shard = shard_for(key);
+  SCOPED_MUTEX_LOCK(lock, shard->mutex, this_ethread());
+  return shard->fixup(key, old_auxkey, new_auxkey);
+}
+
+int64_t
+RamCacheSharded::size() const
+{
+  int64_t s = 0;
+  for (auto const &shard : shards) {
+    SCOPED_MUTEX_LOCK(lock, shard->mutex, this_ethread());
+    s += shard->size();
+  }
+  return s;
+}
+
+RamCache *
+new_RamCacheSharded(int nshards, RamCache *(*new_shard)())
+{
+  return new RamCacheSharded(nshards, new_shard);
+}
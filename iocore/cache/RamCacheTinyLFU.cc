@@ -0,0 +1,386 @@
+/** @file
+
+  W-TinyLFU RAM cache: a small LRU admission window in front of a segmented LRU main cache,
+  with a frequency sketch deciding which of the window victim and the main victim to keep.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+// Objects enter the window LRU. When the window is over budget its LRU object becomes a
+// candidate for the probation segment of the main cache. If the main cache is full, the
+// candidate is only admitted if the sketch says it is more frequently used than the main
+// victim, otherwise it is dropped. Hits in probation promote to the protected segment, and
+// protected overflow demotes back to probation. One-hit wonders therefore never displace
+// the hot set, they age out of the window instead.
+
+#include "P_Cache.h"
+
+#define ENTRY_OVERHEAD        128 // per-entry overhead to consider when computing sizes
+#define WINDOW_PERCENT        1   // share of the cache given to the admission window
+#define PROTECTED_PERCENT     80  // share of the main cache given to the protected segment
+#define SKETCH_DEPTH          4   // rows in the count-min sketch
+#define SKETCH_MAX_COUNT      15  // counters saturate, as with 4 bit counters
+#define SKETCH_SAMPLE_FACTOR  10  // age the sketch after this many increments per counter
+#define SKETCH_MIN_WIDTH_BITS 10
+
+enum RamCacheTinyLFUSegment : uint8_t {
+  SEGMENT_WINDOW,
+  SEGMENT_PROBATION,
+  SEGMENT_PROTECTED,
+};
+
+struct RamCacheTinyLFUEntry {
+  CryptoHash key;
+  uint64_t auxkey;
+  uint32_t charge; // bytes counted against the cache for this entry
+  RamCacheTinyLFUSegment segment;
+  LINK(RamCacheTinyLFUEntry, lru_link);
+  LINK(RamCacheTinyLFUEntry, hash_link);
+  Ptr<IOBufferData> data;
+};
+
+struct RamCacheTinyLFU : public RamCache {
+  int64_t max_bytes = 0;
+  int64_t bytes     = 0;
+  int64_t objects   = 0;
+
+  // returns 1 on found/stored, 0 on not found/stored, if provided auxkey must match
+  int get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey = 0) override;
+  int put(CryptoHash *key, IOBufferData *data, uint32_t len, bool copy = false, uint64_t auxkey = 0) override;
+  int fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey) override;
+  int64_t size() const override;
+
+  void init(int64_t max_bytes, Vol *vol) override;
+
+  ~RamCacheTinyLFU() override;
+
+  // private
+  Que(RamCacheTinyLFUEntry, lru_link) lru[3]; // indexed by RamCacheTinyLFUSegment
+  int64_t segment_bytes[3] = {0, 0, 0};
+  int64_t window_max       = 0;
+  int64_t protected_max    = 0;
+
+  DList(RamCacheTinyLFUEntry, hash_link) *bucket = nullptr;
+  int nbuckets                                   = 0;
+  int ibuckets                                   = 0;
+  Vol *vol                                       = nullptr;
+
+  uint8_t *sketch       = nullptr; // SKETCH_DEPTH rows of (1 << sketch_bits) counters
+  int sketch_bits       = 0;
+  int64_t sketch_adds   = 0;
+  int64_t sketch_sample = 0;
+
+  void resize_hashtable();
+  uint64_t sketch_index(const CryptoHash *key, int row) const;
+  void sketch_increment(const CryptoHash *key);
+  int sketch_frequency(const CryptoHash *key) const;
+  void move(RamCacheTinyLFUEntry *e, RamCacheTinyLFUSegment segment);
+  void admit_from_window();
+  RamCacheTinyLFUEntry *remove(RamCacheTinyLFUEntry *e);
+};
+
+#ifdef DEBUG
+
+namespace
+{
+
+DbgCtl dbg_ctl_ram_cache{"ram_cache"};
+
+} // end anonymous namespace
+
+#endif
+
+int64_t
+RamCacheTinyLFU::size() const
+{
+  int64_t s = 0;
+  for (const auto &q : lru) {
+    forl_LL(RamCacheTinyLFUEntry, e, q)
+    {
+      s += sizeof(*e);
+      s += sizeof(*e->data);
+      s += e->data->block_size();
+    }
+  }
+  return s;
+}
+
+ClassAllocator<RamCacheTinyLFUEntry> ramCacheTinyLFUEntryAllocator("RamCacheTinyLFUEntry");
+
+static const int bucket_sizes[] = {127,     251,      509,      1021,     2039,      4093,      8191,     16381,
+                                   32749,   65521,    131071,   262139,   524287,    1048573,   2097143,  4194301,
+                                   8388593, 16777213, 33554393, 67108859, 134217689, 268435399, 536870909};
+
+void
+RamCacheTinyLFU::resize_hashtable()
+{
+  int anbuckets = bucket_sizes[ibuckets];
+  DDbg(dbg_ctl_ram_cache, "resize hashtable %d", anbuckets);
+  int64_t s                                          = anbuckets * sizeof(DList(RamCacheTinyLFUEntry, hash_link));
+  DList(RamCacheTinyLFUEntry, hash_link) *new_bucket = static_cast<DList(RamCacheTinyLFUEntry, hash_link) *>(ats_malloc(s));
+  memset(static_cast<void *>(new_bucket), 0, s);
+  if (bucket) {
+    for (int64_t i = 0; i < nbuckets; i++) {
+      RamCacheTinyLFUEntry *e = nullptr;
+      while ((e = bucket[i].pop())) {
+        new_bucket[e->key.slice32(3) % anbuckets].push(e);
+      }
+    }
+    ats_free(bucket);
+  }
+  bucket   = new_bucket;
+  nbuckets = anbuckets;
+}
+
+void
+RamCacheTinyLFU::init(int64_t abytes, Vol *avol)
+{
+  vol       = avol;
+  max_bytes = abytes;
+  DDbg(dbg_ctl_ram_cache, "initializing ram_cache %" PRId64 " bytes", abytes);
+  if (!max_bytes) {
+    return;
+  }
+  window_max    = max_bytes * WINDOW_PERCENT / 100;
+  protected_max = (max_bytes - window_max) * PROTECTED_PERCENT / 100;
+
+  // One counter per object the cache is expected to hold, rounded up to a power of 2.
+  int64_t objects_expected = max_bytes / std::max(cache_config_min_average_object_size, 1);
+  sketch_bits              = SKETCH_MIN_WIDTH_BITS;
+  while ((1LL << sketch_bits) < objects_expected && sketch_bits < 30) {
+    ++sketch_bits;
+  }
+  sketch_sample = (1LL << sketch_bits) * SKETCH_SAMPLE_FACTOR;
+  sketch        = static_cast<uint8_t *>(ats_malloc(SKETCH_DEPTH << sketch_bits));
+  memset(sketch, 0, SKETCH_DEPTH << sketch_bits);
+  resize_hashtable();
+}
+
+RamCacheTinyLFU::~RamCacheTinyLFU()
+{
+  for (auto &q : lru) {
+    while (RamCacheTinyLFUEntry *e = q.pop()) {
+      e->data = nullptr;
+      ramCacheTinyLFUEntryAllocator.free(e);
+    }
+  }
+  ats_free(bucket);
+  ats_free(sketch);
+}
+
+uint64_t
+RamCacheTinyLFU::sketch_index(const CryptoHash *key, int row) const
+{
+  static const uint64_t seeds[SKETCH_DEPTH] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL,
+                                               0xcbf29ce484222325ULL};
+  uint64_t x = key->slice64(0) * 0x9e3779b97f4a7c15ULL + key->slice64(1) + seeds[row];
+  x          = (x ^ (x >> 33)) * 0xff51afd7ed558ccdULL;
+  x         ^= x >> 33;
+  return x >> (64 - sketch_bits);
+}
+
+void
+RamCacheTinyLFU::sketch_increment(const CryptoHash *key)
+{
+  for (int row = 0; row < SKETCH_DEPTH; row++) {
+    uint8_t &c = sketch[(static_cast<uint64_t>(row) << sketch_bits) + sketch_index(key, row)];
+    if (c < SKETCH_MAX_COUNT) {
+      ++c;
+    }
+  }
+  // Halve all counters periodically so that old popularity decays.
+  if (++sketch_adds >= sketch_sample) {
+    for (int64_t i = 0; i < (SKETCH_DEPTH << sketch_bits); i++) {
+      sketch[i] >>= 1;
+    }
+    sketch_adds /= 2;
+  }
+}
+
+int
+RamCacheTinyLFU::sketch_frequency(const CryptoHash *key) const
+{
+  int f = SKETCH_MAX_COUNT;
+  for (int row = 0; row < SKETCH_DEPTH; row++) {
+    f = std::min(f, static_cast<int>(sketch[(static_cast<uint64_t>(row) << sketch_bits) + sketch_index(key, row)]));
+  }
+  return f;
+}
+
+void
+RamCacheTinyLFU::move(RamCacheTinyLFUEntry *e, RamCacheTinyLFUSegment segment)
+{
+  lru[e->segment].remove(e);
+  segment_bytes[e->segment] -= e->charge;
+  e->segment                 = segment;
+  lru[segment].enqueue(e);
+  segment_bytes[segment] += e->charge;
+}
+
+int
+RamCacheTinyLFU::get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey)
+{
+  if (!max_bytes) {
+    return 0;
+  }
+  sketch_increment(key);
+  uint32_t i              = key->slice32(3) % nbuckets;
+  RamCacheTinyLFUEntry *e = bucket[i].head;
+  while (e) {
+    if (e->key == *key && e->auxkey == auxkey) {
+      if (e->segment == SEGMENT_WINDOW) {
+        move(e, SEGMENT_WINDOW);
+      } else {
+        move(e, SEGMENT_PROTECTED);
+        while (segment_bytes[SEGMENT_PROTECTED] > protected_max) {
+          move(lru[SEGMENT_PROTECTED].head, SEGMENT_PROBATION);
+        }
+      }
+      (*ret_data) = e->data;
+      DDbg(dbg_ctl_ram_cache, "get %X %" PRIu64 " HIT", key->slice32(3), auxkey);
+      CACHE_SUM_DYN_STAT_THREAD(cache_ram_cache_hits_stat, 1);
+      return 1;
+    }
+    e = e->hash_link.next;
+  }
+  DDbg(dbg_ctl_ram_cache, "get %X %" PRIu64 " MISS", key->slice32(3), auxkey);
+  CACHE_SUM_DYN_STAT_THREAD(cache_ram_cache_misses_stat, 1);
+  return 0;
+}
+
+RamCacheTinyLFUEntry *
+RamCacheTinyLFU::remove(RamCacheTinyLFUEntry *e)
+{
+  RamCacheTinyLFUEntry *ret = e->hash_link.next;
+  uint32_t b                = e->key.slice32(3) % nbuckets;
+  bucket[b].remove(e);
+  lru[e->segment].remove(e);
+  segment_bytes[e->segment] -= e->charge;
+  bytes                     -= e->charge;
+  CACHE_SUM_DYN_STAT_THREAD(cache_ram_cache_bytes_stat, -static_cast<int64_t>(e->charge));
+  DDbg(dbg_ctl_ram_cache, "put %X %" PRIu64 " FREED", e->key.slice32(3), e->auxkey);
+  e->data = nullptr;
+  THREAD_FREE(e, ramCacheTinyLFUEntryAllocator, this_thread());
+  objects--;
+  return ret;
+}
+
+// Move window overflow into the main cache, letting the sketch pick between each candidate and
+// the main cache victims it would displace. The victims are chosen before anything is evicted, so
+// a rejected candidate leaves the main cache untouched.
+void
+RamCacheTinyLFU::admit_from_window()
+{
+  int64_t main_max = max_bytes - window_max;
+  while (segment_bytes[SEGMENT_WINDOW] > window_max) {
+    RamCacheTinyLFUEntry *candidate = lru[SEGMENT_WINDOW].head;
+    bool admit                      = candidate->charge <= main_max;
+    if (admit) {
+      // Victims come from the LRU end of probation, then of protected, until the candidate fits.
+      int64_t need    = segment_bytes[SEGMENT_PROBATION] + segment_bytes[SEGMENT_PROTECTED] + candidate->charge - main_max;
+      int victim_freq = -1;
+      int nvictims    = 0;
+      for (RamCacheTinyLFUEntry *victim = lru[SEGMENT_PROBATION].head; need > 0; victim = victim->lru_link.next) {
+        if (!victim) {
+          victim = lru[SEGMENT_PROTECTED].head;
+        }
+        victim_freq  = std::max(victim_freq, sketch_frequency(&victim->key));
+        need        -= victim->charge;
+        ++nvictims;
+      }
+      admit = sketch_frequency(&candidate->key) > victim_freq;
+      while (admit && nvictims--) {
+        remove(lru[SEGMENT_PROBATION].head ? lru[SEGMENT_PROBATION].head : lru[SEGMENT_PROTECTED].head);
+      }
+    }
+    if (admit) {
+      move(candidate, SEGMENT_PROBATION);
+    } else {
+      DDbg(dbg_ctl_ram_cache, "put %X %" PRIu64 " REJECTED", candidate->key.slice32(3), candidate->auxkey);
+      CACHE_SUM_DYN_STAT_THREAD(cache_ram_cache_admission_rejects_stat, 1);
+      remove(candidate);
+    }
+  }
+}
+
+// ignore 'copy' since we don't touch the data
+int
+RamCacheTinyLFU::put(CryptoHash *key, IOBufferData *data, uint32_t len, bool, uint64_t auxkey)
+{
+  if (!max_bytes) {
+    return 0;
+  }
+  uint32_t i              = key->slice32(3) % nbuckets;
+  RamCacheTinyLFUEntry *e = bucket[i].head;
+  while (e) {
+    if (e->key == *key) {
+      if (e->auxkey == auxkey) {
+        move(e, e->segment);
+        return 1;
+      } else { // discard when aux keys conflict
+        e = remove(e);
+        continue;
+      }
+    }
+    e = e->hash_link.next;
+  }
+  e          = THREAD_ALLOC(ramCacheTinyLFUEntryAllocator, this_ethread());
+  e->key     = *key;
+  e->auxkey  = auxkey;
+  e->data    = data;
+  e->charge  = ENTRY_OVERHEAD + data->block_size();
+  e->segment = SEGMENT_WINDOW;
+  bucket[i].push(e);
+  lru[SEGMENT_WINDOW].enqueue(e);
+  segment_bytes[SEGMENT_WINDOW] += e->charge;
+  bytes                         += e->charge;
+  objects++;
+  CACHE_SUM_DYN_STAT_THREAD(cache_ram_cache_bytes_stat, e->charge);
+  DDbg(dbg_ctl_ram_cache, "put %X %" PRIu64 " len %d INSERTED", key->slice32(3), auxkey, len);
+  admit_from_window();
+  if (objects > nbuckets) {
+    ++ibuckets;
+    resize_hashtable();
+  }
+  return 1;
+}
+
+int
+RamCacheTinyLFU::fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey)
+{
+  if (!max_bytes) {
+    return 0;
+  }
+  uint32_t i              = key->slice32(3) % nbuckets;
+  RamCacheTinyLFUEntry *e = bucket[i].head;
+  while (e) {
+    if (e->key == *key && e->auxkey == old_auxkey) {
+      e->auxkey = new_auxkey;
+      return 1;
+    }
+    e = e->hash_link.next;
+  }
+  return 0;
+}
+
+RamCache *
+new_RamCacheTinyLFU()
+{
+  return new RamCacheTinyLFU;
+}
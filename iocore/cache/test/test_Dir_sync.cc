@@ -0,0 +1,140 @@
+/** @file
+
+  Directory syncs write only the segments that changed
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "main.h"
+
+constexpr int CHANGED_SEGMENT = 1;
+
+// Check that the copy of segment @a s on disk that @a serial wrote matches the directory in memory.
+static bool
+segment_on_disk(Vol *vol, uint32_t serial, int s)
+{
+  // the stripe may be opened with O_DIRECT, read the whole copy into an aligned buffer
+  size_t dirlen = vol->dirlen();
+  off_t start   = vol->skip + ((serial & 1) ? dirlen : 0);
+  off_t seg_len = vol->buckets * DIR_DEPTH * SIZEOF_DIR;
+  char *buf     = static_cast<char *>(ats_memalign(ats_pagesize(), dirlen));
+  bool match    = pread(vol->fd, buf, dirlen, start) == static_cast<ssize_t>(dirlen);
+  match         = match && memcmp(buf + vol->headerlen() + s * seg_len, vol->dir_segment(s), seg_len) == 0;
+  ats_free(buf);
+  return match;
+}
+
+// Syncs the directory twice, once for each copy on disk, after a change to one segment.
+class DirSyncTest : public CacheTestHandler
+{
+public:
+  DirSyncTest() { SET_HANDLER(&DirSyncTest::start_test); }
+
+  int
+  start_test(int event, void *e)
+  {
+    Vol *vol = gvol[0];
+    REQUIRE(vol->segments > CHANGED_SEGMENT + 1);
+    {
+      SCOPED_MUTEX_LOCK(lock, vol->mutex, this_ethread());
+      // as if everything had been synced, then one entry changes
+      memset(vol->dir_dirty, 0, vol->segments);
+      CacheKey key;
+      key.u32[0] = CHANGED_SEGMENT;
+      key.u32[1] = 3;
+      key.u32[2] = 5;
+      key.u32[3] = 0;
+      Dir dir;
+      dir_set_offset(&dir, 1);
+      dir_set_head(&dir, true);
+      dir_insert(&key, vol, &dir);
+      for (int s = 0; s < vol->segments; s++) {
+        CHECK(vol->dir_dirty[s] == (s == CHANGED_SEGMENT ? DIR_SYNC_ALL_COPIES : 0));
+      }
+      _serial = vol->header->sync_serial;
+    }
+    SET_HANDLER(&DirSyncTest::sync_event);
+    eventProcessor.schedule_imm(vol->dir_sync, ET_CALL);
+    this_ethread()->schedule_in(this, SLEEP_TIME);
+    return 0;
+  }
+
+  int
+  sync_event(int event, void *e)
+  {
+    Vol *vol = gvol[0];
+    MUTEX_TRY_LOCK(lock, vol->mutex, this_ethread());
+    if (!lock.is_locked() || vol->header->sync_serial == _serial || vol->dir_sync_in_progress) {
+      this_ethread()->schedule_in(this, SLEEP_TIME);
+      return 0;
+    }
+    _serial = vol->header->sync_serial;
+    ++_syncs;
+
+    // only the header, the freelist, the changed segment and the footer were written
+    CHECK(vol->dir_sync->sync_bytes > 0);
+    CHECK(static_cast<size_t>(vol->dir_sync->sync_bytes) < vol->dirlen());
+    CHECK(segment_on_disk(vol, _serial, CHANGED_SEGMENT));
+
+    if (_syncs == 1) {
+      // the other copy still misses the change
+      CHECK(vol->dir_dirty[CHANGED_SEGMENT] == (DIR_SYNC_ALL_COPIES & ~SYNC_COPY(_serial)));
+      vol->header->dirty = 1;
+      eventProcessor.schedule_imm(vol->dir_sync, ET_CALL);
+      this_ethread()->schedule_in(this, SLEEP_TIME);
+      return 0;
+    }
+    for (int s = 0; s < vol->segments; s++) {
+      CHECK(vol->dir_dirty[s] == 0);
+    }
+    delete this;
+    return 0;
+  }
+
+private:
+  uint32_t _serial = 0;
+  int _syncs       = 0;
+};
+
+class DirSyncInit : public CacheInit
+{
+public:
+  DirSyncInit() {}
+  int
+  cache_init_success_callback(int event, void *e) override
+  {
+    DirSyncTest *t   = new DirSyncTest;
+    TerminalTest *tt = new TerminalTest;
+    t->add(tt);
+    this_ethread()->schedule_imm(t);
+    delete this;
+    return 0;
+  }
+};
+
+TEST_CASE("dir sync of changed segments", "cache")
+{
+  // smaller objects, so the stripe has several directory segments
+  RecSetRecordInt("proxy.config.cache.min_average_object_size", 2000, REC_SOURCE_EXPLICIT);
+  init_cache(256 * 1024 * 1024);
+  DirSyncInit *init = new DirSyncInit;
+
+  this_ethread()->schedule_imm(init);
+  this_thread()->execute();
+}
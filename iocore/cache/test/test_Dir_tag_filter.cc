@@ -0,0 +1,122 @@
+/** @file
+
+  Directory probes with the per bucket tag filter
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "main.h"
+
+// A key in bucket @a b of segment @a s with tag @a tag.
+static CacheKey
+make_key(int s, int b, unsigned int tag)
+{
+  CacheKey key;
+  key.u32[0] = s;
+  key.u32[1] = b;
+  key.u32[2] = tag;
+  key.u32[3] = 0;
+  return key;
+}
+
+static bool
+filter_has(Vol *vol, const CacheKey &key)
+{
+  int s = key.slice32(0) % vol->segments;
+  int b = key.slice32(1) % vol->buckets;
+  return vol->tag_filter[static_cast<int64_t>(s) * vol->buckets + b].load() & dir_tag_filter_bit(DIR_MASK_TAG(key.slice32(2)));
+}
+
+static bool
+probe(Vol *vol, const CacheKey &key)
+{
+  Dir result, *last_collision = nullptr;
+  return dir_probe(&key, vol, &result, &last_collision);
+}
+
+class DirTagFilterInit : public CacheInit
+{
+public:
+  DirTagFilterInit() {}
+  int
+  cache_init_success_callback(int event, void *e) override
+  {
+    Vol *vol = gvol[0];
+    {
+      SCOPED_MUTEX_LOCK(lock, vol->mutex, this_ethread());
+      vol_dir_clear(vol);
+      dir_build_tag_filter(vol);
+      REQUIRE(vol->tag_filter != nullptr);
+
+      // entries at offset 1 are only valid once something was written
+      vol->header->agg_pos = vol->header->write_pos += 1024;
+      Dir dir;
+      dir_set_offset(&dir, 1);
+      dir_set_phase(&dir, vol->header->phase);
+      dir_set_head(&dir, true);
+
+      CacheKey key      = make_key(0, 7, 1);
+      CacheKey same_bit = make_key(0, 7, 1 + 32); // another tag with the same filter bit
+      CacheKey other    = make_key(0, 7, 2);
+
+      // an empty bucket filters everything
+      CHECK(!filter_has(vol, key));
+      CHECK(!probe(vol, key));
+
+      dir_insert(&key, vol, &dir);
+      CHECK(filter_has(vol, key));
+      CHECK(probe(vol, key));
+
+      // a tag without its bit is filtered, a tag sharing the bit walks the bucket and misses
+      CHECK(!filter_has(vol, other));
+      CHECK(!probe(vol, other));
+      CHECK(filter_has(vol, same_bit));
+      CHECK(!probe(vol, same_bit));
+
+      // dir_overwrite of a new entry sets the bit like dir_insert
+      CHECK(dir_overwrite(&other, vol, &dir, &dir, false) == 0);
+      CHECK(filter_has(vol, other));
+      CHECK(probe(vol, other));
+
+      // deleting leaves the bit set until the filter is rebuilt
+      CHECK(dir_delete(&key, vol, &dir));
+      CHECK(filter_has(vol, key));
+      CHECK(!probe(vol, key));
+      dir_build_tag_filter(vol);
+      CHECK(!filter_has(vol, key));
+      CHECK(filter_has(vol, other));
+      CHECK(probe(vol, other));
+
+      vol_dir_clear(vol);
+    }
+
+    this_ethread()->schedule_imm(new TerminalTest);
+    delete this;
+    return 0;
+  }
+};
+
+TEST_CASE("dir probe with tag filter", "cache")
+{
+  init_cache(256 * 1024 * 1024);
+  DirTagFilterInit *init = new DirTagFilterInit;
+
+  this_ethread()->schedule_imm(init);
+  this_thread()->execute();
+}
@@ -0,0 +1,145 @@
+/** @file
+
+  Directory probes without the stripe lock against a concurrent writer
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "main.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+constexpr int NUM_READERS = 2;
+constexpr int NUM_BUCKETS = 64;
+constexpr int NUM_CHURN   = 6; // entries per bucket inserted and deleted around the stable one
+constexpr int NUM_ROUNDS  = 2000;
+
+// A key in bucket @a b of segment 0 with tag @a tag.
+static CacheKey
+make_key(int b, unsigned int tag)
+{
+  CacheKey key;
+  key.u32[0] = 0;
+  key.u32[1] = b;
+  key.u32[2] = tag;
+  key.u32[3] = 0;
+  return key;
+}
+
+static Dir
+make_dir(int offset)
+{
+  Dir dir;
+  dir_set_offset(&dir, offset);
+  dir_set_head(&dir, true);
+  return dir;
+}
+
+class DirUnlockedInit : public CacheInit
+{
+public:
+  DirUnlockedInit() {}
+  int
+  cache_init_success_callback(int event, void *e) override
+  {
+    Vol *vol = gvol[0];
+    SCOPED_MUTEX_LOCK(lock, vol->mutex, this_ethread());
+    vol_dir_clear(vol);
+    dir_build_tag_filter(vol);
+    dir_init_optimistic_probe(vol);
+
+    // Every bucket has one stable entry with tag 1 and offset b + 1, behind churn entries that the
+    // writer deletes and inserts again, so the stable entry moves around in its chain.
+    for (int b = 0; b < NUM_BUCKETS; b++) {
+      for (int c = 0; c < NUM_CHURN; c++) {
+        CacheKey key = make_key(b, 2 + c);
+        Dir dir      = make_dir(1000 + c);
+        dir_insert(&key, vol, &dir);
+      }
+      CacheKey key = make_key(b, 1);
+      Dir dir      = make_dir(b + 1);
+      dir_insert(&key, vol, &dir);
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<int> errors{0};
+    std::atomic<int64_t> hits{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < NUM_READERS; i++) {
+      readers.emplace_back([&]() {
+        int64_t h = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+          for (int b = 0; b < NUM_BUCKETS; b++) {
+            CacheKey key = make_key(b, 1);
+            Dir result;
+            errors += dir_absent_unlocked(&key, vol);
+            if (dir_probe_unlocked(&key, vol, &result)) {
+              errors += dir_offset(&result) != b + 1 || dir_tag(&result) != 1;
+              h++;
+            }
+          }
+        }
+        hits += h;
+      });
+    }
+
+    for (int r = 0; r < NUM_ROUNDS; r++) {
+      for (int b = 0; b < NUM_BUCKETS; b++) {
+        int c        = r % NUM_CHURN;
+        CacheKey key = make_key(b, 2 + c);
+        Dir dir      = make_dir(1000 + c);
+        dir_delete(&key, vol, &dir);
+        dir_insert(&key, vol, &dir);
+      }
+    }
+
+    done = true;
+    for (auto &t : readers) {
+      t.join();
+    }
+    CHECK(errors == 0);
+    CHECK(hits > 0);
+
+    // Without a writer every stable entry is found, and a key that was never inserted is absent.
+    for (int b = 0; b < NUM_BUCKETS; b++) {
+      CacheKey key = make_key(b, 1);
+      Dir result;
+      CHECK(dir_probe_unlocked(&key, vol, &result));
+      CHECK(dir_offset(&result) == b + 1);
+    }
+    CacheKey missing = make_key(0, 9);
+    CHECK(dir_absent_unlocked(&missing, vol));
+
+    vol_dir_clear(vol);
+    this_ethread()->schedule_imm(new TerminalTest);
+    delete this;
+    return 0;
+  }
+};
+
+TEST_CASE("unlocked dir probe against a writer", "cache")
+{
+  init_cache(256 * 1024 * 1024);
+  DirUnlockedInit *init = new DirUnlockedInit;
+
+  this_ethread()->schedule_imm(init);
+  this_thread()->execute();
+}
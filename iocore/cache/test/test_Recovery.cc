@@ -0,0 +1,118 @@
+/** @file
+
+  Restart a stripe from the directory it synced on shutdown
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#define SMALL_FILE 10 * 1024
+
+#include "main.h"
+
+// Sync the directory as on shutdown, then bring the stripe up again from disk. The synced
+// directory has a sync serial, so the restart reads it and recovers the data written after it.
+class CacheRestart : public CacheTestHandler
+{
+public:
+  CacheRestart(const char *url) : CacheTestHandler()
+  {
+    this->info.create();
+    build_hdrs(this->info, url);
+    SET_HANDLER(&CacheRestart::start_test);
+  }
+
+  ~CacheRestart() override { this->info.destroy(); }
+
+  int
+  start_test(int event, void *e)
+  {
+    REQUIRE(event == EVENT_IMMEDIATE);
+    REQUIRE(gnvol == 1);
+
+    // This keeps the old stripe locked, nothing else touches it after the restart.
+    sync_cache_dir_on_shutdown();
+
+    Vol *old = gvol[0];
+    REQUIRE(old->header->sync_serial != 0);
+    gvol[0] = nullptr;
+    gnvol--;
+
+    this->_vol             = new Vol();
+    this->_vol->disk       = old->disk;
+    this->_vol->fd         = old->fd;
+    this->_vol->cache      = old->cache;
+    this->_vol->cache_vol  = old->cache_vol;
+    this->_vol->stripe_rsb = old->stripe_rsb;
+    this->_vol->init(old->disk->path, old->len / STORE_BLOCK_SIZE, old->skip, false);
+
+    SET_HANDLER(&CacheRestart::wait_event);
+    this_ethread()->schedule_in(this, SLEEP_TIME);
+    return 0;
+  }
+
+  int
+  wait_event(int event, void *e)
+  {
+    if (gnvol == 0 || gvol[0] != this->_vol) {
+      this_ethread()->schedule_in(this, SLEEP_TIME);
+      return 0;
+    }
+
+    HttpCacheKey key = generate_key(this->info);
+    Dir result, *last_collision = nullptr;
+    {
+      SCOPED_MUTEX_LOCK(lock, this->_vol->mutex, this_ethread());
+      CHECK(this->_vol->fd != -1);
+      CHECK(dir_probe(&key.hash, this->_vol, &result, &last_collision));
+    }
+    delete this;
+    return 0;
+  }
+
+private:
+  HTTPInfo info;
+  Vol *_vol = nullptr;
+};
+
+class CacheRecoveryInit : public CacheInit
+{
+public:
+  CacheRecoveryInit() {}
+  int
+  cache_init_success_callback(int event, void *e) override
+  {
+    CacheTestHandler *h = new CacheTestHandler(SMALL_FILE, "http://www.scw11.com");
+    CacheRestart *r     = new CacheRestart("http://www.scw11.com");
+    TerminalTest *tt    = new TerminalTest;
+    h->add(r);
+    h->add(tt);
+    this_ethread()->schedule_imm(h);
+    delete this;
+    return 0;
+  }
+};
+
+TEST_CASE("cache write -> restart -> probe", "cache")
+{
+  init_cache(256 * 1024 * 1024);
+  CacheRecoveryInit *init = new CacheRecoveryInit;
+
+  this_ethread()->schedule_imm(init);
+  this_thread()->execute();
+}
@@ -27,6 +27,7 @@
 #include "tscore/ink_platform.h"
 #include "tscore/ink_rand.h"
 #include "tscore/I_Version.h"
+#include "tscore/WorkStealingDeque.h"
 #include "I_Thread.h"
 #include "I_PriorityEventQueue.h"
 #include "I_ProtectedQueue.h"
@@ -114,6 +115,14 @@ public:
         This is required to unblock (wake up) the block created by calling @a cb.
     */
     virtual void signalActivity() = 0;
+    /** Handle any activity without blocking, to spin before blocking.
+        @return @c true if there was activity.
+    */
+    virtual bool
+    pollActivity()
+    {
+      return false;
+    }
 
     virtual ~LoopTailHandler() {}
   };
@@ -329,18 +338,41 @@ public:
   ProtectedQueue EventQueueExternal;
   PriorityEventQueue EventQueue;
 
+  /** Immediate events of this thread which idle threads of @a steal_group may run.
+      The thread runs the events that are still left one loop after they were offered.
+   */
+  WorkStealingDeque<Event, 1024> StealQueue;
+
   static constexpr int NO_ETHREAD_ID = -1;
   int id                             = NO_ETHREAD_ID;
   unsigned int event_types           = 0;
   bool is_event_type(EventType et);
   void set_event_type(EventType et);
 
+  static constexpr EventType NO_STEAL_GROUP = -1;
+  /// Thread group with work stealing this thread belongs to.
+  EventType steal_group = NO_STEAL_GROUP;
+  /// Set while the thread waits for activity, so busy threads of @a steal_group wake it.
+  std::atomic<bool> idle = false;
+
+  /// Time to spin for activity before blocking, adapted to the load up to @c thread_busy_poll_useconds.
+  ink_hrtime busy_poll_budget = 0;
+
+  /// NUMA arena index of the node the thread is bound to, -1 if it is not bound to a single node.
+  int numa_node = -1;
+
   // Private Interface
 
   void execute() override;
   void execute_regular();
   void process_queue(Que(Event, link) * NegativeQueue, int *ev_count, int *nq_count);
   void process_event(Event *e, int calling_code);
+  bool offer_event(Event *e);
+  void run_offered_event(Event *e);
+  bool steal_events(int *ev_count);
+  void wake_idle_thread();
+  bool busy_poll(ink_hrtime limit);
+  void busy_poll_woken(ink_hrtime waited, ink_hrtime timeout);
   void free_event(Event *e);
   LoopTailHandler *tail_cb = &DEFAULT_TAIL_HANDLER;
 
@@ -530,6 +562,32 @@ public:
     static constexpr ts_milliseconds API_HISTOGRAM_BUCKET_SIZE{1};
     Graph _api_timing; ///< Plugin API callout timings.
 
+    /// Timers of the event queue, updated by the queue itself.
+    TimerWheelStats _timers;
+    /// Timer statistics, in the order of the members of @c TimerWheelStats.
+    static constexpr unsigned N_TIMER_STATS = 3;
+    static char const *const TIMER_STAT_NAME[N_TIMER_STATS];
+
+    /// Work stealing counters, updated by this thread only.
+    struct Steals {
+      int64_t offered  = 0; ///< Events put in the steal queue.
+      int64_t taken    = 0; ///< Events taken from the steal queue of another thread.
+      int64_t searches = 0; ///< Searches of the other threads for events, instead of waiting.
+    } _steals;
+    /// Work stealing statistics, in the order of the members of @c Steals.
+    static constexpr unsigned N_STEAL_STATS = 3;
+    static char const *const STEAL_STAT_NAME[N_STEAL_STATS];
+
+    /// Busy poll counters, updated by this thread only.
+    struct BusyPoll {
+      int64_t spins   = 0; ///< Spins for activity before blocking.
+      int64_t hits    = 0; ///< Spins which found activity.
+      ink_hrtime time = 0; ///< Time spent spinning.
+    } _busy_poll;
+    /// Busy poll statistics, in the order of the members of @c BusyPoll.
+    static constexpr unsigned N_BUSY_POLL_STATS = 3;
+    static char const *const BUSY_POLL_STAT_NAME[N_BUSY_POLL_STATS];
+
     /// Data in the histogram needs to decay over time. To avoid races and locks the
     /// summarizing thread bumps this to indicate a decay is needed and doesn't update if
     /// this is non-zero. The event loop does the decay and decrements the count.
@@ -540,13 +598,55 @@ public:
     static inline ts_clock::time_point _last_decay_time;
 
     /// Total number of metric based statistics.
-    static constexpr unsigned N_STATS = N_SLICE_STATS + 2 * Graph::N_BUCKETS;
+    static constexpr unsigned N_STATS = N_SLICE_STATS + 2 * Graph::N_BUCKETS + N_TIMER_STATS + N_STEAL_STATS + N_BUSY_POLL_STATS;
 
     /// Summarize this instance into a global instance.
     void summarize(self_type &global);
   };
 
   Metrics metrics;
+
+  /** Recent event dispatches slower than @c thread_stall_threshold_mseconds.
+
+      A ring written by the thread only and read by any thread. An entry is skipped by readers if
+      the thread writes it while it is read.
+   */
+  struct StallLog {
+    /// A slow dispatch. It only refers to static data, the continuation may be gone.
+    struct Entry {
+      ink_hrtime start    = 0;       ///< Dispatch time.
+      ink_hrtime duration = 0;       ///< Time spent in the handler.
+      const char *type    = nullptr; ///< Mangled type name of the continuation.
+      const void *plugin  = nullptr; ///< Plugin event function, for plugin continuations.
+      const char *name    = nullptr; ///< @c SET_HANDLER name, debug builds only.
+      int event           = 0;       ///< Event code passed to the handler.
+    };
+
+    /// Find the plugin event function of a continuation, set by the API.
+    using PluginLookup = const void *(*)(const Continuation *c);
+    static inline PluginLookup plugin_lookup = nullptr;
+
+    static constexpr unsigned N_ENTRIES = 64;
+
+    /// Add @a entry, dropping the oldest one if the log is full. Thread only.
+    void record(Entry const &entry);
+    /// Entries recorded, oldest first.
+    std::vector<Entry> entries() const;
+    /// Number of entries ever recorded.
+    uint64_t
+    count() const
+    {
+      return _count.load(std::memory_order_acquire);
+    }
+
+  private:
+    struct Slot {
+      std::atomic<uint64_t> seq{0}; ///< Odd while written, else twice the entry number plus 2.
+      Entry entry;
+    };
+    std::array<Slot, N_ENTRIES> _slots;
+    std::atomic<uint64_t> _count{0};
+  } stalls;
 };
 
 // --- Inline implementation
@@ -642,3 +742,5 @@ operator new(size_t, ink_dummy_for_new *p)
 extern EThread *this_ethread();
 
 extern int thread_max_heartbeat_mseconds;
+extern int thread_stall_threshold_mseconds;
+extern int thread_busy_poll_useconds;
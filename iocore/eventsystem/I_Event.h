@@ -213,7 +213,8 @@ public:
   unsigned int in_the_priority_queue : 1;
   unsigned int immediate             : 1;
   unsigned int globally_allocated    : 1;
-  unsigned int in_heap               : 4;
+  unsigned int stealable             : 1; ///< Other threads of the group may run it, see @c EThread::StealQueue.
+  unsigned int in_heap               : 11; ///< Timer wheel slot, up to @c TimerWheelBase::NO_SLOT.
   int callback_event = 0;
 
   ink_hrtime timeout_at = 0;
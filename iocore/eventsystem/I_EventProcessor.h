@@ -295,6 +295,13 @@ public:
     Que(Event, link) _spawnQueue;                    ///< Events to dispatch when thread is spawned.
     EThread *_thread[MAX_THREADS_IN_EACH_TYPE] = {}; ///< The actual threads in this group.
     std::function<void()> _afterStartCallback  = nullptr;
+    /// Whether idle threads of the group run the immediate events of busy ones. Must be set
+    /// before the threads are spawned.
+    enum Stealing {
+      STEAL_NONE,    ///< Events run on the thread they are scheduled on.
+      STEAL_UNBOUND, ///< Events of continuations without thread affinity.
+      STEAL_ALL,     ///< All immediate events.
+    } _stealing = STEAL_NONE;
   };
 
   /// Storage for per group data.
@@ -319,6 +326,8 @@ public:
 
   Event *schedule(Event *e, EventType etype);
   EThread *assign_thread(EventType etype);
+  /// Assign a thread of @a etype bound to NUMA @a node, or any thread of @a etype if none is.
+  EThread *assign_thread(EventType etype, int node);
   EThread *assign_affinity_by_type(Continuation *cont, EventType etype);
 
   EThread *all_dthreads[MAX_EVENT_THREADS];
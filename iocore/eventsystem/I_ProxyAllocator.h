@@ -35,6 +35,7 @@
 
 #include "tscore/ink_platform.h"
 #include "tscore/Allocator.h"
+#include "tscore/numa.h"
 
 class EThread;
 
@@ -42,6 +43,12 @@ extern int thread_freelist_high_watermark;
 extern int thread_freelist_low_watermark;
 extern int cmd_disable_pfreelist;
 
+/** Per thread cache of free objects of one allocator.
+
+    Past @c thread_freelist_high_watermark objects, all but @c thread_freelist_low_watermark are
+    handed as a magazine to the depot of the allocator, and an empty cache is refilled with a
+    magazine from there. The allocator free pool is used only when the depot is full or empty.
+ */
 struct ProxyAllocator {
   int allocated  = 0;
   void *freelist = nullptr;
@@ -49,11 +56,13 @@ struct ProxyAllocator {
   ProxyAllocator() {}
 };
 
+bool thread_refill(Allocator &a, ProxyAllocator &l);
+
 template <class CAlloc, typename... Args>
 typename CAlloc::Value_type *
 thread_alloc(CAlloc &a, ProxyAllocator &l, Args &&...args)
 {
-  if (!cmd_disable_pfreelist && l.freelist) {
+  if (!cmd_disable_pfreelist && (l.freelist || thread_refill(a.raw(), l))) {
     void *v    = l.freelist;
     l.freelist = *reinterpret_cast<void **>(l.freelist);
     --(l.allocated);
@@ -83,10 +92,11 @@ void thread_freeup(Allocator &a, ProxyAllocator &l);
 
 #endif
 
+// Items from the NUMA arena of another node skip the thread cache and go back to their own node.
 #define THREAD_FREE(_p, _a, _tin)                                                                  \
   do {                                                                                             \
     ::_a.destroy_if_enabled(_p);                                                                   \
-    if (!cmd_disable_pfreelist) {                                                                  \
+    if (!cmd_disable_pfreelist && !ats_numa_remote(_p)) {                                          \
       Thread *_t      = (_tin);                                                                    \
       *(char **)_p    = (char *)_t->_a.freelist;                                                   \
       _t->_a.freelist = _p;                                                                        \
@@ -23,42 +23,16 @@
 
 #include "P_EventSystem.h"
 
-PriorityEventQueue::PriorityEventQueue()
-{
-  last_check_time    = ink_get_hrtime();
-  last_check_buckets = last_check_time / PQ_BUCKET_TIME(0);
-}
-
 void
 PriorityEventQueue::check_ready(ink_hrtime now, EThread *t)
 {
-  int i, j, k = 0;
-  uint32_t check_buckets  = static_cast<uint32_t>(now / PQ_BUCKET_TIME(0));
-  uint32_t todo_buckets   = check_buckets ^ last_check_buckets;
-  last_check_time         = now;
-  last_check_buckets      = check_buckets;
-  todo_buckets           &= ((1 << (N_PQ_LIST - 1)) - 1);
-  while (todo_buckets) {
-    k++;
-    todo_buckets >>= 1;
-  }
-  for (i = 1; i <= k; i++) {
-    Event *e;
-    Que(Event, link) q = after[i];
-    after[i].clear();
-    while ((e = q.dequeue()) != nullptr) {
-      if (e->cancelled) {
-        e->in_the_priority_queue = 0;
-        e->cancelled             = 0;
-        EVENT_FREE(e, eventAllocator, t);
-      } else {
-        ink_hrtime tt = e->timeout_at - now;
-        for (j = i; j > 0 && tt <= PQ_BUCKET_TIME(j - 1);) {
-          j--;
-        }
-        e->in_heap = j;
-        after[j].enqueue(e);
-      }
+  wheel.advance(now, [t](Event *e) {
+    if (e->cancelled) {
+      e->in_the_priority_queue = 0;
+      e->cancelled             = 0;
+      EVENT_FREE(e, eventAllocator, t);
+      return true;
     }
-  }
+    return false;
+  });
 }
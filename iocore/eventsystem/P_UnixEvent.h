@@ -31,6 +31,7 @@ Event::init(Continuation *c, ink_hrtime atimeout_at, ink_hrtime aperiod)
   period       = aperiod;
   immediate    = !period && !atimeout_at;
   cancelled    = false;
+  stealable    = false;
   return this;
 }
 
@@ -42,6 +43,12 @@ Event::free()
 }
 
 TS_INLINE
-Event::Event() : in_the_prot_queue(false), in_the_priority_queue(false), immediate(false), globally_allocated(true), in_heap(false)
+Event::Event()
+  : in_the_prot_queue(false),
+    in_the_priority_queue(false),
+    immediate(false),
+    globally_allocated(true),
+    stealable(false),
+    in_heap(TimerWheelBase::NO_SLOT)
 {
 }
@@ -63,6 +63,24 @@ EventProcessor::assign_thread(EventType etype)
   return tg->_thread[next];
 }
 
+TS_INLINE EThread *
+EventProcessor::assign_thread(EventType etype, int node)
+{
+  ThreadGroupDescriptor *tg = &thread_group[etype];
+
+  ink_assert(etype < MAX_EVENT_TYPES);
+  if (node >= 0) {
+    // Round robin, skipping the threads of other nodes.
+    for (int i = 0; i < tg->_count; ++i) {
+      EThread *t = tg->_thread[++tg->_next_round_robin % tg->_count];
+      if (t->numa_node == node) {
+        return t;
+      }
+    }
+  }
+  return assign_thread(etype);
+}
+
 // If thread_holding is the correct type, return it.
 //
 // Otherwise check if there is already an affinity associated with the continuation,
@@ -99,6 +117,12 @@ EventProcessor::schedule(Event *e, EventType etype)
 
   EThread *affinity_thread = e->continuation->getThreadAffinity();
   EThread *curr_thread     = this_ethread();
+
+  // Only immediate events, which are not kept track of by time, may move to another thread.
+  if (auto stealing = thread_group[etype]._stealing; stealing != ThreadGroupDescriptor::STEAL_NONE && e->immediate) {
+    e->stealable = stealing == ThreadGroupDescriptor::STEAL_ALL || affinity_thread == nullptr;
+  }
+
   if (affinity_thread != nullptr && affinity_thread->is_event_type(etype)) {
     e->ethread = affinity_thread;
   } else {
@@ -26,10 +26,24 @@ int thread_freelist_high_watermark = 512;
 int thread_freelist_low_watermark  = 32;
 extern int cmd_disable_pfreelist;
 
+bool
+thread_refill(Allocator &a, ProxyAllocator &l)
+{
+  void *head;
+  int count;
+
+  if (a.depot.get(head, count)) {
+    l.freelist   = head;
+    l.allocated += count;
+    return true;
+  }
+  return false;
+}
+
 void *
 thread_alloc(Allocator &a, ProxyAllocator &l)
 {
-  if (!cmd_disable_pfreelist && l.freelist) {
+  if (!cmd_disable_pfreelist && (l.freelist || thread_refill(a, l))) {
     void *v    = l.freelist;
     l.freelist = *static_cast<void **>(l.freelist);
     --(l.allocated);
@@ -54,7 +68,10 @@ thread_freeup(Allocator &a, ProxyAllocator &l)
   if (unlikely(count == 1)) {
     a.free_void(tail);
   } else if (count > 0) {
-    a.free_void_bulk(head, tail, count);
+    *static_cast<void **>(tail) = nullptr;
+    if (!a.depot.put(head, count)) {
+      a.free_void_bulk(head, tail, count);
+    }
   }
 
   ink_assert(l.allocated >= thread_freelist_low_watermark);
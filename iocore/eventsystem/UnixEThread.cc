@@ -48,7 +48,41 @@ char const *const EThread::Metrics::Slice::STAT_NAME[] = {
   "proxy.process.eventloop.events.max", "proxy.process.eventloop.wait",   "proxy.process.eventloop.time.min",
   "proxy.process.eventloop.time.max"};
 
-int thread_max_heartbeat_mseconds = THREAD_MAX_HEARTBEAT_MSECONDS;
+// !! THIS MUST BE IN THE TimerWheelStats ORDER !!
+char const *const EThread::Metrics::TIMER_STAT_NAME[] = {"proxy.process.eventloop.timers", "proxy.process.eventloop.timers.expired",
+                                                         "proxy.process.eventloop.timers.lag"};
+
+// !! THIS MUST BE IN THE Steals ORDER !!
+char const *const EThread::Metrics::STEAL_STAT_NAME[] = {"proxy.process.eventloop.steal.offered", "proxy.process.eventloop.steal.taken",
+                                                         "proxy.process.eventloop.steal.searches"};
+
+// !! THIS MUST BE IN THE BusyPoll ORDER !!
+char const *const EThread::Metrics::BUSY_POLL_STAT_NAME[] = {
+  "proxy.process.eventloop.busy_poll.spins", "proxy.process.eventloop.busy_poll.hits", "proxy.process.eventloop.busy_poll.time"};
+
+namespace
+{
+/// Most events taken from other threads in a row, before checking the own queues again.
+constexpr int STEAL_BATCH = 16;
+
+/// Shortest busy poll, a budget backing off below this stops spinning until activity wakes the thread quickly again.
+constexpr ink_hrtime BUSY_POLL_MIN = HRTIME_USECONDS(2);
+
+/// Spin wait hint to the processor.
+inline void
+cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+} // namespace
+
+int thread_max_heartbeat_mseconds   = THREAD_MAX_HEARTBEAT_MSECONDS;
+int thread_stall_threshold_mseconds = 0;
+int thread_busy_poll_useconds       = 0;
 
 // To define a class inherits from Thread:
 //   1) Define an independent thread_local static member
@@ -79,6 +113,7 @@ EThread::EThread()
 EThread::EThread(ThreadType att, int anid) : id(anid), tt(att)
 {
   memset(thread_private, 0, PER_THREAD_DATA);
+  EventQueue.set_stats(&metrics._timers);
 #if HAVE_EVENTFD
   evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
   if (evfd < 0) {
@@ -147,7 +182,24 @@ EThread::process_event(Event *e, int calling_code)
     // Restore the client IP debugging flags
     set_cont_flags(e->continuation->control_flags);
 
-    e->continuation->handleEvent(calling_code, e);
+    if (ink_hrtime threshold = HRTIME_MSECONDS(thread_stall_threshold_mseconds); threshold > 0) {
+      // Identify the handler beforehand, it may destroy the continuation.
+      StallLog::Entry stall;
+      stall.type   = typeid(*e->continuation).name();
+      stall.plugin = StallLog::plugin_lookup ? StallLog::plugin_lookup(e->continuation) : nullptr;
+#ifdef DEBUG
+      stall.name = e->continuation->handler_name;
+#endif
+      stall.event = calling_code;
+      stall.start = ink_get_hrtime();
+      e->continuation->handleEvent(calling_code, e);
+      stall.duration = ink_get_hrtime() - stall.start;
+      if (stall.duration >= threshold) {
+        stalls.record(stall);
+      }
+    } else {
+      e->continuation->handleEvent(calling_code, e);
+    }
     ink_assert(!e->in_the_priority_queue);
     ink_assert(c_temp == e->continuation);
     MUTEX_RELEASE(lock);
@@ -170,6 +222,7 @@ void
 EThread::process_queue(Que(Event, link) * NegativeQueue, int *ev_count, int *nq_count)
 {
   Event *e;
+  bool offered = false;
 
   // Move events from the external thread safe queues to the local queue.
   EventQueueExternal.dequeue_external();
@@ -182,7 +235,11 @@ EThread::process_queue(Que(Event, link) * NegativeQueue, int *ev_count, int *nq_
       free_event(e);
     } else if (!e->timeout_at) { // IMMEDIATE
       ink_assert(e->period == 0);
-      process_event(e, e->callback_event);
+      if (e->stealable && offer_event(e)) {
+        offered = true;
+      } else {
+        process_event(e, e->callback_event);
+      }
     } else if (e->timeout_at > 0) { // INTERVAL
       EventQueue.enqueue(e, ink_get_hrtime());
     } else { // NEGATIVE
@@ -200,6 +257,159 @@ EThread::process_queue(Que(Event, link) * NegativeQueue, int *ev_count, int *nq_
     }
     ++(*nq_count);
   }
+
+  // The offered events stay in the steal queue until the next loop, which gives an idle thread time to take them.
+  if (offered) {
+    wake_idle_thread();
+  }
+}
+
+bool
+EThread::busy_poll(ink_hrtime limit)
+{
+  ink_hrtime const start = ink_get_hrtime();
+  ink_hrtime const spin  = std::min(limit, busy_poll_budget);
+  ink_hrtime now         = start;
+  bool active            = false;
+
+  ++metrics._busy_poll.spins;
+  do {
+    if (!INK_ATOMICLIST_EMPTY(EventQueueExternal.al) || tail_cb->pollActivity()) {
+      active = true;
+      break;
+    }
+    cpu_relax();
+    now = ink_get_hrtime();
+  } while (now - start < spin);
+  metrics._busy_poll.time += now - start;
+
+  if (active) {
+    ++metrics._busy_poll.hits;
+    busy_poll_budget = std::min(HRTIME_USECONDS(thread_busy_poll_useconds), 2 * busy_poll_budget);
+  } else if (spin == busy_poll_budget) {
+    // Idle for the whole budget, spin less next time.
+    busy_poll_budget = busy_poll_budget / 2 < BUSY_POLL_MIN ? 0 : busy_poll_budget / 2;
+  }
+  // Either way there is no point in blocking if the spin reached @a limit.
+  return active || spin == limit;
+}
+
+void
+EThread::busy_poll_woken(ink_hrtime waited, ink_hrtime timeout)
+{
+  ink_hrtime const max = HRTIME_USECONDS(thread_busy_poll_useconds);
+
+  // Woken by activity soon enough for a spin to have caught it.
+  if (waited < timeout && waited <= max) {
+    busy_poll_budget = std::min(max, std::max({2 * busy_poll_budget, waited, BUSY_POLL_MIN}));
+  }
+}
+
+void
+EThread::StallLog::record(Entry const &entry)
+{
+  uint64_t n = _count.load(std::memory_order_relaxed);
+  Slot &slot = _slots[n % N_ENTRIES];
+
+  slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.entry = entry;
+  slot.seq.store(2 * n + 2, std::memory_order_release);
+  _count.store(n + 1, std::memory_order_release);
+}
+
+std::vector<EThread::StallLog::Entry>
+EThread::StallLog::entries() const
+{
+  std::vector<Entry> result;
+  uint64_t count = this->count();
+
+  for (uint64_t n = count > N_ENTRIES ? count - N_ENTRIES : 0; n < count; ++n) {
+    Slot const &slot = _slots[n % N_ENTRIES];
+    uint64_t seq     = slot.seq.load(std::memory_order_acquire);
+    if (seq != 2 * n + 2) {
+      continue; // overwritten already
+    }
+    Entry entry = slot.entry;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) == seq) {
+      result.push_back(entry);
+    }
+  }
+  return result;
+}
+
+bool
+EThread::offer_event(Event *e)
+{
+  if (steal_group == NO_STEAL_GROUP) {
+    return false;
+  }
+  // As in the external queue, rescheduling the event before it runs only updates it.
+  e->in_the_prot_queue = 1;
+  if (!StealQueue.push(e)) {
+    e->in_the_prot_queue = 0;
+    return false;
+  }
+  ++metrics._steals.offered;
+  return true;
+}
+
+void
+EThread::run_offered_event(Event *e)
+{
+  e->ethread           = this;
+  e->in_the_prot_queue = 0;
+  if (e->cancelled) {
+    free_event(e);
+  } else if (!e->timeout_at) {
+    process_event(e, e->callback_event);
+  } else {
+    // Rescheduled after it was offered.
+    EventQueueExternal.enqueue_local(e);
+  }
+}
+
+bool
+EThread::steal_events(int *ev_count)
+{
+  EventProcessor::ThreadGroupDescriptor &tg = eventProcessor.thread_group[steal_group];
+  int taken                                 = 0;
+
+  ++metrics._steals.searches;
+  while (taken < STEAL_BATCH) {
+    Event *e  = nullptr;
+    int start = generator.random() % tg._count;
+    for (int i = 0; i < tg._count && e == nullptr; ++i) {
+      EThread *victim = tg._thread[(start + i) % tg._count];
+      if (victim != this) {
+        e = victim->StealQueue.steal();
+      }
+    }
+    if (e == nullptr) {
+      break;
+    }
+    ++taken;
+    ++(*ev_count);
+    ++metrics._steals.taken;
+    run_offered_event(e);
+  }
+  return taken > 0;
+}
+
+void
+EThread::wake_idle_thread()
+{
+  EventProcessor::ThreadGroupDescriptor &tg = eventProcessor.thread_group[steal_group];
+  int start                                 = generator.random() % tg._count;
+
+  for (int i = 0; i < tg._count; ++i) {
+    EThread *t = tg._thread[(start + i) % tg._count];
+    if (t != this && t->idle.load(std::memory_order_relaxed)) {
+      t->tail_cb->signalActivity();
+      return;
+    }
+  }
 }
 
 void
@@ -221,6 +431,9 @@ EThread::execute_regular()
   // A statically initialized instance we can use as a prototype for initializing other instances.
   static const Metrics::Slice SLICE_INIT;
 
+  // Start with the full busy poll, the loop backs off from it when idle.
+  busy_poll_budget = HRTIME_USECONDS(thread_busy_poll_useconds);
+
   // give priority to immediate events
   while (!TSSystemState::is_event_system_shut_down()) {
     loop_start_time = ink_get_hrtime();
@@ -238,6 +451,9 @@ EThread::execute_regular()
     }
     ++(metrics.current_slice->_count); // loop started, bump count.
 
+    // Offered events still in the steal queue were not taken by an idle thread during a whole loop.
+    size_t stale_offers = StealQueue.size();
+
     process_queue(&NegativeQueue, &ev_count, &nq_count);
 
     bool done_one;
@@ -267,8 +483,28 @@ EThread::execute_regular()
       }
     }
 
-    next_time             = EventQueue.earliest_timeout();
+    // Run the stale offered events, oldest first. A failed steal means another thread took one.
+    for (; stale_offers > 0 && !StealQueue.empty(); --stale_offers) {
+      if (Event *o = StealQueue.steal()) {
+        run_offered_event(o);
+      }
+    }
+
+    next_time = EventQueue.earliest_timeout();
+    // Offered events not taken by the next loop are run by this thread, don't wait for them.
+    if (!StealQueue.empty()) {
+      next_time = 0;
+    }
+    // Rather than wait, run the events offered by busy threads of the group.
+    if (steal_group != NO_STEAL_GROUP && EventQueueExternal.localQueue.empty() && next_time > ink_get_hrtime() &&
+        steal_events(&ev_count)) {
+      next_time = 0;
+    }
     ink_hrtime sleep_time = next_time - ink_get_hrtime();
+    // Spin a while for activity, rather than pay for a wake up.
+    if (sleep_time > 0 && busy_poll_budget > 0 && busy_poll(sleep_time)) {
+      sleep_time = 0;
+    }
     if (sleep_time > 0) {
       if (EventQueueExternal.localQueue.empty()) {
         sleep_time = std::min(sleep_time, HRTIME_MSECONDS(thread_max_heartbeat_mseconds));
@@ -282,10 +518,16 @@ EThread::execute_regular()
       sleep_time = 0;
     }
 
+    idle.store(sleep_time > 0, std::memory_order_relaxed);
+    ink_hrtime wait_start = thread_busy_poll_useconds > 0 ? ink_get_hrtime() : 0;
     tail_cb->waitForActivity(sleep_time);
+    idle.store(false, std::memory_order_relaxed);
 
     // loop cleanup
     loop_finish_time = ink_get_hrtime();
+    if (wait_start && sleep_time > 0) {
+      busy_poll_woken(loop_finish_time - wait_start, sleep_time);
+    }
     // @a delta can be negative due to time of day adjustments (which apparently happen quite frequently). I
     // tried using the monotonic clock to get around this but it was *very* stuttery (up to hundreds
     // of milliseconds), far too much to be actually used.
@@ -388,4 +630,9 @@ EThread::Metrics::summarize(Metrics &global)
     global._loop_timing += _loop_timing;
     global._api_timing  += _api_timing;
   }
+
+  // Counters only grow or are a current value, no need to back up.
+  global._timers.timers  += _timers.timers;
+  global._timers.expired += _timers.expired;
+  global._timers.lag     += _timers.lag;
 }
@@ -32,6 +32,7 @@
 #include "tscore/ink_defs.h"
 #include "tscore/ink_hw.h"
 #include "tscore/hugepages.h"
+#include "tscore/numa.h"
 
 namespace
 {
@@ -127,13 +128,39 @@ EventMetricStatSync(const char *, RecDataT, RecData *, RecRawStatBlock *rsb, int
     RecRawStatUpdateSum(rsb, id);
   }
 
-  // Last are the plugin API histogram buckets.
+  // Next are the plugin API histogram buckets.
   for (Graph::raw_type idx = 0; idx < Graph::N_BUCKETS; ++idx, ++id) {
     rsb->global[id]->sum   = summary._api_timing[idx];
     rsb->global[id]->count = 1;
     RecRawStatUpdateSum(rsb, id);
   }
 
+  // Next are the event queue timers.
+  for (int64_t value : {summary._timers.timers, summary._timers.expired, summary._timers.lag}) {
+    rsb->global[id]->sum   = value;
+    rsb->global[id]->count = 1;
+    RecRawStatUpdateSum(rsb, id++);
+  }
+
+  // Last are the work stealing and busy poll counters, of all the thread groups.
+  EThread::Metrics::Steals steals;
+  EThread::Metrics::BusyPoll busy_poll;
+  for (int group = 0; group < eventProcessor.n_thread_groups; ++group) {
+    for (EThread *t : eventProcessor.active_group_threads(group)) {
+      steals.offered  += t->metrics._steals.offered;
+      steals.taken    += t->metrics._steals.taken;
+      steals.searches += t->metrics._steals.searches;
+      busy_poll.spins += t->metrics._busy_poll.spins;
+      busy_poll.hits  += t->metrics._busy_poll.hits;
+      busy_poll.time  += t->metrics._busy_poll.time;
+    }
+  }
+  for (int64_t value : {steals.offered, steals.taken, steals.searches, busy_poll.spins, busy_poll.hits, busy_poll.time}) {
+    rsb->global[id]->sum   = value;
+    rsb->global[id]->count = 1;
+    RecRawStatUpdateSum(rsb, id++);
+  }
+
   // Check if it's time to schedule a decay of the histogram data.
   // Done here so that it's (roughly) synchronized across the ET_NET threads.
   // The decay is done in the local threads, this bumps a counter to indicate it should be done.
@@ -275,6 +302,15 @@ ThreadAffinityInitializer::set_affinity(int, Event *)
     Dbg(dbg_ctl_iocore_thread, "EThread: %d %s: %d", _name, obj->logical_index);
 #endif // HWLOC_API_VERSION
     hwloc_set_thread_cpubind(ink_get_topology(), t->tid, obj->cpuset, HWLOC_CPUBIND_STRICT);
+
+    // A thread confined to one NUMA node allocates from, and is handed connections of, that node.
+    for (int node = 0; node < ats_numa_node_count(); ++node) {
+      if (hwloc_bitmap_isincluded(obj->cpuset, hwloc_get_obj_by_type(ink_get_topology(), HWLOC_OBJ_NODE, node)->cpuset)) {
+        t->numa_node = ats_numa_thread_node = node;
+        Dbg(dbg_ctl_iocore_thread, "EThread: %p NUMA arena: %d", t, node);
+        break;
+      }
+    }
   } else {
     Warning("hwloc returned an unexpected number of objects -- CPU affinity disabled");
   }
@@ -451,6 +487,9 @@ EventProcessor::spawn_event_threads(EventType ev_type, int n_threads, size_t sta
     tg->_thread[i]               = t;
     t->id                        = i; // unfortunately needed to support affinity and NUMA logic.
     t->set_event_type(ev_type);
+    if (tg->_stealing != ThreadGroupDescriptor::STEAL_NONE) {
+      t->steal_group = ev_type;
+    }
     t->schedule_spawn(&thread_initializer);
   }
   tg->_count  = n_threads;
@@ -542,6 +581,21 @@ EventProcessor::start(int n_event_threads, size_t stacksize)
     RecRegisterRawStat(rsb, RECT_PROCESS, name, RECD_INT, RECP_NON_PERSISTENT, stat_idx++, NULL);
   }
 
+  // event queue timers
+  for (char const *timer_name : EThread::Metrics::TIMER_STAT_NAME) {
+    RecRegisterRawStat(rsb, RECT_PROCESS, timer_name, RECD_INT, RECP_NON_PERSISTENT, stat_idx++, NULL);
+  }
+
+  // work stealing
+  for (char const *steal_name : EThread::Metrics::STEAL_STAT_NAME) {
+    RecRegisterRawStat(rsb, RECT_PROCESS, steal_name, RECD_INT, RECP_NON_PERSISTENT, stat_idx++, NULL);
+  }
+
+  // busy poll
+  for (char const *busy_poll_name : EThread::Metrics::BUSY_POLL_STAT_NAME) {
+    RecRegisterRawStat(rsb, RECT_PROCESS, busy_poll_name, RECD_INT, RECP_NON_PERSISTENT, stat_idx++, NULL);
+  }
+
   // Name must be that of a stat, pick one at random since we do all of them in one pass/callback.
   RecRegisterRawStatSyncCb(name, EventMetricStatSync, rsb, 0);
 
@@ -31,6 +31,12 @@
 
 #include "diags.i"
 
+#include <chrono>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+
 #define TEST_TIME_SECOND 60
 #define TEST_THREADS     2
 
@@ -81,6 +87,107 @@ TEST_CASE("EventSystem", "[iocore]")
   }
 }
 
+TEST_CASE("EventProcessor assign_thread by NUMA node", "[iocore][numa]")
+{
+  EventProcessor::ThreadGroupDescriptor &tg = eventProcessor.thread_group[ET_CALL];
+  REQUIRE(tg._count == TEST_THREADS);
+
+  for (int i = 0; i < tg._count; ++i) {
+    tg._thread[i]->numa_node = i;
+  }
+  for (int i = 0; i < 4 * TEST_THREADS; ++i) {
+    CHECK(eventProcessor.assign_thread(ET_CALL, 1) == tg._thread[1]);
+    CHECK(eventProcessor.assign_thread(ET_CALL, 0) == tg._thread[0]);
+  }
+
+  // No thread on the node, or no node, round robins over the whole group.
+  EThread *first = eventProcessor.assign_thread(ET_CALL, TEST_THREADS);
+  CHECK(eventProcessor.assign_thread(ET_CALL, -1) != first);
+
+  for (int i = 0; i < tg._count; ++i) {
+    tg._thread[i]->numa_node = -1;
+  }
+}
+
+TEST_CASE("EThread StallLog", "[iocore][stalls]")
+{
+  struct sleeper : public Continuation {
+    sleeper(ProxyMutex *m, int msec) : Continuation(m), msec(msec) { SET_HANDLER(&sleeper::sleep_function); }
+
+    int
+    sleep_function(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(msec));
+      return 0;
+    }
+
+    int msec;
+  };
+
+  SECTION("threshold")
+  {
+    EThread *t    = this_ethread();
+    auto dispatch = [t](Continuation *c) {
+      Event *e = EVENT_ALLOC(eventAllocator, t);
+      e->init(c);
+      e->mutex = c->mutex;
+      t->process_event(e, EVENT_IMMEDIATE);
+    };
+    sleeper slow{new_ProxyMutex(), 30};
+    sleeper fast{new_ProxyMutex(), 0};
+    uint64_t count = t->stalls.count();
+
+    // Not recorded while disabled.
+    thread_stall_threshold_mseconds = 0;
+    dispatch(&slow);
+    CHECK(t->stalls.count() == count);
+
+    thread_stall_threshold_mseconds = 20;
+    dispatch(&fast);
+    CHECK(t->stalls.count() == count);
+    dispatch(&slow);
+    thread_stall_threshold_mseconds = 0;
+    REQUIRE(t->stalls.count() == count + 1);
+
+    EThread::StallLog::Entry entry = t->stalls.entries().back();
+    CHECK(entry.duration >= HRTIME_MSECONDS(20));
+    CHECK(std::string_view{entry.type} == typeid(sleeper).name());
+    CHECK(entry.event == EVENT_IMMEDIATE);
+    CHECK(entry.plugin == nullptr);
+  }
+
+  SECTION("ring wrap")
+  {
+    auto log    = std::make_unique<EThread::StallLog>();
+    auto record = [&](int event) {
+      EThread::StallLog::Entry entry;
+      entry.event = event;
+      log->record(entry);
+    };
+    constexpr int N = EThread::StallLog::N_ENTRIES;
+
+    CHECK(log->entries().empty());
+    for (int i = 0; i < 3; ++i) {
+      record(i);
+    }
+    auto entries = log->entries();
+    REQUIRE(entries.size() == 3);
+    CHECK(entries.front().event == 0);
+    CHECK(entries.back().event == 2);
+
+    // Full, the oldest ones are dropped.
+    for (int i = 3; i < N + 10; ++i) {
+      record(i);
+    }
+    CHECK(log->count() == N + 10);
+    entries = log->entries();
+    REQUIRE(entries.size() == N);
+    for (int i = 0; i < N; ++i) {
+      CHECK(entries[i].event == i + 10);
+    }
+  }
+}
+
 struct EventProcessorListener : Catch::TestEventListenerBase {
   using TestEventListenerBase::TestEventListenerBase;
 
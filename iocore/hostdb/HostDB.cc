@@ -594,6 +594,7 @@ reply_to_cont(Continuation *cont, HostDBRecord *r, bool is_srv = false)
       ink_assert(!"missing hostname");
       cont->handleEvent(is_srv ? EVENT_SRV_LOOKUP : EVENT_HOST_DB_LOOKUP, nullptr);
       Warning("bogus entry deleted from HostDB: missing hostname");
+      std::unique_lock<ts::shared_mutex> lock{hostDB.refcountcache->lock_for_key(r->key)};
       hostDB.refcountcache->erase(r->key);
       return false;
     }
@@ -652,28 +653,21 @@ probe(HostDBHash const &hash, bool ignore_timeout)
   }
 
   // Otherwise HostDB is enabled, so we'll do our thing
-  uint64_t folded_hash          = hash.hash.fold();
-  ts::shared_mutex &bucket_lock = hostDB.refcountcache->lock_for_key(folded_hash);
-
-  Ptr<HostDBRecord> record;
-  {
-    std::shared_lock<ts::shared_mutex> lock{bucket_lock};
-
-    // get the record from cache
-    record = hostDB.refcountcache->get(folded_hash);
-    // If there was nothing in the cache-- this is a miss
-    if (record.get() == nullptr) {
-      return record;
-    }
+  // get the record from cache, this takes no lock: records are never changed once in the cache,
+  // an update puts a new record in place of the old one
+  Ptr<HostDBRecord> record = hostDB.refcountcache->get(hash.hash.fold());
+  // If there was nothing in the cache-- this is a miss
+  if (record.get() == nullptr) {
+    return record;
+  }
 
-    // If the dns response was failed, and we've hit the failed timeout, lets stop returning it
-    if (record->is_failed() && record->is_ip_fail_timeout()) {
-      return NO_RECORD;
-      // if we aren't ignoring timeouts, and we are past it-- then remove the record
-    } else if (!ignore_timeout && record->is_ip_timeout() && !record->serve_stale_but_revalidate()) {
-      HOSTDB_INCREMENT_DYN_STAT_THREAD(hostdb_ttl_expires_stat, this_ethread());
-      return NO_RECORD;
-    }
+  // If the dns response was failed, and we've hit the failed timeout, lets stop returning it
+  if (record->is_failed() && record->is_ip_fail_timeout()) {
+    return NO_RECORD;
+    // if we aren't ignoring timeouts, and we are past it-- then remove the record
+  } else if (!ignore_timeout && record->is_ip_timeout() && !record->serve_stale_but_revalidate()) {
+    HOSTDB_INCREMENT_DYN_STAT_THREAD(hostdb_ttl_expires_stat, this_ethread());
+    return NO_RECORD;
   }
 
   // If the record is stale, but we want to revalidate-- lets start that up
@@ -744,12 +738,9 @@ HostDBProcessor::getby(Continuation *cont, cb_process_result_pfn cb_process_resu
     bool loop = lock.is_locked();
     while (loop) {
       loop = false; // Only loop on explicit set for retry.
-      // find the partition lock
-      ts::shared_mutex &bucket_lock = hostDB.refcountcache->lock_for_key(hash.hash.fold());
 
-      // If we can get the lock and a level 1 probe succeeds, return
+      // If a level 1 probe succeeds, return
       HostDBRecord::Handle r = probe(hash, false);
-      std::shared_lock<ts::shared_mutex> lock{bucket_lock};
       if (r) {
         // fail, see if we should retry with alternate
         if (hash.db_mark != HOSTDB_MARK_SRV && r->is_failed() && hash.host_name) {
@@ -1077,6 +1068,7 @@ HostDBContinuation::dnsEvent(int event, HostEnt *e)
     Ptr<HostDBRecord> old_r = probe(hash, false);
     // If the DNS lookup failed with NXDOMAIN, remove the old record
     if (e && e->isNameError() && old_r) {
+      std::unique_lock<ts::shared_mutex> lock{hostDB.refcountcache->lock_for_key(old_r->key)};
       hostDB.refcountcache->erase(old_r->key);
       old_r = nullptr;
       Dbg(dbg_ctl_hostdb, "Removing the old record when the DNS lookup failed with NXDOMAIN");
@@ -34,7 +34,9 @@
 
 #include "tscore/I_Version.h"
 #include "tscpp/util/TsSharedMutex.h"
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <unistd.h>
 
 #define REFCOUNT_CACHE_EVENT_SYNC REFCOUNT_CACHE_EVENT_EVENTS_START
@@ -156,14 +158,83 @@ protected:
   inline static DbgCtl dbg_ctl{"refcountcache"};
 };
 
+// Epoch based reclamation for the lock free read path of the partitions.
+//
+// While a reader walks a partition it announces the global epoch in a slot of its own, and it
+// clears the slot when done, so a read never writes a cache line another thread writes. A writer
+// that unlinks a node ends the current epoch, stamps the node with it, and frees the node once
+// every reader still inside a read has announced a later epoch.
+class RefCountCacheEpoch
+{
+  struct alignas(64) Reader {
+    std::atomic<uint64_t> epoch{0}; // epoch announced by the current read, 0 outside of a read
+    unsigned depth = 0;             // nesting of ReadGuards, only used by the owning thread
+    Reader *next   = nullptr;
+  };
+
+public:
+  // A read of the partitions, which may be nested.
+  class ReadGuard
+  {
+  public:
+    ReadGuard() : reader(RefCountCacheEpoch::reader())
+    {
+      if (reader.depth++ == 0) {
+        reader.epoch.store(global_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+        // the announcement must be visible before the partition is read
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+      }
+    }
+
+    ~ReadGuard()
+    {
+      if (--reader.depth == 0) {
+        reader.epoch.store(0, std::memory_order_release);
+      }
+    }
+
+    // noncopyable
+    ReadGuard(const ReadGuard &)            = delete;
+    ReadGuard &operator=(const ReadGuard &) = delete;
+
+  private:
+    Reader &reader;
+  };
+
+  // End the current epoch after unlinking nodes, returns the epoch to stamp them with.
+  static uint64_t advance();
+  // The oldest epoch announced by a reader, a node stamped with an older epoch can be freed.
+  static uint64_t oldest_reader();
+
+private:
+  static Reader &
+  reader()
+  {
+    thread_local Reader *r = add_reader();
+    return *r;
+  }
+
+  // The slots are never freed, a thread that exits leaves an idle one behind.
+  static Reader *add_reader();
+
+  static std::atomic<uint64_t> global_epoch;
+  static std::atomic<Reader *> readers;
+};
+
 // The RefCountCachePartition is simply a map of key -> Ptr<YourClass>
 // We partition the cache to reduce lock contention
+//
+// Writers (put, erase, clear) must hold the partition lock exclusively, get() needs no lock. Next to
+// the item map, which the writers, iteration and persistence use, each partition keeps a read
+// index: a chained hash table of immutable nodes that writers publish with release stores and
+// retire through RefCountCacheEpoch, and that get() walks without any lock or shared write.
 template <class C> class RefCountCachePartition : private RefCountCacheBase
 {
 public:
   using hash_type = swoc::IntrusiveHashMap<RefCountCacheLinkage>;
 
   RefCountCachePartition(unsigned int part_num, uint64_t max_size, unsigned int max_items, RecRawStatBlock *rsb = nullptr);
+  ~RefCountCachePartition();
   Ptr<C> get(uint64_t key);
   void put(uint64_t key, C *item, int size = 0, int expire_time = 0);
   void erase(uint64_t key, ink_time_t expiry_time = -1);
@@ -176,12 +247,60 @@ public:
   size_t count() const;
   void copy(std::vector<RefCountCacheHashEntry *> &items);
 
+  // Free what no reader can hold anymore, or everything if @a all. Writers reclaim as they go, the
+  // periodic sync reclaims for the partitions that are not written to. Needs the lock exclusively.
+  void reclaim(bool all = false);
+  size_t retired_count() const;
+
   hash_type &get_map();
 
   ts::shared_mutex lock;
 
 private:
+  // The item map holds the reference to the item, a node takes its own only when it is retired
+  struct ReadNode {
+    uint64_t key;
+    C *item;
+    Ptr<C> retired_item;
+    std::atomic<ReadNode *> next{nullptr};
+  };
+
+  struct ReadTable {
+    unsigned int shift; // 64 - log2 of the bucket count
+    std::unique_ptr<std::atomic<ReadNode *>[]> buckets;
+
+    explicit ReadTable(unsigned int bits) : shift(64 - bits), buckets(new std::atomic<ReadNode *>[size_t(1) << bits]()) {}
+
+    size_t
+    bucket_count() const
+    {
+      return size_t(1) << (64 - shift);
+    }
+
+    std::atomic<ReadNode *> &
+    bucket(uint64_t key)
+    {
+      // the keys of a partition share their low bits, so spread them with a multiplicative hash
+      return buckets[(key * 0x9e3779b97f4a7c15ULL) >> shift];
+    }
+  };
+
+  // A node or a whole table unlinked in epoch
+  struct Retired {
+    uint64_t epoch;
+    ReadNode *node;
+    ReadTable *table;
+  };
+
   void metric_inc(RefCountCache_Stats metric_enum, int64_t data);
+  void metric_inc_local(RefCountCache_Stats metric_enum, int64_t data);
+
+  void read_insert(uint64_t key, C *item);
+  void read_erase(uint64_t key);
+  void read_clear();
+  void read_resize(unsigned int bits);
+  void retire(ReadNode *node, ReadTable *table);
+  static void free_table(ReadTable *table);
 
   unsigned int part_num;
   uint64_t max_size;
@@ -191,6 +310,9 @@ private:
 
   hash_type item_map;
 
+  std::atomic<ReadTable *> read_table{nullptr};
+  std::vector<Retired> retired;
+
   PriorityQueue<RefCountCacheHashEntry *> expiry_queue;
   RecRawStatBlock *rsb;
 };
@@ -200,20 +322,38 @@ RefCountCachePartition<C>::RefCountCachePartition(unsigned int part_num, uint64_
                                                   RecRawStatBlock *rsb)
   : part_num(part_num), max_size(max_size), max_items(max_items), size(0), items(0), rsb(rsb)
 {
+  // size the read index for the item limit, up to 64K buckets, it grows past that if needed
+  unsigned int bits = 6;
+  while (bits < 16 && (size_t(1) << bits) < max_items) {
+    ++bits;
+  }
+  this->read_table.store(new ReadTable(bits), std::memory_order_release);
+}
+
+// No reader may be left when a partition is destroyed
+template <class C> RefCountCachePartition<C>::~RefCountCachePartition()
+{
+  this->clear();
+  this->reclaim(true);
+  free_table(this->read_table.load(std::memory_order_relaxed));
 }
 
 template <class C>
 Ptr<C>
 RefCountCachePartition<C>::get(uint64_t key)
 {
-  this->metric_inc(refcountcache_total_lookups_stat, 1);
-  if (auto it = this->item_map.find(key); it != this->item_map.end()) {
-    // found
-    this->metric_inc(refcountcache_total_hits_stat, 1);
-    return make_ptr(static_cast<C *>(it->item.get()));
-  } else {
-    return Ptr<C>();
+  this->metric_inc_local(refcountcache_total_lookups_stat, 1);
+
+  RefCountCacheEpoch::ReadGuard guard;
+  ReadTable *table = this->read_table.load(std::memory_order_acquire);
+  for (ReadNode *n = table->bucket(key).load(std::memory_order_acquire); n; n = n->next.load(std::memory_order_acquire)) {
+    if (n->key == key) {
+      // found
+      this->metric_inc_local(refcountcache_total_hits_stat, 1);
+      return make_ptr(n->item);
+    }
   }
+  return Ptr<C>();
 }
 
 template <class C>
@@ -247,10 +387,13 @@ RefCountCachePartition<C>::put(uint64_t key, C *item, int size, int expire_time)
 
   // add the item to the map
   this->item_map.insert(val);
+  this->read_insert(key, item);
   this->size += val->meta.size;
   this->items++;
   this->metric_inc(refcountcache_current_size_stat, (int64_t)val->meta.size);
   this->metric_inc(refcountcache_current_items_stat, 1);
+
+  this->reclaim();
 }
 
 template <class C>
@@ -262,7 +405,9 @@ RefCountCachePartition<C>::erase(uint64_t key, ink_time_t expiry_time)
       return;
     }
     this->item_map.erase(it);
+    this->read_erase(key);
     this->dealloc_entry(it);
+    this->reclaim();
   }
 }
 
@@ -297,6 +442,7 @@ RefCountCachePartition<C>::clear()
   // Since the hash nodes embed the list pointers, you can't iterate over the
   // hash elements and deallocate them, let alone remove them from the hash.
   // Hence, this monstrosity.
+  this->read_clear();
   auto it = this->item_map.begin();
   while (it != this->item_map.end()) {
     auto cur = it++;
@@ -304,6 +450,7 @@ RefCountCachePartition<C>::clear()
     this->item_map.erase(cur);
     this->dealloc_entry(cur);
   }
+  this->reclaim();
 }
 
 // Are we full?
@@ -366,6 +513,20 @@ RefCountCachePartition<C>::metric_inc(RefCountCache_Stats metric_enum, int64_t d
   }
 }
 
+// Count on the calling thread's stats, so that readers do not share a counter
+template <class C>
+void
+RefCountCachePartition<C>::metric_inc_local(RefCountCache_Stats metric_enum, int64_t data)
+{
+  if (this->rsb) {
+    if (EThread *thread = this_ethread(); thread) {
+      RecIncrRawStatCount(this->rsb, thread, metric_enum, data);
+    } else {
+      RecIncrGlobalRawStatCount(this->rsb, metric_enum, data);
+    }
+  }
+}
+
 template <class C>
 swoc::IntrusiveHashMap<RefCountCacheLinkage> &
 RefCountCachePartition<C>::get_map()
@@ -373,6 +534,133 @@ RefCountCachePartition<C>::get_map()
   return this->item_map;
 }
 
+template <class C>
+void
+RefCountCachePartition<C>::read_insert(uint64_t key, C *item)
+{
+  ReadTable *table = this->read_table.load(std::memory_order_relaxed);
+  if (this->items >= 2 * table->bucket_count()) {
+    unsigned int bits = 64 - table->shift;
+    this->read_resize(bits + 1);
+    table = this->read_table.load(std::memory_order_relaxed);
+  }
+
+  ReadNode *node                  = new ReadNode;
+  node->key                       = key;
+  node->item                      = item;
+  std::atomic<ReadNode *> &bucket = table->bucket(key);
+  node->next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  bucket.store(node, std::memory_order_release);
+}
+
+template <class C>
+void
+RefCountCachePartition<C>::read_erase(uint64_t key)
+{
+  std::atomic<ReadNode *> *link = &this->read_table.load(std::memory_order_relaxed)->bucket(key);
+  while (ReadNode *n = link->load(std::memory_order_relaxed)) {
+    if (n->key == key) {
+      link->store(n->next.load(std::memory_order_relaxed), std::memory_order_release);
+      this->retire(n, nullptr);
+      return;
+    }
+    link = &n->next;
+  }
+}
+
+template <class C>
+void
+RefCountCachePartition<C>::read_clear()
+{
+  ReadTable *table = this->read_table.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < table->bucket_count(); ++i) {
+    for (ReadNode *n = table->buckets[i].load(std::memory_order_relaxed); n; n = n->next.load(std::memory_order_relaxed)) {
+      n->retired_item = make_ptr(n->item);
+    }
+  }
+  this->read_table.store(new ReadTable(64 - table->shift), std::memory_order_release);
+  this->retire(nullptr, table);
+}
+
+// Nodes are never moved between tables, a new table gets copies and the old one is retired whole.
+// The items stay in the map, so the old nodes need no reference.
+template <class C>
+void
+RefCountCachePartition<C>::read_resize(unsigned int bits)
+{
+  ReadTable *table = this->read_table.load(std::memory_order_relaxed);
+  ReadTable *grown = new ReadTable(bits);
+
+  Dbg(dbg_ctl, "partition %d growing read index to %zu buckets", this->part_num, grown->bucket_count());
+  for (size_t i = 0; i < table->bucket_count(); ++i) {
+    for (ReadNode *n = table->buckets[i].load(std::memory_order_relaxed); n; n = n->next.load(std::memory_order_relaxed)) {
+      ReadNode *node                  = new ReadNode;
+      node->key                       = n->key;
+      node->item                      = n->item;
+      std::atomic<ReadNode *> &bucket = grown->bucket(n->key);
+      node->next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      bucket.store(node, std::memory_order_relaxed);
+    }
+  }
+
+  this->read_table.store(grown, std::memory_order_release);
+  this->retire(nullptr, table);
+}
+
+template <class C>
+void
+RefCountCachePartition<C>::retire(ReadNode *node, ReadTable *table)
+{
+  if (node) {
+    node->retired_item = make_ptr(node->item);
+  }
+  this->retired.push_back({RefCountCacheEpoch::advance(), node, table});
+}
+
+template <class C>
+void
+RefCountCachePartition<C>::reclaim(bool all)
+{
+  if (this->retired.empty()) {
+    return;
+  }
+
+  uint64_t oldest = all ? UINT64_MAX : RefCountCacheEpoch::oldest_reader();
+  auto kept       = std::remove_if(this->retired.begin(), this->retired.end(), [oldest](Retired &r) {
+    if (r.epoch >= oldest) {
+      return false;
+    }
+    delete r.node;
+    free_table(r.table);
+    return true;
+  });
+  this->retired.erase(kept, this->retired.end());
+}
+
+template <class C>
+size_t
+RefCountCachePartition<C>::retired_count() const
+{
+  return this->retired.size();
+}
+
+template <class C>
+void
+RefCountCachePartition<C>::free_table(ReadTable *table)
+{
+  if (table) {
+    for (size_t i = 0; i < table->bucket_count(); ++i) {
+      ReadNode *n = table->buckets[i].load(std::memory_order_relaxed);
+      while (n) {
+        ReadNode *next = n->next.load(std::memory_order_relaxed);
+        delete n;
+        n = next;
+      }
+    }
+    delete table;
+  }
+}
+
 // The header for the cache, this is used to check if the serialized cache is compatible
 class RefCountCacheHeader
 {
@@ -569,6 +857,7 @@ void
 RefCountCache<C>::clear()
 {
   for (unsigned int i = 0; i < this->num_partitions; i++) {
+    std::unique_lock<ts::shared_mutex> lock{this->partitions[i]->lock};
     this->partitions[i]->clear();
   }
 }
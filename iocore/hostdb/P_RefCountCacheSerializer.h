@@ -25,6 +25,7 @@
 
 #include "P_RefCountCache.h"
 
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -140,8 +141,14 @@ RefCountCacheSerializer<C>::copy_partition(int /* event */, Event *e)
 
   Dbg(dbg_ctl, "sync partition=%ld/%ld", partition, cache->partition_count());
   // copy the partition into our buffer, then we'll let `pauseEvent` write it out
-  this->partition_items.reserve(cache->get_partition(partition).count());
-  cache->get_partition(partition).copy(this->partition_items);
+  {
+    RefCountCachePartition<C> &part = cache->get_partition(partition);
+    std::unique_lock<ts::shared_mutex> lock{part.lock};
+    // readers do not take the lock, so this only holds off the writers
+    part.reclaim();
+    this->partition_items.reserve(part.count());
+    part.copy(this->partition_items);
+  }
   partition++;
 
   SET_HANDLER(&RefCountCacheSerializer::write_partition);
@@ -38,6 +38,41 @@ RefCountCacheHashEntry::dealloc(RefCountCacheHashEntry *e)
   return refCountCacheHashingValueAllocator.free(e);
 }
 
+std::atomic<uint64_t> RefCountCacheEpoch::global_epoch{1};
+std::atomic<RefCountCacheEpoch::Reader *> RefCountCacheEpoch::readers{nullptr};
+
+RefCountCacheEpoch::Reader *
+RefCountCacheEpoch::add_reader()
+{
+  Reader *r    = new Reader;
+  Reader *head = readers.load(std::memory_order_relaxed);
+  do {
+    r->next = head;
+  } while (!readers.compare_exchange_weak(head, r, std::memory_order_release, std::memory_order_relaxed));
+  return r;
+}
+
+uint64_t
+RefCountCacheEpoch::advance()
+{
+  return global_epoch.fetch_add(1, std::memory_order_seq_cst);
+}
+
+uint64_t
+RefCountCacheEpoch::oldest_reader()
+{
+  uint64_t oldest = UINT64_MAX;
+
+  // pairs with the fence of ReadGuard, a reader is either seen here or sees the unlinked index
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  for (Reader *r = readers.load(std::memory_order_acquire); r; r = r->next) {
+    if (uint64_t epoch = r->epoch.load(std::memory_order_seq_cst); epoch && epoch < oldest) {
+      oldest = epoch;
+    }
+  }
+  return oldest;
+}
+
 RefCountCacheHeader::RefCountCacheHeader(ts::VersionNumber object_version) : object_version(object_version){};
 
 bool
@@ -26,7 +26,11 @@
 #include <I_EventSystem.h>
 #include "tscore/I_Layout.h"
 #include <diags.i>
+#include <atomic>
+#include <mutex>
 #include <set>
+#include <thread>
+#include <vector>
 
 // TODO: add tests with expiry_time
 
@@ -197,6 +201,86 @@ testclear()
   return ret;
 }
 
+// An item that is really freed when its last reference is dropped, so asan catches a freed item returned by get()
+class KeyedStruct : public RefCountObj
+{
+public:
+  uint64_t key;
+
+  explicit KeyedStruct(uint64_t key) : key(key) {}
+};
+
+// Readers get() the keys while a writer replaces and erases them, and inserts enough keys to grow the read index
+int
+testConcurrentGet()
+{
+  int ret = 0;
+
+  const int numReaders     = 4;
+  const uint64_t numHot    = 16;
+  const uint64_t numRounds = 8;
+  const uint64_t numKeys   = 1024; // per round
+
+  RefCountCache<KeyedStruct> *cache = new RefCountCache<KeyedStruct>(2);
+  std::atomic<bool> done{false};
+  std::atomic<int> errors{0};
+  std::atomic<uint64_t> hits{0};
+  std::vector<std::thread> readers;
+
+  for (int i = 0; i < numReaders; i++) {
+    readers.emplace_back([&, i]() {
+      uint64_t h = 0;
+      for (uint64_t n = i; !done.load(std::memory_order_relaxed); n++) {
+        // mostly the hot keys, which are replaced all the time
+        uint64_t key = n % 4 ? n % numHot : n % (numHot + numRounds * numKeys);
+        if (Ptr<KeyedStruct> item = cache->get(key); item) {
+          errors += item->key != key;
+          h++;
+        }
+      }
+      hits += h;
+    });
+  }
+
+  for (uint64_t round = 0; round < numRounds; round++) {
+    // more keys each round, so the read index of every partition grows while it is read
+    for (uint64_t key = numHot + round * numKeys; key < numHot + (round + 1) * numKeys; key++) {
+      std::unique_lock<ts::shared_mutex> lock{cache->lock_for_key(key)};
+      cache->put(key, new KeyedStruct(key));
+    }
+
+    for (int n = 0; n < 20000; n++) {
+      uint64_t key = n % numHot;
+      std::unique_lock<ts::shared_mutex> lock{cache->lock_for_key(key)};
+      if (n % 3) {
+        cache->put(key, new KeyedStruct(key));
+      } else {
+        cache->erase(key);
+      }
+    }
+  }
+  cache->clear();
+
+  done = true;
+  for (auto &t : readers) {
+    t.join();
+  }
+  printf("concurrent get: %" PRIu64 " hits, %d errors\n", hits.load(), errors.load());
+  ret |= errors != 0;
+  ret |= hits == 0;
+
+  // what the readers left retired is reclaimed without further writes
+  for (uint64_t p = 0; p < cache->partition_count(); p++) {
+    std::unique_lock<ts::shared_mutex> lock{cache->get_partition(p).lock};
+    cache->get_partition(p).reclaim();
+    ret |= cache->get_partition(p).retired_count() != 0;
+  }
+
+  delete cache;
+
+  return ret;
+}
+
 int
 test()
 {
@@ -214,6 +298,10 @@ test()
   ret |= testRefcounting();
   printf("refcount ret %d\n", ret);
 
+  printf("Testing concurrent get\n");
+  ret |= testConcurrentGet();
+  printf("concurrent get ret %d\n", ret);
+
   // Initialize our cache
   int cachePartitions                 = 4;
   RefCountCache<ExampleStruct> *cache = new RefCountCache<ExampleStruct>(cachePartitions);
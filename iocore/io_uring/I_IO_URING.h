@@ -25,6 +25,7 @@ Linux io_uring helper library
 
 #include <liburing.h>
 #include <utility>
+#include <vector>
 #include "tscore/ink_hrtime.h"
 
 struct IOUringConfig {
@@ -61,15 +62,31 @@ public:
 
   bool supports_op(int op) const;
 
+  /// Whether the kernel arms an internal poll for ops on non-blocking sockets instead of failing with EAGAIN.
+  bool
+  supports_fast_poll() const
+  {
+    return (features & IORING_FEAT_FAST_POLL) != 0;
+  }
+
   int set_wq_max_workers(unsigned int bounded, unsigned int unbounded);
   std::pair<int, int> get_wq_max_workers();
 
   void submit();
-  void service();
+  /// Handle the completions. @return The number of completions.
+  int service();
   void submit_and_wait(ink_hrtime ms);
 
   int register_eventfd();
 
+  // Fixed files and registered buffers shared by every ring. The set is published once for the
+  // process, and each ring registers it with the kernel the first time it is looked up.
+  static void set_fixed_resources(std::vector<int> fds, std::vector<iovec> buffers);
+  /// Index of @a fd in the fixed file table, or -1 if it is not registered with this ring.
+  int fixed_file(int fd);
+  /// Index of the registered buffer containing [@a buf, @a buf + @a len), or -1 if there is none.
+  int fixed_buffer(const void *buf, size_t len);
+
   // assigns the global iouring config
   static void set_config(const IOUringConfig &);
   static IOUringContext *local_context();
@@ -86,6 +103,12 @@ private:
   io_uring ring         = {};
   io_uring_probe *probe = nullptr;
   int evfd              = -1;
+  unsigned features     = 0;
+
+  enum class FixedState { UNREGISTERED, REGISTERED, UNAVAILABLE };
+  FixedState fixed_files_state   = FixedState::UNREGISTERED;
+  FixedState fixed_buffers_state = FixedState::UNREGISTERED;
+  void register_fixed_resources();
 
   void handle_cqe(io_uring_cqe *);
   static IOUringConfig config;
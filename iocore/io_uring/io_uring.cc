@@ -22,9 +22,11 @@ Linux io_uring helper library
  */
 
 #include <sys/eventfd.h>
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <stdexcept>
+#include <unordered_map>
 
 #include <unistd.h>
 
@@ -38,6 +40,18 @@ std::atomic<uint64_t> io_uring_completions = 0;
 
 IOUringConfig IOUringContext::config;
 
+namespace
+{
+// Process wide fixed resources, immutable once published.
+std::vector<int> fixed_files;
+std::unordered_map<int, int> fixed_file_index;
+std::vector<iovec> fixed_buffers; // sorted by base address
+std::atomic<bool> fixed_published{false};
+
+// The kernel limit on registered buffers.
+constexpr size_t MAX_FIXED_BUFFERS = 1024;
+} // namespace
+
 void
 IOUringContext::set_config(const IOUringConfig &cfg)
 {
@@ -70,6 +84,7 @@ IOUringContext::IOUringContext()
     Debug("io_uring", "io_uring_queue_init_params failed: (%d) %s", -ret, err);
     ring.ring_fd = -1;
   } else {
+    features = p.features;
     /* no sharing for non-fixed either */
     if (config.sq_poll_ms && !(p.features & IORING_FEAT_SQPOLL_NONFIXED)) {
       Debug("io_uring", "No SQPOLL sharing with nonfixed");
@@ -141,14 +156,16 @@ IOUringContext::handle_cqe(io_uring_cqe *cqe)
   op->handle_complete(cqe);
 }
 
-void
+int
 IOUringContext::service()
 {
   io_uring_cqe *cqe = nullptr;
+  int count         = 0;
   io_uring_peek_cqe(&ring, &cqe);
   while (cqe) {
     handle_cqe(cqe);
     io_uring_completions++;
+    ++count;
     io_uring_cqe_seen(&ring, cqe);
 
     cqe = nullptr;
@@ -159,6 +176,7 @@ IOUringContext::service()
     uint64_t val = 0;
     ::read(evfd, &val, sizeof(val));
   }
+  return count;
 }
 
 void
@@ -199,6 +217,102 @@ IOUringContext::local_context()
   return &threadContext;
 }
 
+void
+IOUringContext::set_fixed_resources(std::vector<int> fds, std::vector<iovec> buffers)
+{
+  if (fixed_published.load()) {
+    Debug("io_uring", "fixed resources are already registered");
+    return;
+  }
+
+  std::sort(buffers.begin(), buffers.end(), [](const iovec &a, const iovec &b) { return a.iov_base < b.iov_base; });
+  if (buffers.size() > MAX_FIXED_BUFFERS) {
+    buffers.resize(MAX_FIXED_BUFFERS);
+  }
+
+  fixed_files = std::move(fds);
+  for (size_t i = 0; i < fixed_files.size(); ++i) {
+    fixed_file_index.emplace(fixed_files[i], static_cast<int>(i));
+  }
+  fixed_buffers = std::move(buffers);
+  fixed_published.store(true);
+}
+
+void
+IOUringContext::register_fixed_resources()
+{
+  fixed_files_state   = FixedState::UNAVAILABLE;
+  fixed_buffers_state = FixedState::UNAVAILABLE;
+
+  if (!valid()) {
+    return;
+  }
+
+  if (!fixed_files.empty()) {
+    int ret = io_uring_register_files(&ring, fixed_files.data(), fixed_files.size());
+    if (ret < 0) {
+      Debug("io_uring", "io_uring_register_files failed: (%d) %s", -ret, strerror(-ret));
+    } else {
+      fixed_files_state = FixedState::REGISTERED;
+    }
+  }
+
+  if (!fixed_buffers.empty()) {
+    // This pins the buffer memory, which can fail against RLIMIT_MEMLOCK. Plain reads and writes are used then.
+    int ret = io_uring_register_buffers(&ring, fixed_buffers.data(), fixed_buffers.size());
+    if (ret < 0) {
+      Debug("io_uring", "io_uring_register_buffers failed: (%d) %s", -ret, strerror(-ret));
+    } else {
+      fixed_buffers_state = FixedState::REGISTERED;
+    }
+  }
+}
+
+int
+IOUringContext::fixed_file(int fd)
+{
+  if (fixed_files_state == FixedState::UNREGISTERED) {
+    if (!fixed_published.load(std::memory_order_acquire)) {
+      return -1;
+    }
+    register_fixed_resources();
+  }
+  if (fixed_files_state != FixedState::REGISTERED) {
+    return -1;
+  }
+
+  auto spot = fixed_file_index.find(fd);
+  return spot == fixed_file_index.end() ? -1 : spot->second;
+}
+
+int
+IOUringContext::fixed_buffer(const void *buf, size_t len)
+{
+  if (fixed_buffers_state == FixedState::UNREGISTERED) {
+    if (!fixed_published.load(std::memory_order_acquire)) {
+      return -1;
+    }
+    register_fixed_resources();
+  }
+  if (fixed_buffers_state != FixedState::REGISTERED) {
+    return -1;
+  }
+
+  // Find the last buffer starting at or before @a buf and check it covers the whole range.
+  auto spot = std::upper_bound(fixed_buffers.begin(), fixed_buffers.end(), buf,
+                               [](const void *b, const iovec &v) { return b < v.iov_base; });
+  if (spot == fixed_buffers.begin()) {
+    return -1;
+  }
+  --spot;
+  auto base = static_cast<const char *>(spot->iov_base);
+  auto p    = static_cast<const char *>(buf);
+  if (p + len > base + spot->iov_len) {
+    return -1;
+  }
+  return static_cast<int>(spot - fixed_buffers.begin());
+}
+
 bool
 IOUringContext::supports_op(int op) const
 {
@@ -60,6 +60,9 @@ extern int net_accept_period;
 extern int net_retry_delay;
 extern int net_throttle_delay;
 
+/// Submit socket reads and writes through the per-thread io_uring instead of recvmsg/sendmsg.
+extern bool net_use_io_uring;
+
 extern std::string_view net_ccp_in;
 extern std::string_view net_ccp_out;
 
@@ -39,6 +39,8 @@ int net_accept_period  = 10;
 int net_retry_delay    = 10;
 int net_throttle_delay = 50; /* milliseconds */
 
+bool net_use_io_uring = false;
+
 // For the in/out congestion control: ToDo: this probably would be better as ports: specifications
 std::string_view net_ccp_in;
 std::string_view net_ccp_out;
@@ -74,6 +76,23 @@ configure_net()
   } else {
     ats_free(ccp);
   }
+
+#if TS_USE_LINUX_IO_URING
+  int net_io_uring = 0;
+  REC_ReadConfigInteger(net_io_uring, "proxy.config.io_uring.net_io");
+  if (net_io_uring) {
+    // Without fast poll the kernel completes socket ops on a non-ready socket with EAGAIN rather than
+    // waiting for readiness, which would turn the completion path into a busy loop.
+    IOUringContext *ur = IOUringContext::local_context();
+    if (ur->valid() && ur->supports_fast_poll() && ur->supports_op(IORING_OP_RECVMSG) && ur->supports_op(IORING_OP_SENDMSG) &&
+        ur->supports_op(IORING_OP_ASYNC_CANCEL)) {
+      net_use_io_uring = true;
+      Note("Using io_uring for network IO");
+    } else {
+      Warning("proxy.config.io_uring.net_io is enabled but the kernel does not support the required io_uring features");
+    }
+  }
+#endif
 }
 
 static inline void
@@ -86,12 +105,15 @@ register_net_stats()
     {"proxy.process.net.calls_to_write",                      net_calls_to_write_stat                 },
     {"proxy.process.net.calls_to_write_nodata",               net_calls_to_write_nodata_stat          },
     {"proxy.process.net.calls_to_writetonet",                 net_calls_to_writetonet_stat            },
+    {"proxy.process.net.inactivity_cop_checks",               inactivity_cop_checks_stat              },
     {"proxy.process.net.inactivity_cop_lock_acquire_failure", inactivity_cop_lock_acquire_failure_stat},
     {"proxy.process.net.net_handler_run",                     net_handler_run_stat                    },
     {"proxy.process.net.read_bytes",                          net_read_bytes_stat                     },
     {"proxy.process.net.write_bytes",                         net_write_bytes_stat                    },
     {"proxy.process.net.fastopen_out.attempts",               net_fastopen_attempts_stat              },
     {"proxy.process.net.fastopen_out.successes",              net_fastopen_successes_stat             },
+    {"proxy.process.net.io_uring.reads_submitted",            net_io_uring_reads_submitted_stat       },
+    {"proxy.process.net.io_uring.writes_submitted",           net_io_uring_writes_submitted_stat      },
     {"proxy.process.socks.connections_successful",            socks_connections_successful_stat       },
     {"proxy.process.socks.connections_unsuccessful",          socks_connections_unsuccessful_stat     },
   };
@@ -25,6 +25,7 @@
 
 #include <atomic>
 
+#include "tscore/TimerWheel.h"
 #include "I_EventSystem.h"
 #include "P_UnixNetState.h"
 #include "EventIO.h"
@@ -106,7 +107,7 @@ public:
   bool use_default_inactivity_timeout = false;
 
   LINK(NetEvent, open_link);
-  LINK(NetEvent, cop_link);
+  TimerWheelLink<NetEvent> timeout_link; ///< Next timeout check by the InactivityCop.
   LINKM(NetEvent, read, ready_link)
   SLINKM(NetEvent, read, enable_link)
   LINKM(NetEvent, write, ready_link)
@@ -94,6 +94,8 @@ NetHandler::startCop(NetEvent *ne)
   ink_assert(!open_list.in(ne));
 
   open_list.enqueue(ne);
+  // First check on the next InactivityCop run.
+  timeout_wheel.insert(ne, ink_get_hrtime());
 }
 
 void
@@ -102,11 +104,50 @@ NetHandler::stopCop(NetEvent *ne)
   ink_release_assert(ne->nh == this);
 
   open_list.remove(ne);
-  cop_list.remove(ne);
+  if (TimeoutWheel::in(ne)) {
+    timeout_wheel.remove(ne);
+  }
   remove_from_keep_alive_queue(ne);
   remove_from_active_queue(ne);
 }
 
+void
+NetHandler::update_timeout(NetEvent *ne)
+{
+  // The wheel is only used from the thread of this NetHandler.
+  if (this_ethread() != thread || !TimeoutWheel::in(ne)) {
+    return;
+  }
+
+  ink_hrtime now = ink_get_hrtime();
+  ink_hrtime at  = std::max(next_timeout_check(ne, now), now + TIMEOUT_GRANULARITY);
+  if (at < ne->timeout_link.expire_at) {
+    timeout_wheel.remove(ne);
+    timeout_wheel.insert(ne, at);
+  }
+}
+
+ink_hrtime
+NetHandler::next_timeout_check(const NetEvent *ne, ink_hrtime now) const
+{
+  ink_hrtime at = now + TIMEOUT_CHECK_MAX;
+
+  if (ne->closed) {
+    // The InactivityCop frees it.
+    return now;
+  }
+  if (ne->next_inactivity_timeout_at) {
+    at = std::min(at, ne->next_inactivity_timeout_at);
+  } else if (ne->default_inactivity_timeout_in != 0 && (ne->read.enabled || ne->write.enabled)) {
+    // The InactivityCop sets the default inactivity timeout.
+    at = now;
+  }
+  if (ne->next_activity_timeout_at) {
+    at = std::min(at, ne->next_activity_timeout_at);
+  }
+  return at;
+}
+
 int
 NetHandler::update_nethandler_config(const char *str, RecDataT, RecData data, void *)
 {
@@ -307,13 +348,29 @@ NetHandler::mainNetEvent(int event, Event *e)
 
 int
 NetHandler::waitForActivity(ink_hrtime timeout)
+{
+  NET_INCREMENT_DYN_STAT(net_handler_run_stat);
+  this->poll_and_process(timeout);
+  return EVENT_CONT;
+}
+
+bool
+NetHandler::pollActivity()
+{
+  // Anything enabled or ready is handled as well, it is activity too.
+  bool pending = !read_ready_list.empty() || !write_ready_list.empty() || !read_enable_list.empty() || !write_enable_list.empty();
+  return this->poll_and_process(0) > 0 || pending;
+}
+
+int
+NetHandler::poll_and_process(ink_hrtime timeout)
 {
   EventIO *epd = nullptr;
+  int events   = 0;
 #if TS_USE_LINUX_IO_URING
   IOUringContext *ur = IOUringContext::local_context();
 #endif
 
-  NET_INCREMENT_DYN_STAT(net_handler_run_stat);
   SCOPED_MUTEX_LOCK(lock, mutex, this->thread);
 
   process_enabled_list();
@@ -335,14 +392,15 @@ NetHandler::waitForActivity(ink_hrtime timeout)
     ev_next_event(pd, x);
   }
 
+  events     = std::max(pd->result, 0);
   pd->result = 0;
 
   process_ready_list();
 #if TS_USE_LINUX_IO_URING
-  ur->service();
+  events += ur->service();
 #endif
 
-  return EVENT_CONT;
+  return events;
 }
 
 void
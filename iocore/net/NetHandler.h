@@ -99,7 +99,9 @@ public:
   QueM(NetEvent, NetState, read, ready_link) read_ready_list;
   QueM(NetEvent, NetState, write, ready_link) write_ready_list;
   Que(NetEvent, open_link) open_list;
-  DList(NetEvent, cop_link) cop_list;
+  /// NetEvents of the open_list by time of their next timeout check.
+  using TimeoutWheel = TimerWheel<NetEvent, TimerWheelLinkAccess<NetEvent, &NetEvent::timeout_link>>;
+  TimeoutWheel timeout_wheel{TIMEOUT_GRANULARITY};
   ASLLM(NetEvent, NetState, read, enable_link) read_enable_list;
   ASLLM(NetEvent, NetState, write, enable_link) write_enable_list;
   Que(NetEvent, keep_alive_queue_link) keep_alive_queue;
@@ -154,8 +156,17 @@ public:
   /// corresponding bit.
   static std::bitset<std::numeric_limits<unsigned int>::digits> active_thread_types;
 
+  /// Resolution of the timeout checks, finer than the InactivityCop period.
+  static constexpr ink_hrtime TIMEOUT_GRANULARITY = HRTIME_MSECONDS(100);
+  /// Longest time between timeout checks of a NetEvent, which catches timeouts shortened behind
+  /// the back of the NetHandler.
+  static constexpr ink_hrtime TIMEOUT_CHECK_MAX = HRTIME_SECONDS(30);
+
   int mainNetEvent(int event, Event *data);
   int waitForActivity(ink_hrtime timeout) override;
+  bool pollActivity() override;
+  /// Poll for up to @a timeout and handle the results. @return The number of I/O events handled.
+  int poll_and_process(ink_hrtime timeout);
   void process_enabled_list();
   void process_ready_list();
   void manage_keep_alive_queue();
@@ -194,22 +205,38 @@ public:
 
   /**
     Start to handle active timeout and inactivity timeout on a NetEvent.
-    Put the ne into open_list. All NetEvents in the open_list is checked for
-    timeout by InactivityCop. Only be called when holding the mutex of this
-    NetHandler and must call startIO(ne) first.
+    Put the ne into open_list and timeout_wheel. The InactivityCop checks the
+    NetEvents for timeout as they come due in the timeout_wheel. Only be called
+    when holding the mutex of this NetHandler and must call startIO(ne) first.
 
     @param ne NetEvent to be managed by InactivityCop
    */
   void startCop(NetEvent *ne);
   /**
     Stop to handle active timeout and inactivity on a NetEvent.
-    Remove the ne from open_list and cop_list.
+    Remove the ne from open_list and timeout_wheel.
     Also remove the ne from keep_alive_queue and active_queue if its context is
     IN. Only be called when holding the mutex of this NetHandler.
 
     @param ne NetEvent to be released.
    */
   void stopCop(NetEvent *ne);
+  /**
+    Bring forward the next timeout check of a NetEvent after its timeouts
+    changed. The check is only moved if it is on the thread of this NetHandler,
+    otherwise the change is caught within TIMEOUT_CHECK_MAX.
+
+    @param ne NetEvent whose timeouts changed.
+   */
+  void update_timeout(NetEvent *ne);
+  /**
+    Time of the next timeout check of a NetEvent, no later than its earliest
+    timeout.
+
+    @param ne NetEvent to check.
+    @param now Current time.
+   */
+  ink_hrtime next_timeout_check(const NetEvent *ne, ink_hrtime now) const;
 
   // Signal the epoll_wait to terminate.
   void signalActivity() override;
@@ -47,6 +47,7 @@ enum Net_Stats {
   socks_connections_unsuccessful_stat,
   socks_connections_currently_open_stat,
   inactivity_cop_lock_acquire_failure_stat,
+  inactivity_cop_checks_stat,
   keep_alive_queue_timeout_total_stat,
   keep_alive_queue_timeout_count_stat,
   default_inactivity_timeout_applied_stat,
@@ -57,6 +58,8 @@ enum Net_Stats {
   net_connections_throttled_in_stat,
   net_connections_throttled_out_stat,
   net_requests_max_throttled_in_stat,
+  net_io_uring_reads_submitted_stat,
+  net_io_uring_writes_submitted_stat,
   Net_Stat_Count
 };
 
@@ -31,6 +31,7 @@
 
 #pragma once
 
+#include "tscore/ink_config.h"
 #include "tscore/ink_sock.h"
 #include "I_NetVConnection.h"
 #include "P_UnixNetState.h"
@@ -38,10 +39,60 @@
 #include "P_NetAccept.h"
 #include "NetEvent.h"
 
+#if TS_USE_LINUX_IO_URING
+#include "I_IO_URING.h"
+#endif
+
 class UnixNetVConnection;
 class NetHandler;
 struct PollDescriptor;
 
+#if TS_USE_LINUX_IO_URING
+/// Outcome of driving the io_uring read or write for a VC.
+enum class IOUringNetResult {
+  COMPLETE, ///< A result is available and is processed as if it came from the syscall.
+  PENDING,  ///< A request is in flight, its completion reschedules the VC.
+  FALLBACK, ///< The request could not be queued, use the syscall instead.
+};
+
+/**
+  A socket read or write submitted to the thread's io_uring on behalf of a @c UnixNetVConnection.
+
+  The kernel reads into or writes from the @c IOBufferBlock memory described by @a iov directly. The op
+  holds a reference to the first block of that chain so the memory stays valid until the completion
+  is reaped, even if the VIO buffer is changed or released in the meantime. If the VC is closed while
+  the op is in flight, the op is detached, the request is cancelled and the op frees itself when the
+  last completion arrives.
+*/
+class UnixNetIOUringOp final : public IOUringCompletionHandler
+{
+public:
+  enum class State { IDLE, IN_FLIGHT, COMPLETE };
+
+  UnixNetIOUringOp(UnixNetVConnection *vc, bool is_read) : _vc(vc), _is_read(is_read) {}
+
+  /// Submit a recvmsg or sendmsg for the first @a n entries of @a iov, which must lie in the chain starting at @a block.
+  bool submit(IOBufferBlock *block, unsigned n);
+  /// If the op has completed, store the result in @a r, return the op to idle and return @c true.
+  bool take_result(int64_t &r);
+  /// Disassociate from the VC, cancelling any request still in flight. The op must not be used after this.
+  void detach();
+
+  void handle_complete(io_uring_cqe *cqe) override;
+
+  State state = State::IDLE;
+  IOVec iov[NET_MAX_IOV];
+  unsigned niov = 0;
+
+private:
+  UnixNetVConnection *_vc = nullptr;
+  bool _is_read           = false;
+  int64_t _result         = 0;
+  msghdr _msg;
+  Ptr<IOBufferBlock> _block;
+};
+#endif
+
 enum tcp_congestion_control_t { CLIENT_SIDE, SERVER_SIDE };
 
 class UnixNetVConnection : public NetVConnection, public NetEvent
@@ -223,6 +274,14 @@ public:
   int set_tcp_congestion_control(int side) override;
   void apply_options() override;
 
+#if TS_USE_LINUX_IO_URING
+  // Outstanding or unprocessed io_uring socket ops, allocated on first use.
+  UnixNetIOUringOp *read_op  = nullptr;
+  UnixNetIOUringOp *write_op = nullptr;
+
+  IOUringNetResult load_buffer_and_write_io_uring(int64_t towrite, MIOBufferAccessor &buf, int64_t &r);
+#endif
+
   friend void write_to_net_io(NetHandler *, UnixNetVConnection *, EThread *);
 
 private:
@@ -287,14 +346,6 @@ UnixNetVConnection::get_inactivity_timeout()
   return inactivity_timeout_in;
 }
 
-inline void
-UnixNetVConnection::set_active_timeout(ink_hrtime timeout_in)
-{
-  Debug("socket", "Set active timeout=%" PRId64 ", NetVC=%p", timeout_in, this);
-  active_timeout_in        = timeout_in;
-  next_activity_timeout_at = (active_timeout_in > 0) ? ink_get_hrtime() + timeout_in : 0;
-}
-
 inline void
 UnixNetVConnection::cancel_inactivity_timeout()
 {
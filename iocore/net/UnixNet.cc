@@ -62,7 +62,7 @@ get_PollDescriptor(EThread *t)
 
 // INKqa10496
 // One Inactivity cop runs on each thread once every second and
-// loops through the list of NetEvents and calls the timeouts
+// checks the NetEvents whose timeout check came due
 class InactivityCop : public Continuation
 {
 public:
@@ -74,14 +74,29 @@ public:
     ink_hrtime now = ink_get_hrtime();
     NetHandler &nh = *get_NetHandler(this_ethread());
 
+    // Timeouts are checked at the next run at the earliest.
+    auto recheck = [&](NetEvent *ne, ink_hrtime at) {
+      nh.timeout_wheel.insert(ne, std::max(at, now + NetHandler::TIMEOUT_GRANULARITY));
+    };
+
     Debug("inactivity_cop_check", "Checking inactivity on Thread-ID #%d", this_ethread()->id);
-    // The rest NetEvents in cop_list which are not triggered between InactivityCop runs.
-    // Use pop() to catch any closes caused by callbacks.
-    while (NetEvent *ne = nh.cop_list.pop()) {
+    // Only the NetEvents which may have timed out are due. The timeouts are pushed back by activity
+    // without touching the wheel, so a due NetEvent which did not time out is put back for its
+    // current timeouts.
+    nh.timeout_wheel.advance(now, [](NetEvent *) { return false; });
+    // Use pop_ready() to catch any closes caused by callbacks.
+    while (NetEvent *ne = nh.timeout_wheel.pop_ready()) {
+      NET_INCREMENT_DYN_STAT(inactivity_cop_checks_stat);
+      if (ne->get_thread() != this_ethread()) {
+        recheck(ne, now);
+        continue;
+      }
+
       // If we cannot get the lock don't stop just keep cleaning
       MUTEX_TRY_LOCK(lock, ne->get_mutex(), this_ethread());
       if (!lock.is_locked()) {
         NET_INCREMENT_DYN_STAT(inactivity_cop_lock_acquire_failure_stat);
+        recheck(ne, now);
         continue;
       }
 
@@ -124,25 +139,18 @@ public:
         }
         Debug("inactivity_cop_verbose", "ne: %p now: %" PRId64 " timeout at: %" PRId64 " timeout in: %" PRId64, ne,
               ink_hrtime_to_sec(now), ne->next_inactivity_timeout_at, ne->inactivity_timeout_in);
+        // Check again on the next run in case the timeout is not handled, before the callback may free @a ne.
+        recheck(ne, now);
         ne->callback(VC_EVENT_INACTIVITY_TIMEOUT, e);
       } else if (ne->next_activity_timeout_at && ne->next_activity_timeout_at < now) {
         Debug("inactivity_cop_verbose", "active ne: %p now: %" PRId64 " timeout at: %" PRId64 " timeout in: %" PRId64, ne,
               ink_hrtime_to_sec(now), ne->next_activity_timeout_at, ne->active_timeout_in);
+        recheck(ne, now);
         ne->callback(VC_EVENT_ACTIVE_TIMEOUT, e);
+      } else {
+        recheck(ne, nh.next_timeout_check(ne, now));
       }
     }
-    // The cop_list is empty now.
-    // Let's reload the cop_list from open_list again.
-    forl_LL(NetEvent, ne, nh.open_list)
-    {
-      if (ne->get_thread() == this_ethread()) {
-        nh.cop_list.push(ne);
-      }
-    }
-    // NetHandler will remove NetEvent from cop_list if it is triggered.
-    // As the NetHandler runs, the number of NetEvents in the cop_list is decreasing.
-    // NetHandler runs 100 times maximum between InactivityCop runs.
-    // Therefore we don't have to check all the NetEvents as much as open_list.
 
     // Cleanup the active and keep-alive queues periodically
     nh.manage_active_queue(nullptr, true); // close any connections over the active timeout
@@ -23,6 +23,7 @@
 
 #include <tscore/TSSystemState.h>
 #include <tscore/ink_defs.h>
+#include <tscore/numa.h>
 
 #include "P_Net.h"
 
@@ -36,6 +37,25 @@ safe_delay(int msec)
   SocketManager::poll(nullptr, 0, msec);
 }
 
+// The NUMA node of the processor that received the packets of the accepted socket @a fd, -1 if
+// unknown or if there are no NUMA arenas to keep the connection local to.
+static int
+accept_numa_node(int fd)
+{
+#ifdef SO_INCOMING_CPU
+  if (ats_numa_enabled()) {
+    int cpu = -1;
+    int len = sizeof(cpu);
+    if (safe_getsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &len) == 0) {
+      return ats_numa_cpu_node(cpu);
+    }
+  }
+#else
+  (void)fd;
+#endif
+  return -1;
+}
+
 //
 // General case network connection accept code
 //
@@ -115,7 +135,7 @@ net_accept(NetAccept *na, void *ep, bool blockable)
         vc->handleEvent(EVENT_NONE, e);
       }
     } else {
-      t = eventProcessor.assign_thread(na->opt.etype);
+      t = eventProcessor.assign_thread(na->opt.etype, accept_numa_node(vc->con.fd));
       h = get_NetHandler(t);
       // Assign NetHandler->mutex to NetVC
       vc->mutex = h->mutex;
@@ -364,7 +384,7 @@ NetAccept::do_blocking_accept(EThread *t)
 #endif
     SET_CONTINUATION_HANDLER(vc, &UnixNetVConnection::acceptEvent);
 
-    EThread *localt = eventProcessor.assign_thread(opt.etype);
+    EThread *localt = eventProcessor.assign_thread(opt.etype, accept_numa_node(vc->con.fd));
     NetHandler *h   = get_NetHandler(localt);
     // Assign NetHandler->mutex to NetVC
     vc->mutex = h->mutex;
@@ -425,6 +445,7 @@ NetAccept::acceptFastEvent(int event, void *ep)
   con.sock_type = SOCK_STREAM;
 
   UnixNetVConnection *vc = nullptr;
+  EThread *t             = nullptr;
   const int loop         = NetAccept::accept_till_done;
 
   do {
@@ -487,7 +508,14 @@ NetAccept::acceptFastEvent(int event, void *ep)
       goto Lerror;
     }
 
-    vc = (UnixNetVConnection *)this->getNetProcessor()->allocate_vc(e->ethread);
+    // Hand the connection to a thread on the NUMA node its packets arrive on, if this one is not.
+    t = e->ethread;
+    if (int node = accept_numa_node(fd); node >= 0 && node != t->numa_node) {
+      t = eventProcessor.assign_thread(opt.etype, node);
+    }
+
+    // Use 'nullptr' to bypass the thread allocator of another thread
+    vc = (UnixNetVConnection *)this->getNetProcessor()->allocate_vc(t == e->ethread ? t : nullptr);
     ink_release_assert(vc);
 
     NET_SUM_GLOBAL_DYN_STAT(net_connections_currently_open_stat, 1);
@@ -517,13 +545,16 @@ NetAccept::acceptFastEvent(int event, void *ep)
 #endif
     SET_CONTINUATION_HANDLER(vc, &UnixNetVConnection::acceptEvent);
 
-    EThread *t    = e->ethread;
     NetHandler *h = get_NetHandler(t);
     // Assign NetHandler->mutex to NetVC
     vc->mutex = h->mutex;
-    // We must be holding the lock already to do later do_io_read's
-    SCOPED_MUTEX_LOCK(lock, vc->mutex, e->ethread);
-    vc->handleEvent(EVENT_NONE, nullptr);
+    if (t == e->ethread) {
+      // We must be holding the lock already to do later do_io_read's
+      SCOPED_MUTEX_LOCK(lock, vc->mutex, e->ethread);
+      vc->handleEvent(EVENT_NONE, nullptr);
+    } else {
+      t->schedule_imm(vc);
+    }
     vc = nullptr;
   } while (loop);
 
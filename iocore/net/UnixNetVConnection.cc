@@ -180,6 +180,67 @@ write_signal_error(NetHandler *nh, UnixNetVConnection *vc, int lerrno)
   return write_signal_done(VC_EVENT_ERROR, nh, vc);
 }
 
+#if TS_USE_LINUX_IO_URING
+// Collect the result of a completed io_uring read for @a vc, or submit one for up to @a toread bytes.
+// On COMPLETE @a r holds the syscall style result and, if positive, the data has been added to the
+// writer of @a buf.
+static IOUringNetResult
+read_from_net_io_uring(NetHandler *nh, UnixNetVConnection *vc, MIOBufferAccessor &buf, int64_t toread, int64_t &r)
+{
+  ProxyMutex *mutex = vc->thread->mutex.get();
+
+  if (vc->read_op == nullptr) {
+    vc->read_op = new UnixNetIOUringOp(vc, true);
+  }
+  UnixNetIOUringOp *op = vc->read_op;
+
+  if (op->take_result(r)) {
+    if (r > 0) {
+      IOBufferBlock *b = buf.writer()->first_write_block();
+      if (b != nullptr && b->end() == op->iov[0].iov_base) {
+        buf.writer()->fill(r);
+      } else {
+        // The VIO buffer was replaced while the read was in flight, move the data over to the new one.
+        // All of it, the bytes are off the socket, the caller accounts no more than the VIO wants.
+        int64_t left = r;
+        for (unsigned i = 0; i < op->niov && left > 0; ++i) {
+          int64_t len  = std::min(left, static_cast<int64_t>(op->iov[i].iov_len));
+          buf.writer()->write(op->iov[i].iov_base, len);
+          left        -= len;
+        }
+      }
+    }
+    return IOUringNetResult::COMPLETE;
+  }
+
+  if (op->state == UnixNetIOUringOp::State::IN_FLIGHT) {
+    nh->read_ready_list.remove(vc);
+    return IOUringNetResult::PENDING;
+  }
+
+  IOBufferBlock *first = buf.writer()->first_write_block();
+  int64_t attempted    = 0;
+  unsigned niov        = 0;
+  for (IOBufferBlock *b = first; b && niov < NET_MAX_IOV && attempted < toread; b = b->next.get()) {
+    int64_t a = std::min(b->write_avail(), toread - attempted);
+    if (a > 0) {
+      op->iov[niov].iov_base  = b->end();
+      op->iov[niov].iov_len   = a;
+      attempted              += a;
+      niov++;
+    }
+  }
+  ink_assert(niov > 0);
+
+  if (!op->submit(first, niov)) {
+    return IOUringNetResult::FALLBACK;
+  }
+  NET_INCREMENT_DYN_STAT(net_io_uring_reads_submitted_stat);
+  nh->read_ready_list.remove(vc);
+  return IOUringNetResult::PENDING;
+}
+#endif
+
 // Read the data for a UnixNetVConnection.
 // Rescheduling the UnixNetVConnection by moving the VC
 // onto or off of the ready_list.
@@ -229,44 +290,60 @@ read_from_net(NetHandler *nh, UnixNetVConnection *vc, EThread *thread)
   int64_t rattempted = 0, total_read = 0;
   unsigned niov = 0;
   IOVec tiovec[NET_MAX_IOV];
+  bool filled = false;
   if (toread) {
     IOBufferBlock *b = buf.writer()->first_write_block();
-    do {
-      niov       = 0;
-      rattempted = 0;
-      while (b && niov < NET_MAX_IOV) {
-        int64_t a = b->write_avail();
-        if (a > 0) {
-          tiovec[niov].iov_base = b->_end;
-          int64_t togo          = toread - total_read - rattempted;
-          if (a > togo) {
-            a = togo;
-          }
-          tiovec[niov].iov_len  = a;
-          rattempted           += a;
-          niov++;
-          if (a >= togo) {
-            break;
+#if TS_USE_LINUX_IO_URING
+    if (net_use_io_uring) {
+      switch (read_from_net_io_uring(nh, vc, buf, toread, r)) {
+      case IOUringNetResult::PENDING:
+        return;
+      case IOUringNetResult::COMPLETE:
+        filled = true;
+        break;
+      case IOUringNetResult::FALLBACK:
+        break;
+      }
+    }
+#endif
+    if (!filled) {
+      do {
+        niov       = 0;
+        rattempted = 0;
+        while (b && niov < NET_MAX_IOV) {
+          int64_t a = b->write_avail();
+          if (a > 0) {
+            tiovec[niov].iov_base = b->_end;
+            int64_t togo          = toread - total_read - rattempted;
+            if (a > togo) {
+              a = togo;
+            }
+            tiovec[niov].iov_len  = a;
+            rattempted           += a;
+            niov++;
+            if (a >= togo) {
+              break;
+            }
           }
+          b = b->next.get();
         }
-        b = b->next.get();
-      }
 
-      ink_assert(niov > 0);
-      ink_assert(niov <= countof(tiovec));
-      struct msghdr msg;
+        ink_assert(niov > 0);
+        ink_assert(niov <= countof(tiovec));
+        struct msghdr msg;
 
-      ink_zero(msg);
-      msg.msg_name    = const_cast<sockaddr *>(vc->get_remote_addr());
-      msg.msg_namelen = ats_ip_size(vc->get_remote_addr());
-      msg.msg_iov     = &tiovec[0];
-      msg.msg_iovlen  = niov;
-      r               = SocketManager::recvmsg(vc->con.fd, &msg, 0);
+        ink_zero(msg);
+        msg.msg_name    = const_cast<sockaddr *>(vc->get_remote_addr());
+        msg.msg_namelen = ats_ip_size(vc->get_remote_addr());
+        msg.msg_iov     = &tiovec[0];
+        msg.msg_iovlen  = niov;
+        r               = SocketManager::recvmsg(vc->con.fd, &msg, 0);
 
-      NET_INCREMENT_DYN_STAT(net_calls_to_read_stat);
+        NET_INCREMENT_DYN_STAT(net_calls_to_read_stat);
 
-      total_read += rattempted;
-    } while (rattempted && r == rattempted && total_read < toread);
+        total_read += rattempted;
+      } while (rattempted && r == rattempted && total_read < toread);
+    }
 
     // if we have already moved some bytes successfully, summarize in r
     if (total_read != rattempted) {
@@ -298,13 +375,16 @@ read_from_net(NetHandler *nh, UnixNetVConnection *vc, EThread *thread)
     NET_SUM_DYN_STAT(net_read_bytes_stat, r);
 
     // Add data to buffer and signal continuation.
-    buf.writer()->fill(r);
+    if (!filled) {
+      buf.writer()->fill(r);
+    }
 #ifdef DEBUG
     if (buf.writer()->write_avail() <= 0) {
       Debug("iocore_net", "read_from_net, read buffer full");
     }
 #endif
-    s->vio.ndone += r;
+    // An io_uring read into a replaced buffer may have read more than the new VIO wants.
+    s->vio.ndone += std::min(r, ntodo);
     net_activity(vc, thread);
   } else {
     r = 0;
@@ -602,6 +682,9 @@ UnixNetVConnection::do_io_read(Continuation *c, int64_t nbytes, MIOBuffer *buf)
     read.vio.buffer.writer_for(buf);
     if (!read.enabled) {
       read.vio.reenable();
+    } else if (nh) {
+      // reenable() does not move an enabled vio in the timeout wheel
+      nh->update_timeout(this);
     }
   } else {
     read.vio.buffer.clear();
@@ -617,6 +700,18 @@ UnixNetVConnection::do_io_write(Continuation *c, int64_t nbytes, IOBufferReader
     Error("do_io_write invoked on closed vc %p, cont %p, nbytes %" PRId64 ", reader %p", this, c, nbytes, reader);
     return nullptr;
   }
+#if TS_USE_LINUX_IO_URING
+  // The io_uring write of a reader that is replaced is accounted to that reader if it completed,
+  // and cancelled otherwise.
+  if (write_op != nullptr && write.vio.buffer.reader() != reader) {
+    int64_t r = 0;
+    if (write_op->take_result(r) && r > 0 && write.vio.buffer.reader() != nullptr) {
+      write.vio.buffer.reader()->consume(r);
+    }
+    write_op->detach();
+    write_op = nullptr;
+  }
+#endif
   write.vio.op        = VIO::WRITE;
   write.vio.mutex     = c ? c->mutex : this->mutex;
   write.vio.cont      = c;
@@ -628,6 +723,8 @@ UnixNetVConnection::do_io_write(Continuation *c, int64_t nbytes, IOBufferReader
     write.vio.buffer.reader_for(reader);
     if (nbytes && !write.enabled) {
       write.vio.reenable();
+    } else if (nh) {
+      nh->update_timeout(this);
     }
   } else {
     write.enabled = 0;
@@ -662,6 +759,8 @@ UnixNetVConnection::do_io_close(int alerrno /* = -1 */)
 
   EThread *t        = this_ethread();
   bool close_inline = !recursion && (!nh || nh->mutex->thread_holding == t);
+  // Once closed a NetVC of another thread may be freed at any time.
+  bool nh_thread = nh && nh->thread == t;
 
   INK_WRITE_MEMORY_BARRIER;
   if (alerrno && alerrno != -1) {
@@ -682,6 +781,9 @@ UnixNetVConnection::do_io_close(int alerrno /* = -1 */)
     } else {
       this->free_thread(t);
     }
+  } else if (nh_thread) {
+    // Free it on the next InactivityCop run.
+    nh->update_timeout(this);
   }
 }
 
@@ -846,6 +948,9 @@ UnixNetVConnection::set_enabled(VIO *vio)
   if (!next_inactivity_timeout_at && inactivity_timeout_in) {
     next_inactivity_timeout_at = ink_get_hrtime() + inactivity_timeout_in;
   }
+  if (nh) {
+    nh->update_timeout(this);
+  }
 }
 
 void
@@ -869,6 +974,26 @@ UnixNetVConnection::load_buffer_and_write(int64_t towrite, MIOBufferAccessor &bu
 {
   int64_t r                  = 0;
   int64_t try_to_write       = 0;
+
+#if TS_USE_LINUX_IO_URING
+  // TCP Fast Open needs the sendmsg flags on the connecting write, leave that one to the syscall.
+  if (net_use_io_uring && this->con.is_connected) {
+    switch (load_buffer_and_write_io_uring(towrite, buf, r)) {
+    case IOUringNetResult::PENDING:
+      // The completion puts the VC back on the write ready list.
+      return -EAGAIN;
+    case IOUringNetResult::COMPLETE:
+      if (r > 0) {
+        total_written += r;
+      }
+      needs |= EVENTIO_WRITE;
+      return r;
+    case IOUringNetResult::FALLBACK:
+      break;
+    }
+  }
+#endif
+
   IOBufferReader *tmp_reader = buf.reader()->clone();
 
   do {
@@ -950,6 +1075,158 @@ UnixNetVConnection::load_buffer_and_write(int64_t towrite, MIOBufferAccessor &bu
   return r;
 }
 
+#if TS_USE_LINUX_IO_URING
+// Collect the result of a completed io_uring write, consuming what was sent from the reader of @a buf,
+// or submit a sendmsg for up to @a towrite bytes.
+IOUringNetResult
+UnixNetVConnection::load_buffer_and_write_io_uring(int64_t towrite, MIOBufferAccessor &buf, int64_t &r)
+{
+  ProxyMutex *mutex = thread->mutex.get();
+
+  if (write_op == nullptr) {
+    write_op = new UnixNetIOUringOp(this, false);
+  }
+
+  // do_io_write drops the op of a replaced reader, so a result is always for the reader of @a buf.
+  if (write_op->take_result(r)) {
+    if (r > 0) {
+      buf.reader()->consume(r);
+    }
+    return IOUringNetResult::COMPLETE;
+  }
+
+  if (write_op->state == UnixNetIOUringOp::State::IN_FLIGHT) {
+    return IOUringNetResult::PENDING;
+  }
+
+  IOBufferReader *tmp_reader = buf.reader()->clone();
+  IOBufferBlock *first       = tmp_reader->get_current_block();
+  int64_t try_to_write       = 0;
+  unsigned niov              = 0;
+  while (niov < NET_MAX_IOV && try_to_write < towrite) {
+    int64_t len = std::min(tmp_reader->block_read_avail(), towrite - try_to_write);
+    if (len <= 0) {
+      break;
+    }
+    write_op->iov[niov].iov_base  = tmp_reader->start();
+    write_op->iov[niov].iov_len   = len;
+    try_to_write                 += len;
+    niov++;
+    tmp_reader->consume(len);
+  }
+  tmp_reader->dealloc();
+  ink_assert(niov > 0);
+
+  if (!write_op->submit(first, niov)) {
+    return IOUringNetResult::FALLBACK;
+  }
+  NET_INCREMENT_DYN_STAT(net_io_uring_writes_submitted_stat);
+  return IOUringNetResult::PENDING;
+}
+
+bool
+UnixNetIOUringOp::submit(IOBufferBlock *block, unsigned n)
+{
+  IOUringContext *ur = IOUringContext::local_context();
+  io_uring_sqe *sqe  = ur->next_sqe(this);
+
+  if (sqe == nullptr) {
+    // The submission queue is full, flush it and try once more.
+    ur->submit();
+    if ((sqe = ur->next_sqe(this)) == nullptr) {
+      return false;
+    }
+  }
+
+  niov   = n;
+  _block = block;
+  ink_zero(_msg);
+  _msg.msg_iov    = &iov[0];
+  _msg.msg_iovlen = niov;
+  if (_is_read) {
+    io_uring_prep_recvmsg(sqe, _vc->con.fd, &_msg, 0);
+  } else {
+    io_uring_prep_sendmsg(sqe, _vc->con.fd, &_msg, MSG_NOSIGNAL);
+  }
+  state = State::IN_FLIGHT;
+  return true;
+}
+
+bool
+UnixNetIOUringOp::take_result(int64_t &r)
+{
+  if (state != State::COMPLETE) {
+    return false;
+  }
+  r     = _result;
+  state = State::IDLE;
+  _block.clear();
+  return true;
+}
+
+void
+UnixNetIOUringOp::handle_complete(io_uring_cqe *cqe)
+{
+  if (_vc == nullptr) {
+    // The VC was closed and this is the completion of the cancelled request.
+    delete this;
+    return;
+  }
+
+  _result = cqe->res;
+  state   = State::COMPLETE;
+
+  // Treat the completion like a readiness event, the result is picked up by read_from_net / write_to_net.
+  NetHandler *nh = _vc->nh;
+  if (_is_read) {
+    _vc->read.triggered = 1;
+    if (_vc->read.enabled) {
+      nh->read_ready_list.in_or_enqueue(_vc);
+    }
+  } else {
+    _vc->write.triggered = 1;
+    if (_vc->write.enabled) {
+      nh->write_ready_list.in_or_enqueue(_vc);
+    }
+  }
+}
+
+namespace
+{
+// Completions of cancel requests carry no state.
+class IOUringCancelHandler : public IOUringCompletionHandler
+{
+public:
+  void
+  handle_complete(io_uring_cqe *) override
+  {
+  }
+} io_uring_cancel_handler;
+} // namespace
+
+void
+UnixNetIOUringOp::detach()
+{
+  _vc = nullptr;
+  if (state != State::IN_FLIGHT) {
+    delete this;
+    return;
+  }
+
+  // The op frees itself when the (cancelled) request completes. If the cancel cannot be queued the
+  // request still completes once the peer sends data or resets the connection.
+  IOUringContext *ur = IOUringContext::local_context();
+  io_uring_sqe *sqe  = ur->next_sqe(&io_uring_cancel_handler);
+  if (sqe == nullptr) {
+    ur->submit();
+    sqe = ur->next_sqe(&io_uring_cancel_handler);
+  }
+  if (sqe != nullptr) {
+    io_uring_prep_cancel(sqe, this, 0);
+  }
+}
+#endif
+
 void
 UnixNetVConnection::readDisable(NetHandler *nh)
 {
@@ -1247,6 +1524,17 @@ fail:
 void
 UnixNetVConnection::clear()
 {
+#if TS_USE_LINUX_IO_URING
+  if (read_op != nullptr) {
+    read_op->detach();
+    read_op = nullptr;
+  }
+  if (write_op != nullptr) {
+    write_op->detach();
+    write_op = nullptr;
+  }
+#endif
+
   // clear timeout variables
   next_inactivity_timeout_at = 0;
   next_activity_timeout_at   = 0;
@@ -1320,6 +1608,20 @@ UnixNetVConnection::set_inactivity_timeout(ink_hrtime timeout_in)
   Debug("socket", "Set inactive timeout=%" PRId64 ", for NetVC=%p", timeout_in, this);
   inactivity_timeout_in      = timeout_in;
   next_inactivity_timeout_at = (timeout_in > 0) ? ink_get_hrtime() + inactivity_timeout_in : 0;
+  if (nh) {
+    nh->update_timeout(this);
+  }
+}
+
+void
+UnixNetVConnection::set_active_timeout(ink_hrtime timeout_in)
+{
+  Debug("socket", "Set active timeout=%" PRId64 ", NetVC=%p", timeout_in, this);
+  active_timeout_in        = timeout_in;
+  next_activity_timeout_at = (active_timeout_in > 0) ? ink_get_hrtime() + timeout_in : 0;
+  if (nh) {
+    nh->update_timeout(this);
+  }
 }
 
 TS_INLINE void
@@ -0,0 +1,70 @@
+/** @file
+
+  Catch based unit tests for NetHandler
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "catch.hpp"
+
+#include "P_Net.h"
+#include "AsyncSignalEventIO.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+TEST_CASE("NetHandler pollActivity", "[net][busy_poll]")
+{
+  // The net handler of a thread that is not started, polled from here as its busy poll would.
+  unix_netProcessor.netHandler_offset = eventProcessor.allocate(sizeof(NetHandler));
+  unix_netProcessor.pollCont_offset   = eventProcessor.allocate(sizeof(PollCont));
+  REQUIRE(unix_netProcessor.pollCont_offset > 0);
+  EThread *t = new EThread(REGULAR, -1);
+  initialize_thread_for_net(t);
+  NetHandler *nh = get_NetHandler(t);
+  REQUIRE(t->tail_cb == nh);
+
+  // Nothing ready.
+  CHECK(!nh->pollActivity());
+
+  SECTION("readable socket")
+  {
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    AsyncSignalEventIO io;
+    REQUIRE(io.start(get_PollDescriptor(t), fds[0], EVENTIO_READ) >= 0);
+
+    CHECK(!nh->pollActivity());
+    REQUIRE(write(fds[1], "x", 1) == 1);
+    CHECK(nh->pollActivity());
+    // Handled by the poll, nothing is left.
+    CHECK(!nh->pollActivity());
+
+    io.stop();
+    close(fds[0]);
+    close(fds[1]);
+  }
+
+  SECTION("thread signaled")
+  {
+    nh->signalActivity();
+    CHECK(nh->pollActivity());
+    CHECK(!nh->pollActivity());
+  }
+}
@@ -22,6 +22,8 @@
 
 #include "P_Cache.h"
 #include <tscore/TSSystemState.h>
+
+#include <cxxabi.h>
 #include "rpc/handlers/common/ErrorUtils.h"
 #include "rpc/handlers/common/Utils.h"
 
@@ -30,6 +32,16 @@ namespace rpc::handlers::server
 namespace field_names
 {
   static constexpr auto NEW_CONNECTIONS{"no_new_connections"};
+
+  static constexpr auto THRESHOLD{"threshold_ms"};
+  static constexpr auto STALLS{"stalls"};
+  static constexpr auto THREAD{"thread"};
+  static constexpr auto AGE{"age_ms"};
+  static constexpr auto DURATION{"duration_ms"};
+  static constexpr auto EVENT{"event"};
+  static constexpr auto TYPE{"type"};
+  static constexpr auto HANDLER_NAME{"handler_name"};
+  static constexpr auto PLUGIN_FUNCTION{"plugin_function"};
 } // namespace field_names
 
 struct DrainInfo {
@@ -112,6 +124,48 @@ server_stop_drain(std::string_view const &id, [[maybe_unused]] YAML::Node const
   return resp;
 }
 
+/// Demangled @a type name, else the name as is.
+static std::string
+demangle(const char *type)
+{
+  int status      = 0;
+  char *demangled = abi::__cxa_demangle(type, nullptr, nullptr, &status);
+  std::string text{status == 0 ? demangled : type};
+  ::free(demangled);
+  return text;
+}
+
+ts::Rv<YAML::Node>
+server_get_stalls(std::string_view const &id, [[maybe_unused]] YAML::Node const &params)
+{
+  namespace field = field_names;
+  ts::Rv<YAML::Node> resp;
+  YAML::Node stalls{YAML::NodeType::Sequence};
+  ink_hrtime now = ink_get_hrtime();
+
+  for (EThread *t : eventProcessor.active_ethreads()) {
+    for (auto const &entry : t->stalls.entries()) {
+      YAML::Node n;
+      n[field::THREAD]   = t->id;
+      n[field::AGE]      = ink_hrtime_to_msec(now - entry.start);
+      n[field::DURATION] = ink_hrtime_to_msec(entry.duration);
+      n[field::EVENT]    = entry.event;
+      n[field::TYPE]     = demangle(entry.type);
+      if (entry.name) {
+        n[field::HANDLER_NAME] = entry.name;
+      }
+      if (entry.plugin) {
+        std::string text;
+        n[field::PLUGIN_FUNCTION] = swoc::bwprint(text, "{:p}", entry.plugin);
+      }
+      stalls.push_back(n);
+    }
+  }
+  resp.result()[field::THRESHOLD] = thread_stall_threshold_mseconds;
+  resp.result()[field::STALLS]    = stalls;
+  return resp;
+}
+
 void
 server_shutdown(YAML::Node const &)
 {
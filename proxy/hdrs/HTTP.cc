@@ -300,20 +300,20 @@ http_hdr_init(HdrHeap *heap, HTTPHdrImpl *hh, HTTPType polarity, HTTPVersion ver
     switch (polarity) {
     case HTTP_TYPE_REQUEST:
       field = mime_field_create_named(heap, hh->m_fields_impl, PSEUDO_HEADER_METHOD.data(), PSEUDO_HEADER_METHOD.size());
-      mime_hdr_field_attach(hh->m_fields_impl, field, false, nullptr);
+      mime_hdr_field_attach(hh->m_fields_impl, field, false, nullptr, heap);
 
       field = mime_field_create_named(heap, hh->m_fields_impl, PSEUDO_HEADER_SCHEME.data(), PSEUDO_HEADER_SCHEME.size());
-      mime_hdr_field_attach(hh->m_fields_impl, field, false, nullptr);
+      mime_hdr_field_attach(hh->m_fields_impl, field, false, nullptr, heap);
 
       field = mime_field_create_named(heap, hh->m_fields_impl, PSEUDO_HEADER_AUTHORITY.data(), PSEUDO_HEADER_AUTHORITY.size());
-      mime_hdr_field_attach(hh->m_fields_impl, field, false, nullptr);
+      mime_hdr_field_attach(hh->m_fields_impl, field, false, nullptr, heap);
 
       field = mime_field_create_named(heap, hh->m_fields_impl, PSEUDO_HEADER_PATH.data(), PSEUDO_HEADER_PATH.size());
-      mime_hdr_field_attach(hh->m_fields_impl, field, false, nullptr);
+      mime_hdr_field_attach(hh->m_fields_impl, field, false, nullptr, heap);
       break;
     case HTTP_TYPE_RESPONSE:
       field = mime_field_create_named(heap, hh->m_fields_impl, PSEUDO_HEADER_STATUS.data(), PSEUDO_HEADER_STATUS.size());
-      mime_hdr_field_attach(hh->m_fields_impl, field, false, nullptr);
+      mime_hdr_field_attach(hh->m_fields_impl, field, false, nullptr, heap);
       break;
     default:
       ink_abort("HTTP_TYPE_UNKNOWN");
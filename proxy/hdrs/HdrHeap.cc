@@ -49,7 +49,8 @@ Allocator strHeapAllocator("hdrStrHeap", HdrStrHeap::DEFAULT_SIZE);
 void
 obj_describe(HdrHeapObjImpl *obj, bool recurse)
 {
-  static const char *obj_names[] = {"EMPTY", "RAW", "URL", "HTTP_HEADER", "MIME_HEADER", "FIELD_BLOCK"};
+  static const char *obj_names[] = {"EMPTY",       "RAW",        "URL",        "HTTP_HEADER", "MIME_HEADER",
+                                    "FIELD_BLOCK", "STANDALONE", "SDK_HANDLE", "FIELD_INDEX"};
 
   Debug("http", "%s %p: [T: %d, L: %4d, OBJFLAGS: %X]  ", obj_names[obj->m_type], obj, obj->m_type, obj->m_length,
         obj->m_obj_flags);
@@ -413,6 +414,7 @@ HdrHeap::evacuate_from_str_heaps(HdrStrHeap *new_heap)
         break;
       case HDR_HEAP_OBJ_EMPTY:
       case HDR_HEAP_OBJ_RAW:
+      case HDR_HEAP_OBJ_FIELD_INDEX:
         // Nothing to do
         break;
       default:
@@ -456,6 +458,7 @@ HdrHeap::required_space_for_evacuation()
         break;
       case HDR_HEAP_OBJ_EMPTY:
       case HDR_HEAP_OBJ_RAW:
+      case HDR_HEAP_OBJ_FIELD_INDEX:
         // Nothing to do
         break;
       default:
@@ -533,6 +536,7 @@ HdrHeap::sanity_check_strs()
         break;
       case HDR_HEAP_OBJ_EMPTY:
       case HDR_HEAP_OBJ_RAW:
+      case HDR_HEAP_OBJ_FIELD_INDEX:
         // Nothing to do
         break;
       default:
@@ -782,6 +786,10 @@ HdrHeap::marshal(char *buf, int len)
           goto Failed;
         }
         break;
+      case HDR_HEAP_OBJ_FIELD_INDEX:
+        // Only speeds up lookups in a writable header, not worth its space in the cache.
+        obj->m_type = HDR_HEAP_OBJ_EMPTY;
+        break;
       case HDR_HEAP_OBJ_EMPTY:
       case HDR_HEAP_OBJ_RAW:
         // Check to make sure we aren't stuck
@@ -22,7 +22,6 @@
  */
 
 #include "tscore/ink_platform.h"
-#include "tscore/HashFNV.h"
 #include "tscore/Diags.h"
 #include "tscore/ink_memory.h"
 #include <cstdio>
@@ -33,6 +32,10 @@
 #include "tscore/Regex.h"
 #include "URL.h"
 
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+
 /*
  You SHOULD add to _hdrtoken_commonly_tokenized_strs, with the same ordering
  ** important, ordering matters **
@@ -271,34 +274,129 @@ DFA *hdrtoken_strs_dfa = nullptr;
  *                                                                     *
  ***********************************************************************/
 
-#define HDRTOKEN_HASH_TABLE_SIZE 65536
+/*
+  The commonly tokenized strings are found through a minimal perfect hash
+  which is built at compile time from _hdrtoken_commonly_tokenized_strs,
+  so that it always matches the list and costs nothing at startup. A
+  string is reduced to its length and its first and last (up to) 8 bytes,
+  case folded by setting the 0x20 bit of every byte, which is enough to
+  tell every well-known string apart. The first hash picks a bucket, and
+  the displacement stored for that bucket seeds a second hash which picks
+  the one slot which can hold a match. The table is a few hundred bytes
+  instead of a 64K entry hash table, and a candidate is confirmed with a
+  real case insensitive compare rather than a hash compare.
+*/
 
-struct HdrTokenHashBucket {
-  const char *wks;
-  uint32_t hash;
+namespace
+{
+struct HdrTokenHashKey {
+  uint64_t head;
+  uint64_t tail;
+  uint64_t length;
 };
 
-HdrTokenHashBucket hdrtoken_hash_table[HDRTOKEN_HASH_TABLE_SIZE];
+// Little endian loads, written so that they are usable in constant expressions. The compiler
+// turns each of these into a single load.
+constexpr uint64_t
+hdrtoken_load64(const char *p)
+{
+  return static_cast<uint64_t>(static_cast<uint8_t>(p[0])) | static_cast<uint64_t>(static_cast<uint8_t>(p[1])) << 8 |
+         static_cast<uint64_t>(static_cast<uint8_t>(p[2])) << 16 | static_cast<uint64_t>(static_cast<uint8_t>(p[3])) << 24 |
+         static_cast<uint64_t>(static_cast<uint8_t>(p[4])) << 32 | static_cast<uint64_t>(static_cast<uint8_t>(p[5])) << 40 |
+         static_cast<uint64_t>(static_cast<uint8_t>(p[6])) << 48 | static_cast<uint64_t>(static_cast<uint8_t>(p[7])) << 56;
+}
+
+constexpr uint64_t
+hdrtoken_load32(const char *p)
+{
+  return static_cast<uint64_t>(static_cast<uint8_t>(p[0])) | static_cast<uint64_t>(static_cast<uint8_t>(p[1])) << 8 |
+         static_cast<uint64_t>(static_cast<uint8_t>(p[2])) << 16 | static_cast<uint64_t>(static_cast<uint8_t>(p[3])) << 24;
+}
+
+constexpr uint64_t HDRTOKEN_FOLD = 0x2020202020202020ULL;
 
-/**
-  basic FNV hash
-**/
-#define TINY_MASK(x) (((uint32_t)1 << (x)) - 1)
+constexpr HdrTokenHashKey
+hdrtoken_hash_key(const char *string, int length)
+{
+  HdrTokenHashKey key{0, 0, static_cast<uint64_t>(length)};
+
+  if (length >= 8) {
+    key.head = hdrtoken_load64(string);
+    key.tail = hdrtoken_load64(string + length - 8);
+  } else if (length >= 4) {
+    key.head = hdrtoken_load32(string);
+    key.tail = hdrtoken_load32(string + length - 4);
+  } else if (length > 0) {
+    key.head = static_cast<uint8_t>(string[0]) | static_cast<uint8_t>(string[length / 2]) << 8 |
+               static_cast<uint8_t>(string[length - 1]) << 16;
+  }
+  key.head |= HDRTOKEN_FOLD;
+  key.tail |= HDRTOKEN_FOLD;
+  return key;
+}
+
+constexpr uint64_t
+hdrtoken_hash(const HdrTokenHashKey &key, uint64_t seed)
+{
+  uint64_t h  = (key.head + seed) * 0x9e3779b97f4a7c15ULL;
+  h           = (h ^ key.tail ^ key.length) * 0xd6e8feb86659fd93ULL;
+  h          ^= h >> 32;
+  return h;
+}
+
+// Map the high or low 32 bits of a hash onto [0, n) without a division.
+constexpr uint32_t
+hdrtoken_hash_range(uint64_t h, uint32_t n)
+{
+  return static_cast<uint32_t>((static_cast<uint64_t>(static_cast<uint32_t>(h)) * n) >> 32);
+}
 
-inline uint32_t
-hash_to_slot(uint32_t hash)
+/// ASCII lower case of 8 bytes at once, bytes with the high bit set are left alone.
+inline uint64_t
+hdrtoken_tolower64(uint64_t x)
 {
-  return ((hash >> 15) ^ hash) & TINY_MASK(15);
+  constexpr uint64_t ONES = 0x0101010101010101ULL;
+
+  uint64_t heptets = x & (0x7f * ONES);
+  uint64_t ge_A    = heptets + ((0x80 - 'A') * ONES);
+  uint64_t gt_Z    = heptets + ((0x80 - 'Z' - 1) * ONES);
+  uint64_t upper   = ge_A & ~gt_Z & ~x & (0x80 * ONES);
+
+  return x | (upper >> 2);
 }
 
-inline uint32_t
-hdrtoken_hash(const unsigned char *string, unsigned int length)
+/// Case insensitive compare of @a length bytes, 8 at a time.
+inline bool
+hdrtoken_equal_nocase(const char *a, const char *b, int length)
 {
-  ATSHash32FNV1a fnv;
-  fnv.update(string, length, ATSHash::nocase());
-  fnv.final();
-  return fnv.get();
+  if (length < 8) {
+    for (int i = 0; i < length; ++i) {
+      if (ParseRules::ink_tolower(a[i]) != ParseRules::ink_tolower(b[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  uint64_t x;
+  uint64_t y;
+  int i = 0;
+  for (; i + 8 <= length; i += 8) {
+    memcpy(&x, a + i, sizeof(x));
+    memcpy(&y, b + i, sizeof(y));
+    if (hdrtoken_tolower64(x) != hdrtoken_tolower64(y)) {
+      return false;
+    }
+  }
+  if (i < length) {
+    // Overlap the last full word rather than finishing byte by byte.
+    memcpy(&x, a + length - 8, sizeof(x));
+    memcpy(&y, b + length - 8, sizeof(y));
+    return hdrtoken_tolower64(x) == hdrtoken_tolower64(y);
+  }
+  return true;
 }
+} // namespace
 
 /*-------------------------------------------------------------------------
   -------------------------------------------------------------------------*/
@@ -306,7 +404,7 @@ hdrtoken_hash(const unsigned char *string, unsigned int length)
 // WARNING:  Indexes into this array are stored on disk for cached objects.  New strings must be added at the end of the array to
 // avoid changing the indexes of pre-existing entries, unless the cache format version number is increased.
 //
-static const char *_hdrtoken_commonly_tokenized_strs[] = {
+constexpr std::string_view _hdrtoken_commonly_tokenized_strs[] = {
   // MIME Field names
   "Accept-Charset", "Accept-Encoding", "Accept-Language", "Accept-Ranges", "Accept", "Age", "Allow",
   "Approved", // NNTP
@@ -380,37 +478,100 @@ static const char *_hdrtoken_commonly_tokenized_strs[] = {
 /*-------------------------------------------------------------------------
   -------------------------------------------------------------------------*/
 
-void
-hdrtoken_hash_init()
+namespace
 {
-  uint32_t i;
-  int num_collisions;
-
-  memset(hdrtoken_hash_table, 0, sizeof(hdrtoken_hash_table));
-  num_collisions = 0;
-
-  for (i = 0; i < static_cast<int> SIZEOF(_hdrtoken_commonly_tokenized_strs); i++) {
-    // convert the common string to the well-known token
-    unsigned const char *wks;
-    int wks_idx =
-      hdrtoken_tokenize_dfa(_hdrtoken_commonly_tokenized_strs[i], static_cast<int>(strlen(_hdrtoken_commonly_tokenized_strs[i])),
-                            reinterpret_cast<const char **>(&wks));
-    ink_release_assert(wks_idx >= 0);
+constexpr uint32_t HDRTOKEN_HASH_KEYS    = std::size(_hdrtoken_commonly_tokenized_strs);
+constexpr uint32_t HDRTOKEN_HASH_BUCKETS = (HDRTOKEN_HASH_KEYS + 3) / 4;
+
+struct HdrTokenPerfectHash {
+  uint16_t displacement[HDRTOKEN_HASH_BUCKETS]; // bucket -> seed of the slot hash
+  uint16_t key[HDRTOKEN_HASH_KEYS];             // slot -> index in _hdrtoken_commonly_tokenized_strs
+
+  constexpr uint32_t
+  slot(const HdrTokenHashKey &k) const
+  {
+    uint32_t bucket = hdrtoken_hash_range(hdrtoken_hash(k, 0), HDRTOKEN_HASH_BUCKETS);
+    return hdrtoken_hash_range(hdrtoken_hash(k, displacement[bucket]) >> 32, HDRTOKEN_HASH_KEYS);
+  }
+};
 
-    uint32_t hash = hdrtoken_hash(wks, hdrtoken_str_lengths[wks_idx]);
-    uint32_t slot = hash_to_slot(hash);
+// Hash and displace: place the buckets largest first, each with the first seed which moves all
+// of its keys to distinct free slots. Fails to compile if the strings can not be told apart.
+constexpr HdrTokenPerfectHash
+hdrtoken_perfect_hash_build()
+{
+  HdrTokenPerfectHash table{};
+  HdrTokenHashKey keys[HDRTOKEN_HASH_KEYS]{};
+  uint32_t key_bucket[HDRTOKEN_HASH_KEYS]{};
+  uint32_t bucket_size[HDRTOKEN_HASH_BUCKETS]{};
+  bool taken[HDRTOKEN_HASH_KEYS]{};
+  uint32_t max_size = 0;
+
+  for (uint32_t i = 0; i < HDRTOKEN_HASH_KEYS; ++i) {
+    keys[i]       = hdrtoken_hash_key(_hdrtoken_commonly_tokenized_strs[i].data(), _hdrtoken_commonly_tokenized_strs[i].size());
+    key_bucket[i] = hdrtoken_hash_range(hdrtoken_hash(keys[i], 0), HDRTOKEN_HASH_BUCKETS);
+    max_size      = std::max(max_size, ++bucket_size[key_bucket[i]]);
+  }
 
-    if (hdrtoken_hash_table[slot].wks) {
-      printf("ERROR: hdrtoken_hash_table[%u] collision: '%s' replacing '%s'\n", slot, reinterpret_cast<const char *>(wks),
-             hdrtoken_hash_table[slot].wks);
-      ++num_collisions;
+  for (uint32_t size = max_size; size > 0; --size) {
+    for (uint32_t b = 0; b < HDRTOKEN_HASH_BUCKETS; ++b) {
+      if (bucket_size[b] != size) {
+        continue;
+      }
+      for (uint32_t seed = 1;; ++seed) {
+        if (seed > UINT16_MAX) {
+          throw "no perfect hash for the well-known strings";
+        }
+        uint32_t slots[HDRTOKEN_HASH_KEYS]{};
+        uint32_t n  = 0;
+        bool placed = true;
+        for (uint32_t i = 0; i < HDRTOKEN_HASH_KEYS && placed; ++i) {
+          if (key_bucket[i] != b) {
+            continue;
+          }
+          uint32_t slot = hdrtoken_hash_range(hdrtoken_hash(keys[i], seed) >> 32, HDRTOKEN_HASH_KEYS);
+          placed        = !taken[slot];
+          for (uint32_t j = 0; j < n && placed; ++j) {
+            placed = slots[j] != slot;
+          }
+          slots[n++] = slot;
+        }
+        if (placed) {
+          table.displacement[b] = seed;
+          n                     = 0;
+          for (uint32_t i = 0; i < HDRTOKEN_HASH_KEYS; ++i) {
+            if (key_bucket[i] == b) {
+              taken[slots[n]]       = true;
+              table.key[slots[n++]] = i;
+            }
+          }
+          break;
+        }
+      }
     }
-    hdrtoken_hash_table[slot].wks  = reinterpret_cast<const char *>(wks);
-    hdrtoken_hash_table[slot].hash = hash;
   }
+  return table;
+}
+
+constexpr HdrTokenPerfectHash hdrtoken_perfect_hash = hdrtoken_perfect_hash_build();
+
+// slot -> well-known string, filled in once the heap of well-known strings exists.
+const char *hdrtoken_hash_table[HDRTOKEN_HASH_KEYS];
+} // namespace
+
+void
+hdrtoken_hash_init()
+{
+  for (uint32_t i = 0; i < HDRTOKEN_HASH_KEYS; i++) {
+    // convert the common string to the well-known token
+    std::string_view str = _hdrtoken_commonly_tokenized_strs[i];
+    const char *wks;
+    int wks_idx = hdrtoken_tokenize_dfa(str.data(), static_cast<int>(str.size()), &wks);
+    ink_release_assert(wks_idx >= 0);
 
-  if (num_collisions > 0) {
-    abort();
+    uint32_t slot = hdrtoken_perfect_hash.slot(hdrtoken_hash_key(wks, hdrtoken_str_lengths[wks_idx]));
+    ink_release_assert(hdrtoken_perfect_hash.key[slot] == i);
+    hdrtoken_hash_table[slot] = wks;
   }
 }
 
@@ -588,7 +749,6 @@ int
 hdrtoken_tokenize(const char *string, int string_len, const char **wks_string_out)
 {
   int wks_idx;
-  HdrTokenHashBucket *bucket;
 
   ink_assert(string != nullptr);
 
@@ -600,14 +760,11 @@ hdrtoken_tokenize(const char *string, int string_len, const char **wks_string_ou
     return wks_idx;
   }
 
-  uint32_t hash = hdrtoken_hash(reinterpret_cast<const unsigned char *>(string), static_cast<unsigned int>(string_len));
-  uint32_t slot = hash_to_slot(hash);
-
-  bucket = &(hdrtoken_hash_table[slot]);
-  if ((bucket->wks != nullptr) && (bucket->hash == hash) && (hdrtoken_wks_to_length(bucket->wks) == string_len)) {
-    wks_idx = hdrtoken_wks_to_index(bucket->wks);
+  const char *wks = hdrtoken_hash_table[hdrtoken_perfect_hash.slot(hdrtoken_hash_key(string, string_len))];
+  if ((wks != nullptr) && (hdrtoken_wks_to_length(wks) == string_len) && hdrtoken_equal_nocase(wks, string, string_len)) {
+    wks_idx = hdrtoken_wks_to_index(wks);
     if (wks_string_out) {
-      *wks_string_out = bucket->wks;
+      *wks_string_out = wks;
     }
     return wks_idx;
   }
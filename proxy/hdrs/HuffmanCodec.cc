@@ -23,6 +23,7 @@
 
 #include "HuffmanCodec.h"
 #include "tscore/ink_platform.h"
+#include "tscore/ink_assert.h"
 #include "tscore/ink_memory.h"
 #include "tscore/ink_defs.h"
 
@@ -293,20 +294,47 @@ static const huffman_entry huffman_table[] = {
 
 using Node = struct node {
   node *left, *right;
-  char ascii_code;
+  uint16_t symbol;
   bool leaf_node;
+  uint8_t state;
+  uint8_t depth;
+  bool all_ones;
 };
 
-Node *HUFFMAN_TREE_ROOT;
+// Flat decoding table, built from the Huffman tree by hpack_huffman_init(). Each state is an
+// internal node of the tree and each entry gives, for the next octet of input, the state it leads
+// to and the symbols completed on the way. Codes are at least 5 bits long, so an octet completes
+// at most two symbols.
+enum {
+  HUFFMAN_DECODE_ACCEPT = 0x1, // the bits since the last symbol are valid padding
+  HUFFMAN_DECODE_FAIL   = 0x2, // EOS was decoded
+};
+
+struct huffman_decode_entry {
+  uint8_t state;
+  uint8_t flags;
+  uint8_t symbol_count;
+  uint8_t symbol[2];
+};
+
+// The 256 octets and EOS are 257 leaves, so the tree has 256 internal nodes.
+static constexpr unsigned HUFFMAN_EOS      = 256;
+static constexpr int HUFFMAN_DECODE_STATES = 256;
+
+static huffman_decode_entry huffman_decode_table[HUFFMAN_DECODE_STATES][256];
+static bool huffman_decode_table_ready = false;
 
 static Node *
 make_huffman_tree_node()
 {
-  Node *n       = static_cast<Node *>(ats_malloc(sizeof(Node)));
-  n->left       = nullptr;
-  n->right      = nullptr;
-  n->ascii_code = '\0';
-  n->leaf_node  = false;
+  Node *n      = static_cast<Node *>(ats_malloc(sizeof(Node)));
+  n->left      = nullptr;
+  n->right     = nullptr;
+  n->symbol    = 0;
+  n->leaf_node = false;
+  n->state     = 0;
+  n->depth     = 0;
+  n->all_ones  = false;
   return n;
 }
 
@@ -334,8 +362,8 @@ make_huffman_tree()
       }
       bit_len--;
     }
-    current->ascii_code = i;
-    current->leaf_node  = true;
+    current->symbol    = i;
+    current->leaf_node = true;
   }
 
   return root;
@@ -354,126 +382,136 @@ free_huffman_tree(Node *node)
   ats_free(node);
 }
 
+// Number the internal nodes, the root being state 0, and note for each whether the path to it
+// is all 1 bits, which is what padding must look like.
+static int
+number_huffman_tree(Node *node, Node **states, int next, uint8_t depth, bool all_ones)
+{
+  if (node->leaf_node) {
+    return next;
+  }
+
+  node->state    = next;
+  node->depth    = depth;
+  node->all_ones = all_ones;
+  states[next++] = node;
+
+  next = number_huffman_tree(node->left, states, next, depth + 1, false);
+  return number_huffman_tree(node->right, states, next, depth + 1, all_ones);
+}
+
+static void
+make_huffman_decode_table(Node *root)
+{
+  Node *states[HUFFMAN_DECODE_STATES];
+
+  ink_release_assert(number_huffman_tree(root, states, 0, 0, true) == HUFFMAN_DECODE_STATES);
+
+  for (int s = 0; s < HUFFMAN_DECODE_STATES; ++s) {
+    for (int octet = 0; octet < 256; ++octet) {
+      huffman_decode_entry &entry = huffman_decode_table[s][octet];
+      Node *current               = states[s];
+
+      entry = {0, 0, 0, {0, 0}};
+      for (int shift = 7; shift >= 0; --shift) {
+        current = (octet & (1 << shift)) ? current->right : current->left;
+        if (current->leaf_node) {
+          if (current->symbol == HUFFMAN_EOS) {
+            entry.flags = HUFFMAN_DECODE_FAIL;
+            break;
+          }
+          entry.symbol[entry.symbol_count++] = current->symbol;
+          current                            = root;
+        }
+      }
+
+      if (entry.flags & HUFFMAN_DECODE_FAIL) {
+        continue;
+      }
+      entry.state = current->state;
+      // [RFC 7541] 5.2. Padding strictly longer than 7 bits MUST be treated as a decoding error.
+      if (current->all_ones && current->depth <= 7) {
+        entry.flags |= HUFFMAN_DECODE_ACCEPT;
+      }
+    }
+  }
+}
+
 void
 hpack_huffman_init()
 {
-  if (!HUFFMAN_TREE_ROOT) {
-    HUFFMAN_TREE_ROOT = make_huffman_tree();
+  if (!huffman_decode_table_ready) {
+    Node *root = make_huffman_tree();
+    make_huffman_decode_table(root);
+    free_huffman_tree(root);
+    huffman_decode_table_ready = true;
   }
 }
 
 void
 hpack_huffman_fin()
 {
-  if (HUFFMAN_TREE_ROOT) {
-    free_huffman_tree(HUFFMAN_TREE_ROOT);
-  }
+  // The decoding table is static and stays valid, nothing to free.
 }
 
-#define MAX_HUFFMAN_CODE_LEN 30
-#define EOS                  0x3fffffff
-
 int64_t
 huffman_decode(char *dst_start, const uint8_t *src, uint32_t src_len)
 {
-  char *dst_end      = dst_start;
-  uint8_t shift      = 7;
-  Node *current      = HUFFMAN_TREE_ROOT;
-  int nbits          = 0;
-  uint32_t curr_bits = 0;
-
-  while (src_len) {
-    if (nbits > 0) {
-      curr_bits <<= 1;
-    }
-    if (*src & (1 << shift)) {
-      curr_bits |= 1;
-      current    = current->right;
-    } else {
-      current = current->left;
-    }
-    ++nbits;
+  char *dst_end = dst_start;
+  uint8_t state = 0;
+  uint8_t flags = HUFFMAN_DECODE_ACCEPT;
 
-    if (current->leaf_node == true) {
-      if (curr_bits == EOS) {
-        return -1;
-      }
-      nbits     = 0;
-      curr_bits = 0;
-      *dst_end  = current->ascii_code;
-      ++dst_end;
-      current = HUFFMAN_TREE_ROOT;
-    }
-
-    if (shift) {
-      --shift;
-    } else {
-      shift = 7;
-      ++src;
-      --src_len;
-    }
+  for (const uint8_t *src_end = src + src_len; src < src_end; ++src) {
+    const huffman_decode_entry &entry = huffman_decode_table[state][*src];
 
-    if (nbits > MAX_HUFFMAN_CODE_LEN) {
+    if (entry.flags & HUFFMAN_DECODE_FAIL) {
       return -1;
     }
-  }
-
-  if (nbits > 7) {
-    return -1;
+    for (int i = 0; i < entry.symbol_count; ++i) {
+      *dst_end++ = entry.symbol[i];
+    }
+    state = entry.state;
+    flags = entry.flags;
   }
 
   // Padding bits must be a prefix of EOS
-  uint8_t mask = (1 << nbits) - 1;
-  if ((mask & curr_bits) != mask) {
+  if (!(flags & HUFFMAN_DECODE_ACCEPT)) {
     return -1;
   }
 
   return dst_end - dst_start;
 }
 
-uint8_t *
-huffman_encode_append(uint8_t *dst, uint32_t src, int n = 0)
-{
-  for (int j = 3; j >= n; --j) {
-    *dst++ = ((src >> (8 * j)) & 255);
-  }
-  return dst;
-}
-
 int64_t
 huffman_encode(uint8_t *dst_start, const uint8_t *src, uint32_t src_len)
 {
   uint8_t *dst = dst_start;
-  // NOTE: The maximum length of Huffman Code is 30, thus using uint32_t as buffer.
-  uint32_t buf         = 0;
-  uint32_t remain_bits = 32;
+  // NOTE: Codes are appended to the low end of buf and written out 32 bits at a time. The maximum
+  // length of Huffman Code is 30, so no more than 31 + 30 bits are ever pending.
+  uint64_t buf  = 0;
+  uint32_t bits = 0;
 
   for (uint32_t i = 0; i < src_len; ++i) {
-    const uint32_t hex     = huffman_table[src[i]].code_as_hex;
-    const uint32_t bit_len = huffman_table[src[i]].bit_len;
-
-    if (remain_bits > bit_len) {
-      remain_bits  = remain_bits - bit_len;
-      buf         |= hex << remain_bits;
-    } else if (remain_bits == bit_len) {
-      buf         |= hex;
-      dst          = huffman_encode_append(dst, buf);
-      remain_bits  = 32;
-      buf          = 0;
-    } else {
-      buf         |= hex >> (bit_len - remain_bits);
-      dst          = huffman_encode_append(dst, buf);
-      remain_bits  = (32 - (bit_len - remain_bits));
-      buf          = hex << remain_bits;
+    const huffman_entry &code = huffman_table[src[i]];
+
+    buf   = (buf << code.bit_len) | code.code_as_hex;
+    bits += code.bit_len;
+    if (bits >= 32) {
+      bits          -= 32;
+      uint32_t word  = htonl(static_cast<uint32_t>(buf >> bits));
+      memcpy(dst, &word, sizeof(word));
+      dst += sizeof(word);
     }
   }
 
-  dst = huffman_encode_append(dst, buf, remain_bits / 8);
-
   // NOTE: Add padding w/ EOS
-  uint32_t pad_len = remain_bits % 8;
-  if (pad_len) {
-    *(dst - 1) |= 0xff >> (8 - pad_len);
+  uint32_t pad_len  = (8 - bits % 8) % 8;
+  buf               = (buf << pad_len) | ((1 << pad_len) - 1);
+  bits             += pad_len;
+
+  while (bits) {
+    bits   -= 8;
+    *dst++  = static_cast<uint8_t>(buf >> bits);
   }
 
   return dst - dst_start;
@@ -24,11 +24,15 @@
 #include "tscore/ink_defs.h"
 #include "tscore/ink_platform.h"
 #include "tscore/ink_memory.h"
+#include "tscore/HashFNV.h"
 #include <cassert>
 #include <cstdio>
 #include <cstring>
 #include <cctype>
 #include <algorithm>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 #include "MIME.h"
 #include "HdrHeap.h"
 #include "HdrToken.h"
@@ -668,6 +672,7 @@ mime_init()
     init = 0;
 
     hdrtoken_init();
+    mime_scan_use_simd(true);
     day_names_dfa = new DFA;
     day_names_dfa->compile(day_names, SIZEOF(day_names), RE_CASE_INSENSITIVE);
 
@@ -1056,6 +1061,9 @@ mime_hdr_cooked_stuff_init(MIMEHdrImpl *mh, MIMEField *changing_field_or_null)
 void
 mime_hdr_init(MIMEHdrImpl *mh)
 {
+  mh->m_obj_flags          &= ~(MIME_HDR_OBJ_FLAG_FIELD_INDEX | MIME_HDR_OBJ_FLAG_FIELD_INDEX_STALE);
+  mh->m_field_index_offset  = 0;
+
   mime_hdr_init_accelerators_and_presence_bits(mh);
 
   mime_hdr_cooked_stuff_init(mh, nullptr);
@@ -1100,6 +1108,7 @@ mime_hdr_destroy_field_block_list(HdrHeap *heap, MIMEFieldBlockImpl *head)
 void
 mime_hdr_destroy(HdrHeap *heap, MIMEHdrImpl *mh)
 {
+  mime_hdr_field_index_drop(heap, mh);
   mime_hdr_destroy_field_block_list(heap, mh->m_first_fblock.m_next);
 
   // INKqa11458: if we deallocate mh here and call TSMLocRelease
@@ -1122,6 +1131,7 @@ mime_hdr_copy_onto(MIMEHdrImpl *s_mh, HdrHeap *s_heap, MIMEHdrImpl *d_mh, HdrHea
   if (d_mh->m_first_fblock.m_next) {
     mime_hdr_destroy_field_block_list(d_heap, d_mh->m_first_fblock.m_next);
   }
+  mime_hdr_field_index_drop(d_heap, d_mh);
 
   ink_assert(((char *)&(s_mh->m_first_fblock.m_field_slots[MIME_FIELD_BLOCK_SLOTS]) - (char *)s_mh) == sizeof(struct MIMEHdrImpl));
 
@@ -1132,6 +1142,9 @@ mime_hdr_copy_onto(MIMEHdrImpl *s_mh, HdrHeap *s_heap, MIMEHdrImpl *d_mh, HdrHea
   // copies useful part of enclosed first block too
   memcpy(d_mh, s_mh, bytes_below_top);
 
+  // the field index, if any, stays with the source header
+  d_mh->m_obj_flags &= ~(MIME_HDR_OBJ_FLAG_FIELD_INDEX | MIME_HDR_OBJ_FLAG_FIELD_INDEX_STALE);
+
   if (d_mh->m_first_fblock.m_next == nullptr) // common case: no other block
   {
     d_mh->m_fblock_list_tail = &(d_mh->m_first_fblock);
@@ -1232,6 +1245,7 @@ mime_hdr_length_get(MIMEHdrImpl *mh)
 void
 mime_hdr_fields_clear(HdrHeap *heap, MIMEHdrImpl *mh)
 {
+  mime_hdr_field_index_drop(heap, mh);
   mime_hdr_destroy_field_block_list(heap, mh->m_first_fblock.m_next);
   mime_hdr_init(mh);
 }
@@ -1312,8 +1326,187 @@ _mime_hdr_field_list_search_by_slotnum(MIMEHdrImpl *mh, int slotnum)
   }
 }
 
+/***********************************************************************
+ *                                                                     *
+ *                          F I E L D   I N D E X                      *
+ *                                                                     *
+ ***********************************************************************/
+
+// An entry is the upper 16 bits of the name hash and the slot number plus one, 0 marks a free
+// entry. Entries are placed by linear probing from the lower bits of the hash.
+static constexpr int MIME_FIELD_INDEX_MIN_CAPACITY = 32;
+static constexpr int MIME_FIELD_INDEX_MAX_CAPACITY = 256;
+
+static_assert(sizeof(MIMEFieldIndexImpl) + MIME_FIELD_INDEX_MAX_CAPACITY * sizeof(uint32_t) <= HDR_MAX_ALLOC_SIZE);
+
+static inline uint32_t
+mime_field_index_hash(std::string_view name)
+{
+  ATSHash32FNV1a fnv;
+  fnv.update(name.data(), name.size(), ATSHash::nocase());
+  fnv.final();
+  return fnv.get();
+}
+
+// Add @a slotnum under @a hash, false if the index is too full to take it.
+static bool
+mime_field_index_insert(MIMEFieldIndexImpl *index, uint32_t hash, int slotnum)
+{
+  if (slotnum < 0 || slotnum >= UINT16_MAX || (index->m_count + 1) * 4 > index->m_capacity * 3) {
+    return false;
+  }
+
+  uint32_t mask     = index->m_capacity - 1;
+  uint32_t *entries = index->entries();
+  uint32_t i        = hash & mask;
+
+  while (entries[i] != 0) {
+    i = (i + 1) & mask;
+  }
+  entries[i] = (hash & 0xFFFF0000) | static_cast<uint32_t>(slotnum + 1);
+  ++index->m_count;
+  return true;
+}
+
+// The first live field in slot order which matches, which is the same field a walk of the
+// field list finds: by @a wks_idx if it is a well-known string, else by name.
+static MIMEField *
+mime_field_index_find(MIMEHdrImpl *mh, MIMEFieldIndexImpl *index, const char *name, int length, int wks_idx)
+{
+  uint32_t hash     = mime_field_index_hash({name, static_cast<size_t>(length)});
+  uint32_t tag      = hash & 0xFFFF0000;
+  uint32_t mask     = index->m_capacity - 1;
+  uint32_t *entries = index->entries();
+  MIMEField *found  = nullptr;
+  int found_slotnum = INT_MAX;
+
+  for (uint32_t i = hash & mask; entries[i] != 0; i = (i + 1) & mask) {
+    int slotnum = static_cast<int>(entries[i] & 0xFFFF) - 1;
+
+    if ((entries[i] & 0xFFFF0000) != tag || slotnum >= found_slotnum) {
+      continue;
+    }
+
+    MIMEField *field = _mime_hdr_field_list_search_by_slotnum(mh, slotnum);
+    if (field == nullptr || !field->is_live()) {
+      continue;
+    }
+    if (wks_idx >= 0) {
+      if (field->m_wks_idx != wks_idx) {
+        continue;
+      }
+    } else if (field->m_len_name != length || strncasecmp(field->m_ptr_name, name, length) != 0) {
+      continue;
+    }
+    found         = field;
+    found_slotnum = slotnum;
+  }
+
+  return found;
+}
+
+// The blocks of a HdrHeap come from different allocations, which may be anywhere in the address
+// space, so the index is found by its offset in the chain of heap blocks rather than by its
+// distance from the header.
+MIMEFieldIndexImpl *
+MIMEHdrImpl::field_index(HdrHeap *heap)
+{
+  if (!(m_obj_flags & MIME_HDR_OBJ_FLAG_FIELD_INDEX) || heap == nullptr) {
+    return nullptr;
+  }
+
+  uint32_t offset = m_field_index_offset;
+  for (HdrHeap *h = heap; h != nullptr; h = h->m_next) {
+    if (offset < h->m_size) {
+      auto index = reinterpret_cast<MIMEFieldIndexImpl *>(reinterpret_cast<char *>(h) + offset);
+      return index->m_type == HDR_HEAP_OBJ_FIELD_INDEX && index->m_owner == this ? index : nullptr;
+    }
+    offset -= h->m_size;
+  }
+  return nullptr;
+}
+
+void
+mime_hdr_field_index_build(HdrHeap *heap, MIMEHdrImpl *mh)
+{
+  int slots = 0;
+  for (MIMEFieldBlockImpl *fblock = &(mh->m_first_fblock); fblock != nullptr; fblock = fblock->m_next) {
+    slots += MIME_FIELD_BLOCK_SLOTS;
+  }
+
+  // Room for another block of fields before the index fills up.
+  int capacity = MIME_FIELD_INDEX_MIN_CAPACITY;
+  while (capacity * 3 < (slots + MIME_FIELD_BLOCK_SLOTS) * 4 && capacity < MIME_FIELD_INDEX_MAX_CAPACITY) {
+    capacity *= 2;
+  }
+  if (capacity * 3 < slots * 4) {
+    return; // too many fields, walk the list
+  }
+
+  mime_hdr_field_index_drop(heap, mh);
+
+  MIMEFieldIndexImpl *index = static_cast<MIMEFieldIndexImpl *>(
+    heap->allocate_obj(sizeof(MIMEFieldIndexImpl) + capacity * sizeof(uint32_t), HDR_HEAP_OBJ_FIELD_INDEX));
+  if (index == nullptr) {
+    return;
+  }
+
+  uint32_t offset = 0;
+  for (HdrHeap *h = heap; h != nullptr; h = h->m_next) {
+    if (reinterpret_cast<char *>(index) >= reinterpret_cast<char *>(h) && reinterpret_cast<char *>(index) < h->m_free_start) {
+      offset += reinterpret_cast<char *>(index) - reinterpret_cast<char *>(h);
+      break;
+    }
+    offset += h->m_size;
+  }
+
+  index->m_capacity = capacity;
+  index->m_count    = 0;
+  index->m_owner    = mh;
+  memset(index->entries(), 0, capacity * sizeof(uint32_t));
+
+  int slotnum = 0;
+  for (MIMEFieldBlockImpl *fblock = &(mh->m_first_fblock); fblock != nullptr; fblock = fblock->m_next) {
+    for (unsigned i = 0; i < fblock->m_freetop; ++i) {
+      MIMEField *field = &(fblock->m_field_slots[i]);
+      if (field->is_live()) {
+        mime_field_index_insert(index, mime_field_index_hash(field->name_get()), slotnum + i);
+      }
+    }
+    slotnum += MIME_FIELD_BLOCK_SLOTS;
+  }
+
+  mh->m_field_index_offset  = offset;
+  mh->m_obj_flags          |= MIME_HDR_OBJ_FLAG_FIELD_INDEX;
+}
+
+void
+mime_hdr_field_index_drop(HdrHeap *heap, MIMEHdrImpl *mh)
+{
+  if (MIMEFieldIndexImpl *index = mh->field_index(heap); index != nullptr) {
+    heap->deallocate_obj(index);
+  }
+  mh->m_obj_flags &= ~(MIME_HDR_OBJ_FLAG_FIELD_INDEX | MIME_HDR_OBJ_FLAG_FIELD_INDEX_STALE);
+}
+
+static inline MIMEFieldIndexImpl *
+mime_hdr_field_index_get(MIMEHdrImpl *mh, HdrHeap *heap)
+{
+  if (heap != nullptr && (mh->m_obj_flags & MIME_HDR_OBJ_FLAG_FIELD_INDEX_STALE)) {
+    mime_hdr_field_index_drop(heap, mh);
+  }
+
+  MIMEFieldIndexImpl *index = mh->field_index(heap);
+
+  if (index == nullptr && heap != nullptr && heap->m_writeable && mh->m_first_fblock.m_next != nullptr) {
+    mime_hdr_field_index_build(heap, mh);
+    index = mh->field_index(heap);
+  }
+  return index;
+}
+
 MIMEField *
-mime_hdr_field_find(MIMEHdrImpl *mh, const char *field_name_str, int field_name_len)
+mime_hdr_field_find(MIMEHdrImpl *mh, const char *field_name_str, int field_name_len, HdrHeap *heap)
 {
   HdrTokenHeapPrefix *token_info;
   const bool is_wks = hdrtoken_is_wks(field_name_str);
@@ -1361,7 +1554,12 @@ mime_hdr_field_find(MIMEHdrImpl *mh, const char *field_name_str, int field_name_
     // search by well-known string index or by case-insensitive string match //
     ///////////////////////////////////////////////////////////////////////////
 
-    MIMEField *f = _mime_hdr_field_list_search_by_wks(mh, token_info->wks_idx);
+    MIMEField *f;
+    if (MIMEFieldIndexImpl *index = mime_hdr_field_index_get(mh, heap); index != nullptr) {
+      f = mime_field_index_find(mh, index, field_name_str, field_name_len, token_info->wks_idx);
+    } else {
+      f = _mime_hdr_field_list_search_by_wks(mh, token_info->wks_idx);
+    }
     ink_assert((f == nullptr) || f->is_live());
 #if TRACK_FIELD_FIND_CALLS
     Debug("http", "mime_hdr_field_find(hdr 0x%X, field %.*s): %s (due to WKS list walk)", mh, field_name_len, field_name_str,
@@ -1369,7 +1567,12 @@ mime_hdr_field_find(MIMEHdrImpl *mh, const char *field_name_str, int field_name_
 #endif
     return f;
   } else {
-    MIMEField *f = _mime_hdr_field_list_search_by_string(mh, field_name_str, field_name_len);
+    MIMEField *f;
+    if (MIMEFieldIndexImpl *index = mime_hdr_field_index_get(mh, heap); index != nullptr) {
+      f = mime_field_index_find(mh, index, field_name_str, field_name_len, -1);
+    } else {
+      f = _mime_hdr_field_list_search_by_string(mh, field_name_str, field_name_len);
+    }
 
     ink_assert((f == nullptr) || f->is_live());
 #if TRACK_FIELD_FIND_CALLS
@@ -1474,7 +1677,7 @@ mime_field_create_named(HdrHeap *heap, MIMEHdrImpl *mh, const char *name, int le
 }
 
 void
-mime_hdr_field_attach(MIMEHdrImpl *mh, MIMEField *field, int check_for_dups, MIMEField *prev_dup)
+mime_hdr_field_attach(MIMEHdrImpl *mh, MIMEField *field, int check_for_dups, MIMEField *prev_dup, HdrHeap *heap)
 {
   MIME_HDR_SANITY_CHECK(mh);
 
@@ -1491,12 +1694,26 @@ mime_hdr_field_attach(MIMEHdrImpl *mh, MIMEField *field, int check_for_dups, MIM
 
   if (check_for_dups || (prev_dup && (!prev_dup->is_dup_head()))) {
     std::string_view name{field->name_get()};
-    prev_dup = mime_hdr_field_find(mh, name.data(), static_cast<int>(name.size()));
+    prev_dup = mime_hdr_field_find(mh, name.data(), static_cast<int>(name.size()), heap);
     ink_assert((prev_dup == nullptr) || (prev_dup->is_dup_head()));
   }
 
   field->m_readiness = MIME_FIELD_SLOT_READINESS_LIVE;
 
+  if (heap == nullptr) {
+    // The index can not be found without the heap. It misses this field from now on, so it is
+    // kept until a lookup with the heap frees it.
+    if (mh->m_obj_flags & MIME_HDR_OBJ_FLAG_FIELD_INDEX) {
+      mh->m_obj_flags |= MIME_HDR_OBJ_FLAG_FIELD_INDEX_STALE;
+    }
+  } else if (mh->m_obj_flags & MIME_HDR_OBJ_FLAG_FIELD_INDEX_STALE) {
+    mime_hdr_field_index_drop(heap, mh);
+  } else if (MIMEFieldIndexImpl *index = mh->field_index(heap); index != nullptr) {
+    if (!mime_field_index_insert(index, mime_field_index_hash(field->name_get()), mime_hdr_field_slotnum(mh, field))) {
+      mime_hdr_field_index_drop(heap, mh); // built again, larger, on the next lookup
+    }
+  }
+
   ////////////////////////////////////////////////////////////////////
   // now, attach the new field --- if there are dups, make sure the //
   // field is patched into the dup list in increasing slot order to //
@@ -1676,6 +1893,8 @@ mime_hdr_field_delete(HdrHeap *heap, MIMEHdrImpl *mh, MIMEField *field, bool del
           }
           // Destroy a block and maintain the chain
           if (can_destroy_block) {
+            // The slot numbers of the following fields change.
+            mime_hdr_field_index_drop(heap, mh);
             prev_block->m_next = fblock->m_next;
             _mime_field_block_destroy(heap, fblock);
             if (prev_block->m_next == nullptr) {
@@ -1729,7 +1948,7 @@ mime_hdr_prepare_for_value_set(HdrHeap *heap, MIMEHdrImpl *mh, const char *name,
   int wks_idx;
   MIMEField *field;
 
-  field = mime_hdr_field_find(mh, name, name_length);
+  field = mime_hdr_field_find(mh, name, name_length, heap);
 
   //////////////////////////////////////////////////////////////////////
   // this function returns with exactly one attached field created,   //
@@ -1746,7 +1965,7 @@ mime_hdr_prepare_for_value_set(HdrHeap *heap, MIMEHdrImpl *mh, const char *name,
     wks_idx = hdrtoken_tokenize(name, name_length);
     field   = mime_field_create(heap, mh);
     mime_field_name_set(heap, mh, field, wks_idx, name, name_length, true);
-    mime_hdr_field_attach(mh, field, 0, nullptr);
+    mime_hdr_field_attach(mh, field, 0, nullptr, heap);
 
   } else if (field->m_next_dup) // list of more than 1 field
   {
@@ -1754,7 +1973,7 @@ mime_hdr_prepare_for_value_set(HdrHeap *heap, MIMEHdrImpl *mh, const char *name,
     mime_hdr_field_delete(heap, mh, field, true);
     field = mime_field_create(heap, mh);
     mime_field_name_set(heap, mh, field, wks_idx, name, name_length, true);
-    mime_hdr_field_attach(mh, field, 0, nullptr);
+    mime_hdr_field_attach(mh, field, 0, nullptr, heap);
   }
   return field;
 }
@@ -2338,6 +2557,82 @@ MIMEHdr::get_host_port_values(const char **host_ptr, ///< Pointer to host.
  *                                                                     *
  ***********************************************************************/
 
+// Control character scanning, used to validate every parsed field. ParseRules::is_control() is
+// 0x00-0x08, 0x0a-0x1f and 0x7f. The vector versions test 16 or 32 octets per step and finish the
+// tail with the scalar loop; which one is used is decided by mime_init().
+namespace
+{
+const char *
+mime_scan_control_scalar(const char *s, const char *e)
+{
+  while (s < e && !ParseRules::is_control(*s)) {
+    ++s;
+  }
+  return s;
+}
+
+#if defined(__x86_64__)
+// SSE2 is part of x86-64, so this needs no CPU check.
+const char *
+mime_scan_control_sse2(const char *s, const char *e)
+{
+  const __m128i max_ctl = _mm_set1_epi8(0x1f);
+  const __m128i ht      = _mm_set1_epi8(ParseRules::CHAR_HT);
+  const __m128i del     = _mm_set1_epi8(0x7f);
+
+  for (; e - s >= 16; s += 16) {
+    __m128i v   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+    __m128i ctl = _mm_cmpeq_epi8(_mm_min_epu8(v, max_ctl), v); // v <= 0x1f, unsigned
+    ctl         = _mm_andnot_si128(_mm_cmpeq_epi8(v, ht), ctl);
+    ctl         = _mm_or_si128(ctl, _mm_cmpeq_epi8(v, del));
+    if (int mask = _mm_movemask_epi8(ctl); mask != 0) {
+      return s + __builtin_ctz(mask);
+    }
+  }
+  return mime_scan_control_scalar(s, e);
+}
+
+__attribute__((target("avx2"))) const char *
+mime_scan_control_avx2(const char *s, const char *e)
+{
+  const __m256i max_ctl = _mm256_set1_epi8(0x1f);
+  const __m256i ht      = _mm256_set1_epi8(ParseRules::CHAR_HT);
+  const __m256i del     = _mm256_set1_epi8(0x7f);
+
+  for (; e - s >= 32; s += 32) {
+    __m256i v   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+    __m256i ctl = _mm256_cmpeq_epi8(_mm256_min_epu8(v, max_ctl), v); // v <= 0x1f, unsigned
+    ctl         = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, ht), ctl);
+    ctl         = _mm256_or_si256(ctl, _mm256_cmpeq_epi8(v, del));
+    if (unsigned mask = _mm256_movemask_epi8(ctl); mask != 0) {
+      return s + __builtin_ctz(mask);
+    }
+  }
+  return mime_scan_control_sse2(s, e);
+}
+#endif
+
+const char *(*mime_scan_control_impl)(const char *, const char *) = &mime_scan_control_scalar;
+} // namespace
+
+const char *
+mime_scan_control(const char *s, const char *e)
+{
+  return mime_scan_control_impl(s, e);
+}
+
+bool
+mime_scan_use_simd(bool enable)
+{
+  mime_scan_control_impl = &mime_scan_control_scalar;
+#if defined(__x86_64__)
+  if (enable) {
+    mime_scan_control_impl = __builtin_cpu_supports("avx2") ? &mime_scan_control_avx2 : &mime_scan_control_sse2;
+  }
+#endif
+  return mime_scan_control_impl != &mime_scan_control_scalar;
+}
+
 void
 MIMEScanner::init()
 {
@@ -2622,19 +2917,11 @@ mime_parser_parse(MIMEParser *parser, HdrHeap *heap, MIMEHdrImpl *mh, const char
 
     int field_name_wks_idx = hdrtoken_tokenize(field_name.data(), field_name.size());
 
-    if (field_name_wks_idx < 0) {
-      for (auto i : field_name) {
-        if (ParseRules::is_control(i)) {
-          return PARSE_RESULT_ERROR;
-        }
-      }
-    }
-
     // RFC 9110 Section 5.5. Field Values
-    for (char i : field_value) {
-      if (ParseRules::is_control(i)) {
-        return PARSE_RESULT_ERROR;
-      }
+    // No control characters in the name or the value. Everything between them is the colon and
+    // white space, so one scan covers both. A well known name never has any.
+    if (mime_scan_control(field_name.data(), field_value.data_end()) != field_value.data_end()) {
+      return PARSE_RESULT_ERROR;
     }
 
     ///////////////////////////////////////////
@@ -2644,7 +2931,7 @@ mime_parser_parse(MIMEParser *parser, HdrHeap *heap, MIMEHdrImpl *mh, const char
     MIMEField *field = mime_field_create(heap, mh);
     mime_field_name_value_set(heap, mh, field, field_name_wks_idx, field_name.data(), field_name.size(), field_value.data(),
                               field_value.size(), raw_print_field, parsed.size(), false);
-    mime_hdr_field_attach(mh, field, 1, nullptr);
+    mime_hdr_field_attach(mh, field, 1, nullptr, heap);
   }
 }
 
@@ -3791,6 +4078,8 @@ MIMEHdrImpl::marshal(MarshalXlate *ptr_xlate, int num_ptr, MarshalXlate *str_xla
 {
   // printf("MIMEHdrImpl:marshal  num_ptr = %d  num_str = %d\n", num_ptr, num_str);
   HDR_MARSHAL_PTR(m_fblock_list_tail, MIMEFieldBlockImpl, ptr_xlate, num_ptr);
+  // The field index is not marshaled.
+  m_obj_flags &= ~(MIME_HDR_OBJ_FLAG_FIELD_INDEX | MIME_HDR_OBJ_FLAG_FIELD_INDEX_STALE);
   return m_first_fblock.marshal(ptr_xlate, num_ptr, str_xlate, num_str);
 }
 
@@ -88,6 +88,10 @@ enum MimeParseState {
 #define MIME_FIELD_SLOTNUM_MAX     (MIME_FIELD_SLOTNUM_MASK - 1)
 #define MIME_FIELD_SLOTNUM_UNKNOWN MIME_FIELD_SLOTNUM_MAX
 
+// HdrHeapObjImpl::m_obj_flags of a MIMEHdrImpl
+#define MIME_HDR_OBJ_FLAG_FIELD_INDEX       (1 << 0)
+#define MIME_HDR_OBJ_FLAG_FIELD_INDEX_STALE (1 << 1) // a field was attached without the heap
+
 /***********************************************************************
  *                                                                     *
  *                    MIMEField & MIMEFieldBlockImpl                   *
@@ -205,6 +209,27 @@ struct MIMEFieldBlockImpl : public HdrHeapObjImpl {
   void check_strings(HeapCheck *heaps, int num_heaps);
 };
 
+/** Hash index of the fields of a MIMEHdrImpl by name.
+ *
+ * Built on first use for headers with more than one field block, so finding a field by name
+ * probes a few entries instead of comparing the name of every field. Each entry packs 16 bits
+ * of the name hash with the slot number of a field. Entries for fields which were detached
+ * since are skipped on lookup, because the field itself is always checked. The index lives in
+ * the HdrHeap of its header but is not marshaled, so a header read from the cache has none.
+ */
+struct MIMEFieldIndexImpl : public HdrHeapObjImpl {
+  uint16_t m_capacity;  ///< Number of entries, a power of 2.
+  uint16_t m_count;     ///< Entries in use.
+  MIMEHdrImpl *m_owner; ///< Header this indexes.
+  // m_capacity entries follow
+
+  uint32_t *
+  entries()
+  {
+    return reinterpret_cast<uint32_t *>(this + 1);
+  }
+};
+
 /***********************************************************************
  *                                                                     *
  *                              MIMECooked                             *
@@ -305,7 +330,9 @@ struct MIMEHdrImpl : public HdrHeapObjImpl {
     friend struct MIMEHdrImpl;
   };
 
-  // HdrHeapObjImpl is 4 bytes, so this will result in 4 bytes padding
+  // HdrHeapObjImpl is 4 bytes, which leaves room for the offset of the field index in the
+  // blocks of the HdrHeap. It is only meaningful while MIME_HDR_OBJ_FLAG_FIELD_INDEX is set.
+  uint32_t m_field_index_offset;
   uint64_t m_presence_bits;
   uint32_t m_slot_accelerators[4];
 
@@ -325,6 +352,9 @@ struct MIMEHdrImpl : public HdrHeapObjImpl {
   // Sanity Check Functions
   void check_strings(HeapCheck *heaps, int num_heaps);
 
+  // Field index
+  MIMEFieldIndexImpl *field_index(HdrHeap *heap);
+
   // Cooked values
   void recompute_cooked_stuff(MIMEField *changing_field_or_null = nullptr);
   void recompute_accelerators_and_presence_bits();
@@ -842,7 +872,15 @@ void mime_hdr_fields_clear(HdrHeap *heap, MIMEHdrImpl *mh);
 MIMEField *_mime_hdr_field_list_search_by_wks(MIMEHdrImpl *mh, int wks_idx);
 MIMEField *_mime_hdr_field_list_search_by_string(MIMEHdrImpl *mh, const char *field_name_str, int field_name_len);
 MIMEField *_mime_hdr_field_list_search_by_slotnum(MIMEHdrImpl *mh, int slotnum);
-MIMEField *mime_hdr_field_find(MIMEHdrImpl *mh, const char *field_name_str, int field_name_len);
+/** Find the first field named @a field_name_str.
+ *
+ * If @a heap is given and writable, a header with more than one field block gets a field index
+ * on the first lookup which can not use the slot accelerators. Attaching a field without the heap
+ * drops the index again.
+ */
+MIMEField *mime_hdr_field_find(MIMEHdrImpl *mh, const char *field_name_str, int field_name_len, HdrHeap *heap = nullptr);
+void mime_hdr_field_index_build(HdrHeap *heap, MIMEHdrImpl *mh);
+void mime_hdr_field_index_drop(HdrHeap *heap, MIMEHdrImpl *mh);
 
 MIMEField *mime_hdr_field_get(MIMEHdrImpl *mh, int idx);
 MIMEField *mime_hdr_field_get_slotnum(MIMEHdrImpl *mh, int slotnum);
@@ -852,7 +890,7 @@ void mime_field_init(MIMEField *field);
 MIMEField *mime_field_create(HdrHeap *heap, MIMEHdrImpl *mh);
 MIMEField *mime_field_create_named(HdrHeap *heap, MIMEHdrImpl *mh, const char *name, int length);
 
-void mime_hdr_field_attach(MIMEHdrImpl *mh, MIMEField *field, int check_for_dups, MIMEField *prev_dup);
+void mime_hdr_field_attach(MIMEHdrImpl *mh, MIMEField *field, int check_for_dups, MIMEField *prev_dup, HdrHeap *heap = nullptr);
 void mime_hdr_field_detach(MIMEHdrImpl *mh, MIMEField *field, bool detach_all_dups = false);
 void mime_hdr_field_delete(HdrHeap *heap, MIMEHdrImpl *mh, MIMEField *field, bool delete_all_dups = false);
 
@@ -895,6 +933,16 @@ void mime_field_name_value_set(HdrHeap *heap, MIMEHdrImpl *mh, MIMEField *field,
 void mime_field_value_append(HdrHeap *heap, MIMEHdrImpl *mh, MIMEField *field, const char *value, int length, bool prepend_comma,
                              const char separator);
 
+/** Find the first control character in [@a s, @a e), as ParseRules::is_control().
+    @return A pointer to the character, or @a e if there is none.
+ */
+const char *mime_scan_control(const char *s, const char *e);
+/** Select the vectorized scanning code if @a enable and the CPU has it, else the scalar code.
+    Called by mime_init(), exposed for tests and benchmarks.
+    @return @c true if vectorized code is in use.
+ */
+bool mime_scan_use_simd(bool enable);
+
 void mime_parser_init(MIMEParser *parser);
 void mime_parser_clear(MIMEParser *parser);
 ParseResult mime_parser_parse(MIMEParser *parser, HdrHeap *heap, MIMEHdrImpl *mh, const char **real_s, const char *real_e,
@@ -1335,14 +1383,14 @@ inline MIMEField *
 MIMEHdr::field_find(const char *name, int length) // NOLINT(readability-make-member-function-const)
 {
   //    ink_assert(valid());
-  return mime_hdr_field_find(m_mime, name, length);
+  return mime_hdr_field_find(m_mime, name, length, m_heap);
 }
 
 inline const MIMEField *
 MIMEHdr::field_find(const char *name, int length) const
 {
   //    ink_assert(valid());
-  MIMEField *retval = mime_hdr_field_find(const_cast<MIMEHdr *>(this)->m_mime, name, length);
+  MIMEField *retval = mime_hdr_field_find(const_cast<MIMEHdr *>(this)->m_mime, name, length, m_heap);
   return retval;
 }
 
@@ -1352,7 +1400,7 @@ MIMEHdr::field_find(const char *name, int length) const
 inline void
 MIMEHdr::field_attach(MIMEField *field) // NOLINT(readability-make-member-function-const)
 {
-  mime_hdr_field_attach(m_mime, field, 1, nullptr);
+  mime_hdr_field_attach(m_mime, field, 1, nullptr, m_heap);
 }
 
 /*-------------------------------------------------------------------------
@@ -26,6 +26,9 @@
 #include <iostream>
 #include <cassert>
 #include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
 
 using namespace std;
 
@@ -201,16 +204,181 @@ decode_errors_test()
   }
 }
 
+// Bit at a time decoder walking a tree, the way huffman_decode() used to work. It is the reference
+// for the table driven decoder and the baseline of the benchmark.
+struct RefNode {
+  int child[2] = {-1, -1};
+  int symbol   = -1;
+};
+
+static std::vector<RefNode> ref_tree;
+
+void
+ref_tree_init()
+{
+  ref_tree.assign(1, RefNode());
+  for (int symbol = 0; symbol < static_cast<int>(sizeof(test_values) / 8); ++symbol) {
+    const uint32_t code = test_values[symbol * 2];
+    int node            = 0;
+
+    for (int bit = test_values[symbol * 2 + 1] - 1; bit >= 0; --bit) {
+      int b = (code >> bit) & 1;
+      if (ref_tree[node].child[b] < 0) {
+        ref_tree[node].child[b] = ref_tree.size();
+        ref_tree.emplace_back();
+      }
+      node = ref_tree[node].child[b];
+    }
+    ref_tree[node].symbol = symbol;
+  }
+}
+
+int64_t
+ref_decode(char *dst_start, const uint8_t *src, uint32_t src_len)
+{
+  char *dst     = dst_start;
+  int node      = 0;
+  int nbits     = 0;
+  bool all_ones = true;
+
+  for (uint32_t i = 0; i < src_len; ++i) {
+    for (int shift = 7; shift >= 0; --shift) {
+      int b     = (src[i] >> shift) & 1;
+      node      = ref_tree[node].child[b];
+      all_ones &= b;
+      ++nbits;
+      if (ref_tree[node].symbol >= 0) {
+        if (ref_tree[node].symbol == 256) {
+          return -1;
+        }
+        *dst++   = ref_tree[node].symbol;
+        node     = 0;
+        nbits    = 0;
+        all_ones = true;
+      }
+    }
+  }
+
+  if (nbits > 7 || !all_ones) {
+    return -1;
+  }
+  return dst - dst_start;
+}
+
+void
+reference_test()
+{
+  char expect[4096], actual[4096];
+  uint8_t src[1024];
+
+  for (int n = 0; n < 10000; ++n) {
+    uint32_t src_len = lrand48() % 64;
+    for (uint32_t i = 0; i < src_len; ++i) {
+      // mostly valid input, most codes are short
+      src[i] = (lrand48() % 4) ? 0x00 + lrand48() % 0xc0 : lrand48();
+    }
+    int64_t expect_len = ref_decode(expect, src, src_len);
+    int64_t actual_len = huffman_decode(actual, src, src_len);
+    assert(expect_len == actual_len);
+    assert(expect_len <= 0 || memcmp(expect, actual, expect_len) == 0);
+  }
+}
+
+void
+round_trip_test()
+{
+  uint8_t src[512], encoded[512 * 4];
+  char decoded[512 * 2];
+
+  for (int n = 0; n < 1000; ++n) {
+    uint32_t src_len = lrand48() % sizeof(src);
+    for (uint32_t i = 0; i < src_len; ++i) {
+      src[i] = lrand48();
+    }
+    int64_t encoded_len = huffman_encode(encoded, src, src_len);
+    int64_t decoded_len = huffman_decode(decoded, encoded, encoded_len);
+    assert(decoded_len == src_len);
+    assert(memcmp(src, decoded, src_len) == 0);
+  }
+}
+
+// Throughput of the encoder, the decoder and the reference decoder on typical header values.
+void
+benchmark()
+{
+  const char *values[] = {
+    "Mon, 21 Oct 2013 20:13:21 GMT",
+    "https://www.example.com/assets/js/application-5f1c1e8d.js",
+    "text/html; charset=utf-8",
+    "public, max-age=31536000, immutable",
+    "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36",
+    "session=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1",
+    "gzip, deflate, br",
+  };
+  const int rounds = 200000;
+
+  std::vector<std::string> encoded;
+  size_t plain_bytes = 0;
+  for (const char *v : values) {
+    uint8_t buf[1024];
+    int64_t len = huffman_encode(buf, reinterpret_cast<const uint8_t *>(v), strlen(v));
+    encoded.emplace_back(reinterpret_cast<char *>(buf), len);
+    plain_bytes += strlen(v);
+  }
+
+  auto report = [&](const char *name, auto &&run) {
+    auto start   = std::chrono::steady_clock::now();
+    int64_t sink = 0;
+    for (int r = 0; r < rounds; ++r) {
+      sink += run();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    cout << name << ": " << static_cast<int>(plain_bytes * rounds / elapsed.count() / (1 << 20)) << " MB/s (" << sink << ")"
+         << endl;
+  };
+
+  char dst[2048];
+  report("reference decode", [&]() {
+    int64_t n = 0;
+    for (const auto &e : encoded) {
+      n += ref_decode(dst, reinterpret_cast<const uint8_t *>(e.data()), e.size());
+    }
+    return n;
+  });
+  report("huffman_decode", [&]() {
+    int64_t n = 0;
+    for (const auto &e : encoded) {
+      n += huffman_decode(dst, reinterpret_cast<const uint8_t *>(e.data()), e.size());
+    }
+    return n;
+  });
+  report("huffman_encode", [&]() {
+    int64_t n = 0;
+    for (const char *v : values) {
+      n += huffman_encode(reinterpret_cast<uint8_t *>(dst), reinterpret_cast<const uint8_t *>(v), strlen(v));
+    }
+    return n;
+  });
+}
+
 int
-main()
+main(int argc, const char **argv)
 {
   hpack_huffman_init();
+  ref_tree_init();
 
   for (int i = 0; i < 100; i++) {
     random_test();
   }
   values_test();
   decode_errors_test();
+  reference_test();
+  round_trip_test();
+
+  // Throughput numbers on request, e.g. "test_Huffmancode --benchmark"
+  if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+    benchmark();
+  }
 
   hpack_huffman_fin();
 
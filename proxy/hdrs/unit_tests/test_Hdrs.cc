@@ -28,6 +28,7 @@
 #include <new>
 #include <cstdio>
 #include <memory>
+#include <algorithm>
 
 #include "tscore/Regex.h"
 #include "tscore/ink_time.h"
@@ -2072,3 +2073,40 @@ TEST_CASE("HdrTest", "[proxy][hdrtest]")
     }
   }
 }
+
+TEST_CASE("HdrTokenTokenize", "[proxy][hdrtoken]")
+{
+  for (int idx = 0; idx < hdrtoken_num_wks; ++idx) {
+    // Copies, so the strings are not recognized as well-known by their address.
+    std::string wks{hdrtoken_index_to_wks(idx), static_cast<size_t>(hdrtoken_index_to_length(idx))};
+    std::string upper{wks};
+    std::string lower{wks};
+    std::transform(wks.begin(), wks.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+    std::transform(wks.begin(), wks.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    for (auto const &s : {wks, upper, lower}) {
+      const char *out = nullptr;
+      INFO(s);
+      CHECK(hdrtoken_tokenize(s.data(), s.size(), &out) == idx);
+      CHECK(out == hdrtoken_index_to_wks(idx));
+    }
+
+    // Same length and almost the same bytes, but not well-known.
+    std::string near{wks};
+    for (size_t i = 0; i < near.size(); i += 3) {
+      near[i] = '~';
+      INFO(near);
+      CHECK(hdrtoken_tokenize(near.data(), near.size()) == -1);
+      near[i] = wks[i];
+    }
+    near += '~';
+    CHECK(hdrtoken_tokenize(near.data(), near.size()) == -1);
+    CHECK(hdrtoken_tokenize(near.data(), near.size() - 2) != idx);
+  }
+
+  // Only letters compare case insensitively.
+  CHECK(hdrtoken_tokenize("@Ats-Internal", 13) >= 0);
+  CHECK(hdrtoken_tokenize("`Ats-Internal", 13) == -1);
+  CHECK(hdrtoken_tokenize("Content\rLength", 14) == -1);
+  CHECK(hdrtoken_tokenize("", 0) == -1);
+}
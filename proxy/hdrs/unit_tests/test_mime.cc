@@ -22,6 +22,9 @@
  */
 
 #include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "catch.hpp"
 
@@ -249,3 +252,140 @@ TEST_CASE("MimeParsers", "[proxy][mimeparsers]")
   std::printf("Date1: %d\n", d1);
   std::printf("Date2: %d\n", d2);
 }
+
+TEST_CASE("MimeScanControl", "[proxy][mimescan]")
+{
+  // Every octet value at every offset of a buffer long enough for the vector loops and their tails.
+  char buf[100];
+
+  for (bool simd : {false, true}) {
+    mime_scan_use_simd(simd);
+    for (int c = 0; c < 256; ++c) {
+      for (size_t pos = 0; pos < sizeof(buf); pos += 7) {
+        memset(buf, 'a', sizeof(buf));
+        buf[pos] = static_cast<char>(c);
+
+        const char *expected = ParseRules::is_control(buf[pos]) ? buf + pos : buf + sizeof(buf);
+        REQUIRE(mime_scan_control(buf, buf + sizeof(buf)) == expected);
+        // the end bound is respected
+        REQUIRE(mime_scan_control(buf, buf + pos) == buf + pos);
+      }
+    }
+  }
+  mime_scan_use_simd(true);
+}
+
+TEST_CASE("MimeFieldIndex", "[proxy][mimeindex]")
+{
+  MIMEHdr hdr;
+  hdr.create(nullptr);
+
+  std::vector<std::string> names;
+  for (int i = 0; i < 40; ++i) {
+    names.push_back("X-Custom-" + std::to_string(i));
+  }
+  names.push_back("X-Dup");
+  names.push_back("Host");
+
+  auto add = [&](const std::string &name) {
+    MIMEField *field = hdr.field_create(name.data(), name.size());
+    hdr.field_value_set(field, "v", 1);
+    hdr.field_attach(field);
+    return field;
+  };
+  for (auto const &name : names) {
+    add(name);
+    if (hdr.fields_count() == MIME_FIELD_BLOCK_SLOTS) {
+      CHECK(hdr.m_mime->field_index(hdr.m_heap) == nullptr);
+    }
+  }
+  MIMEField *dup = add("x-dup");
+
+  // Every lookup must agree with a walk of the field list.
+  auto check = [&](MIMEHdrImpl *mh, HdrHeap *heap) {
+    for (auto const &name : names) {
+      INFO(name);
+      CHECK(mime_hdr_field_find(mh, name.data(), name.size(), heap) ==
+            _mime_hdr_field_list_search_by_string(mh, name.data(), name.size()));
+    }
+    const char *host = hdrtoken_string_to_wks("Host");
+    CHECK(mime_hdr_field_find(mh, host, 4, heap) == _mime_hdr_field_list_search_by_wks(mh, hdrtoken_wks_to_index(host)));
+    CHECK(mime_hdr_field_find(mh, "X-Missing", 9, heap) == nullptr);
+  };
+
+  // The lookups for dups while attaching built the index once there was a second field block.
+  REQUIRE(hdr.m_mime->field_index(hdr.m_heap) != nullptr);
+  check(hdr.m_mime, hdr.m_heap);
+  CHECK(hdr.field_find("X-CUSTOM-7", 10) == hdr.field_find("x-custom-7", 10));
+  CHECK(hdr.field_find("X-Custom-7", 10) != nullptr);
+
+  // Deleting the head of a dup list finds the next dup.
+  MIMEField *head = hdr.field_find("X-Dup", 5);
+  REQUIRE(head != nullptr);
+  REQUIRE(head != dup);
+  hdr.field_delete(head, false);
+  CHECK(hdr.field_find("X-Dup", 5) == dup);
+
+  // Renamed fields are found by their new name only.
+  MIMEField *field = hdr.field_find("X-Custom-3", 10);
+  hdr.field_detach(field);
+  mime_field_name_set(hdr.m_heap, hdr.m_mime, field, -1, "X-Renamed", 9, true);
+  hdr.field_attach(field);
+  names.push_back("X-Renamed");
+  CHECK(hdr.field_find("X-Renamed", 9) == field);
+  CHECK(hdr.field_find("X-Custom-3", 10) == nullptr);
+  check(hdr.m_mime, hdr.m_heap);
+
+  // Growing past the capacity drops the index, the next lookup builds a larger one.
+  for (int i = 40; i < 150; ++i) {
+    names.push_back("X-Custom-" + std::to_string(i));
+    add(names.back());
+  }
+  check(hdr.m_mime, hdr.m_heap);
+  CHECK(hdr.m_mime->field_index(hdr.m_heap) != nullptr);
+
+  // Removing a whole field block renumbers the slots after it.
+  for (int i = 16; i < 32; ++i) {
+    std::string name = "X-Custom-" + std::to_string(i);
+    if (MIMEField *f = hdr.field_find(name.data(), name.size()); f != nullptr) {
+      hdr.field_delete(f);
+    }
+  }
+  check(hdr.m_mime, hdr.m_heap);
+
+  // A field attached without the heap at hand can not be indexed, the next lookup with the heap
+  // frees the stale index and builds another one.
+  MIMEFieldIndexImpl *stale = hdr.m_mime->field_index(hdr.m_heap);
+  REQUIRE(stale != nullptr);
+  names.push_back("X-No-Heap");
+  field = hdr.field_create(names.back().data(), names.back().size());
+  mime_hdr_field_attach(hdr.m_mime, field, 1, nullptr);
+  CHECK((hdr.m_mime->m_obj_flags & MIME_HDR_OBJ_FLAG_FIELD_INDEX_STALE) != 0);
+  check(hdr.m_mime, hdr.m_heap);
+  CHECK((hdr.m_mime->m_obj_flags & MIME_HDR_OBJ_FLAG_FIELD_INDEX_STALE) == 0);
+  CHECK(stale->m_type == HDR_HEAP_OBJ_EMPTY);
+  CHECK(hdr.m_mime->field_index(hdr.m_heap) != stale);
+
+  // The index is not marshaled, nor built in the read only heap.
+  REQUIRE(hdr.m_mime->field_index(hdr.m_heap) != nullptr);
+  int length = hdr.m_heap->marshal_length();
+  std::unique_ptr<char[]> buf(new char[length]);
+  REQUIRE(hdr.m_heap->marshal(buf.get(), length) > 0);
+
+  HdrHeapObjImpl *obj = nullptr;
+  HdrHeap *heap       = reinterpret_cast<HdrHeap *>(buf.get());
+  REQUIRE(heap->unmarshal(length, HDR_HEAP_OBJ_MIME_HEADER, &obj, nullptr) > 0);
+  MIMEHdrImpl *mh = reinterpret_cast<MIMEHdrImpl *>(obj);
+  check(mh, heap);
+  CHECK(mh->field_index(heap) == nullptr);
+
+  // A copy does not share the index.
+  MIMEHdr copy;
+  copy.create(nullptr);
+  copy.copy(&hdr);
+  CHECK(copy.m_mime->field_index(copy.m_heap) == nullptr);
+  check(copy.m_mime, copy.m_heap);
+
+  copy.destroy();
+  hdr.destroy();
+}
@@ -23,6 +23,7 @@
 
 #include "HPACK.h"
 
+#include "tscore/HashFNV.h"
 #include "tscpp/util/LocalBuffer.h"
 #include "swoc/TextView.h"
 
@@ -259,6 +260,25 @@ match_ignore_case(const char *s1, int s1_len, const char *s2, int s2_len)
   return true;
 }
 
+// Keys for the dynamic table indexes. Names are matched case insensitively so the name is hashed
+// folded to one case, and the value follows a separator so that splitting a string differently
+// between name and value yields a different key.
+static inline void
+hpack_index_keys(std::string_view name, std::string_view value, uint64_t &name_key, uint64_t &field_key)
+{
+  ATSHash64FNV1a hash;
+
+  hash.update(name.data(), name.size(), ATSHash::nocase());
+  ATSHash64FNV1a field_hash = hash;
+  hash.final();
+  name_key = hash.get();
+
+  field_hash.update("", 1);
+  field_hash.update(value.data(), value.size());
+  field_hash.final();
+  field_key = field_hash.get();
+}
+
 //
 // The first byte of an HPACK field unambiguously tells us what
 // kind of field it is. Field types are specified in the high 4 bits
@@ -349,8 +369,9 @@ HpackIndexingTable::lookup(const HpackHeaderField &header) const
     return result;
   }
 
-  // dynamic table
-  if (HpackLookupResult dt_result = this->_dynamic_table.lookup(header); dt_result.match_type == HpackMatch::EXACT) {
+  // dynamic table, a name match is used only if the static table has none
+  if (HpackLookupResult dt_result = this->_dynamic_table.lookup(header);
+      dt_result.match_type == HpackMatch::EXACT || (dt_result.match_type == HpackMatch::NAME && !result.index)) {
     return dt_result;
   }
 
@@ -455,6 +476,7 @@ HpackDynamicTable::add_header_field(const HpackHeaderField &header)
     // table causes the table to be emptied of all existing entries.
     this->_headers.clear();
     this->_mhdr->fields_clear();
+    this->_index_clear();
 
     if (this->_mhdr_old) {
       this->_mhdr_old->fields_clear();
@@ -472,6 +494,12 @@ HpackDynamicTable::add_header_field(const HpackHeaderField &header)
     new_field->value_set(this->_mhdr->m_heap, this->_mhdr->m_mime, header.value.data(), header.value.size());
     this->_mhdr->field_attach(new_field);
     this->_headers.push_front(new_field);
+
+    uint64_t name_key, field_key;
+    hpack_index_keys(header.name, header.value, name_key, field_key);
+    this->_name_index[name_key]   = this->_inserted;
+    this->_field_index[field_key] = this->_inserted;
+    ++this->_inserted;
   }
 }
 
@@ -479,25 +507,36 @@ HpackLookupResult
 HpackDynamicTable::lookup(const HpackHeaderField &header) const
 {
   HpackLookupResult result;
-  const unsigned int entry_num = TS_HPACK_STATIC_TABLE_ENTRY_NUM + this->length();
+  uint64_t name_key, field_key;
 
-  for (unsigned int index = TS_HPACK_STATIC_TABLE_ENTRY_NUM; index < entry_num; ++index) {
-    const MIMEField *m_field = this->_headers.at(index - TS_HPACK_STATIC_TABLE_ENTRY_NUM);
+  hpack_index_keys(header.name, header.value, name_key, field_key);
+
+  // Each index holds the newest entry for a key, which is the one with the lowest index. Keys are
+  // hashes, so the entry is compared to guard against a collision; a collision only costs a miss.
+  if (auto spot = this->_field_index.find(field_key); spot != this->_field_index.end()) {
+    uint32_t pos             = this->_inserted - 1 - spot->second;
+    const MIMEField *m_field = this->_headers[pos];
     std::string_view name    = m_field->name_get();
     std::string_view value   = m_field->value_get();
 
-    // Check whether name (and value) are matched
+    if (match_ignore_case(header.name.data(), header.name.length(), name.data(), name.length()) &&
+        match(header.value.data(), header.value.length(), value.data(), value.length())) {
+      result.index      = TS_HPACK_STATIC_TABLE_ENTRY_NUM + pos;
+      result.index_type = HpackIndex::DYNAMIC;
+      result.match_type = HpackMatch::EXACT;
+      return result;
+    }
+  }
+
+  if (auto spot = this->_name_index.find(name_key); spot != this->_name_index.end()) {
+    uint32_t pos             = this->_inserted - 1 - spot->second;
+    const MIMEField *m_field = this->_headers[pos];
+    std::string_view name    = m_field->name_get();
+
     if (match_ignore_case(header.name.data(), header.name.length(), name.data(), name.length())) {
-      if (match(header.value.data(), header.value.length(), value.data(), value.length())) {
-        result.index      = index;
-        result.index_type = HpackIndex::DYNAMIC;
-        result.match_type = HpackMatch::EXACT;
-        break;
-      } else if (!result.index) {
-        result.index      = index;
-        result.index_type = HpackIndex::DYNAMIC;
-        result.match_type = HpackMatch::NAME;
-      }
+      result.index      = TS_HPACK_STATIC_TABLE_ENTRY_NUM + pos;
+      result.index_type = HpackIndex::DYNAMIC;
+      result.match_type = HpackMatch::NAME;
     }
   }
 
@@ -547,11 +586,22 @@ HpackDynamicTable::_evict_overflowed_entries()
   while (!this->_headers.empty()) {
     auto h = this->_headers.back();
     int name_len, value_len;
-    h->name_get(&name_len);
-    h->value_get(&value_len);
+    const char *name  = h->name_get(&name_len);
+    const char *value = h->value_get(&value_len);
 
     this->_current_size -= ADDITIONAL_OCTETS + name_len + value_len;
 
+    // Drop the index keys unless a newer entry has taken them over.
+    uint64_t seq = this->_inserted - this->_headers.size();
+    uint64_t name_key, field_key;
+    hpack_index_keys({name, static_cast<size_t>(name_len)}, {value, static_cast<size_t>(value_len)}, name_key, field_key);
+    if (auto spot = this->_name_index.find(name_key); spot != this->_name_index.end() && spot->second == seq) {
+      this->_name_index.erase(spot);
+    }
+    if (auto spot = this->_field_index.find(field_key); spot != this->_field_index.end() && spot->second == seq) {
+      this->_field_index.erase(spot);
+    }
+
     if (this->_mhdr_old && this->_mhdr_old->fields_count() != 0) {
       this->_mhdr_old->field_delete(h, false);
     } else {
@@ -568,6 +618,13 @@ HpackDynamicTable::_evict_overflowed_entries()
   this->_mime_hdr_gc();
 }
 
+void
+HpackDynamicTable::_index_clear()
+{
+  this->_name_index.clear();
+  this->_field_index.clear();
+}
+
 /**
    When HdrHeap size of current MIMEHdr exceeds the threshold, allocate new MIMEHdr and HdrHeap.
    The old MIMEHdr and HdrHeap will be freed, when all MIMEFiled are deleted by HPACK Entry Eviction.
@@ -960,7 +1017,7 @@ hpack_decode_header_block(HpackIndexingTable &indexing_table, HTTPHdr *hdr, cons
     }
 
     // Store to HdrHeap
-    mime_hdr_field_attach(hh->m_fields_impl, field, 1, nullptr);
+    mime_hdr_field_attach(hh->m_fields_impl, field, 1, nullptr, heap);
   }
   // Parsing all headers is done
   if (has_http2_violation) {
@@ -30,6 +30,7 @@
 
 #include <deque>
 #include <string_view>
+#include <unordered_map>
 
 // It means that any header field can be compressed/decompressed by ATS
 const static int HPACK_ERROR_COMPRESSION_ERROR   = -1;
@@ -131,6 +132,7 @@ public:
 private:
   void _evict_overflowed_entries();
   void _mime_hdr_gc();
+  void _index_clear();
 
   uint32_t _current_size = 0;
   uint32_t _maximum_size = 0;
@@ -138,6 +140,13 @@ private:
   MIMEHdr *_mhdr     = nullptr;
   MIMEHdr *_mhdr_old = nullptr;
   std::deque<MIMEField *> _headers;
+
+  // Encoder lookup indexes, keyed by a hash of the name (or of the name and value) and holding the
+  // insertion sequence number of the newest entry with that key. The entry at _headers[i] has the
+  // sequence number _inserted - 1 - i.
+  uint64_t _inserted = 0;
+  std::unordered_map<uint64_t, uint64_t> _name_index;
+  std::unordered_map<uint64_t, uint64_t> _field_index;
 };
 
 // [RFC 7541] 2.3. Indexing Table
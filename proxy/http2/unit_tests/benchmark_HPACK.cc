@@ -0,0 +1,136 @@
+/** @file
+
+    Micro benchmark for HPACK header block encoding
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+
+To run this, add this to Makefile.am in the proxy/http2 directory
+
+noinst_PROGRAMS = benchmark_HPACK
+benchmark_HPACK_CPPFLAGS = $(AM_CPPFLAGS) \
+	-I$(abs_top_srcdir)/lib/catch2
+benchmark_HPACK_SOURCES = unit_tests/benchmark_HPACK.cc
+benchmark_HPACK_LDADD = $(test_HPACK_LDADD)
+
+and run it with the "[bench]" tag, e.g. ./benchmark_HPACK "[bench]" --benchmark-samples 20
+
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "HPACK.h"
+#include "HuffmanCodec.h"
+#include "I_EventSystem.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Large enough to hold every header block encoded below without a size update.
+constexpr uint32_t DYNAMIC_TABLE_SIZE = 65536;
+constexpr size_t BUF_SIZE             = 16384;
+
+// Number of distinct responses, cycled through so that the dynamic table fills up and every
+// encoding sees a mix of exact, name only and missing matches.
+constexpr int RESPONSE_NUM = 256;
+
+// A typical response from a CDN: a handful of headers which repeat across responses and a few
+// whose values differ every time.
+std::unique_ptr<HTTPHdr>
+make_response(int n)
+{
+  auto hdr = std::make_unique<HTTPHdr>();
+  hdr->create(HTTP_TYPE_RESPONSE);
+  hdr->status_set(HTTP_STATUS_OK);
+
+  auto add = [&](std::string_view name, std::string_view value) {
+    MIMEField *field = hdr->field_create(name.data(), name.size());
+    field->value_set(hdr->m_heap, hdr->m_http->m_fields_impl, value.data(), value.size());
+    hdr->field_attach(field);
+  };
+  std::string id = std::to_string(n);
+
+  add("Content-Type", "text/html; charset=utf-8");
+  add("Content-Length", std::to_string(1000 + n));
+  add("Cache-Control", "public, max-age=3600");
+  add("Date", "Mon, 21 Oct 2013 20:13:" + std::to_string(n % 60) + " GMT");
+  add("Last-Modified", "Mon, 21 Oct 2013 20:13:21 GMT");
+  add("ETag", "\"5f1c1e8d-" + id + "\"");
+  add("Vary", "Accept-Encoding");
+  add("Accept-Ranges", "bytes");
+  add("Age", std::to_string(n % 3600));
+  add("Server", "ATS");
+  add("Via", "https/1.1 cache.example.com (ApacheTrafficServer [cMsSf ])");
+  add("Strict-Transport-Security", "max-age=31536000; includeSubDomains");
+  add("X-Content-Type-Options", "nosniff");
+  add("X-Frame-Options", "SAMEORIGIN");
+  add("X-Request-Id", "b0c4a35e-91c1-4b42-a0f2-" + id);
+  add("X-Cache", n % 4 ? "HIT" : "MISS");
+  add("X-Cache-Key", "https://www.example.com/assets/" + id + ".js");
+  add("X-Served-By", "cache-" + std::to_string(n % 8) + ".example.com");
+  add("Timing-Allow-Origin", "*");
+  add("Access-Control-Allow-Origin", "*");
+  add("Set-Cookie", "session=" + id + "; Path=/; Secure; HttpOnly");
+  add("Alt-Svc", "h3=\":443\"; ma=86400");
+
+  return hdr;
+}
+} // namespace
+
+TEST_CASE("HPACK encode", "[bench]")
+{
+  Thread *main_thread = new EThread;
+  main_thread->set_specific();
+  url_init();
+  mime_init();
+  http_init();
+  hpack_huffman_init();
+
+  std::vector<std::unique_ptr<HTTPHdr>> responses;
+  for (int i = 0; i < RESPONSE_NUM; ++i) {
+    responses.push_back(make_response(i));
+  }
+
+  HpackHandle handle(DYNAMIC_TABLE_SIZE);
+  uint8_t buf[BUF_SIZE];
+  int next = 0;
+
+  // Fill the dynamic table first, the steady state of a long lived connection.
+  for (auto &response : responses) {
+    REQUIRE(hpack_encode_header_block(handle, buf, sizeof(buf), response.get()) > 0);
+  }
+
+  BENCHMARK("encode response header block")
+  {
+    HTTPHdr *response = responses[next++ % RESPONSE_NUM].get();
+    return hpack_encode_header_block(handle, buf, sizeof(buf), response);
+  };
+
+  for (auto &response : responses) {
+    response->destroy();
+  }
+  hpack_huffman_fin();
+}
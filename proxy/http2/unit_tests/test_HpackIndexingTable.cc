@@ -519,4 +519,57 @@ TEST_CASE("HPACK high level APIs", "[hpack]")
       CHECK(len == HPACK_ERROR_COMPRESSION_ERROR);
     }
   }
+
+  SECTION("dynamic table lookup")
+  {
+    // Each entry is 32 + 5 + 1 = 38 octets, so the table holds two of them.
+    HpackIndexingTable indexing_table(80);
+    HpackLookupResult result;
+
+    indexing_table.add_header_field({"x-foo", "a"});
+    indexing_table.add_header_field({"x-foo", "b"});
+
+    result = indexing_table.lookup({"x-foo", "a"});
+    CHECK(result.index == 63);
+    CHECK(result.index_type == HpackIndex::DYNAMIC);
+    CHECK(result.match_type == HpackMatch::EXACT);
+
+    // the newest entry with a matching name wins
+    result = indexing_table.lookup({"x-foo", "z"});
+    CHECK(result.index == 62);
+    CHECK(result.index_type == HpackIndex::DYNAMIC);
+    CHECK(result.match_type == HpackMatch::NAME);
+
+    result = indexing_table.lookup({"x-bar", "a"});
+    CHECK(result.index_type == HpackIndex::NONE);
+    CHECK(result.match_type == HpackMatch::NONE);
+
+    // "x-foo: a" is evicted, "x-foo: b" still matches the name
+    indexing_table.add_header_field({"x-bar", "c"});
+    result = indexing_table.lookup({"x-foo", "a"});
+    CHECK(result.index == 63);
+    CHECK(result.match_type == HpackMatch::NAME);
+
+    result = indexing_table.lookup({"x-bar", "c"});
+    CHECK(result.index == 62);
+    CHECK(result.match_type == HpackMatch::EXACT);
+
+    // re-adding an entry indexes the new copy, "x-foo: b" is evicted
+    indexing_table.add_header_field({"x-bar", "c"});
+    result = indexing_table.lookup({"x-bar", "c"});
+    CHECK(result.index == 62);
+    CHECK(result.match_type == HpackMatch::EXACT);
+    result = indexing_table.lookup({"x-foo", "b"});
+    CHECK(result.match_type == HpackMatch::NONE);
+
+    // evicting the older "x-bar: c" keeps the newer copy indexed
+    indexing_table.add_header_field({"x-baz", "d"});
+    result = indexing_table.lookup({"x-bar", "c"});
+    CHECK(result.index == 63);
+    CHECK(result.match_type == HpackMatch::EXACT);
+
+    indexing_table.update_maximum_size(0);
+    result = indexing_table.lookup({"x-baz", "d"});
+    CHECK(result.match_type == HpackMatch::NONE);
+  }
 }
@@ -47,6 +47,7 @@
 #include "LogObject.h"
 #include "LogConfig.h"
 #include "LogBuffer.h"
+#include "LogColumnar.h"
 #include "LogUtils.h"
 #include "Log.h"
 #include "tscore/SimpleTokenizer.h"
@@ -69,6 +70,7 @@ InkAtomicList *Log::flush_data_list;
 
 // Log private objects
 int Log::preproc_threads;
+int Log::flush_threads;
 int Log::init_status                  = 0;
 int Log::config_flags                 = 0;
 bool Log::logging_mode_changed        = false;
@@ -159,8 +161,8 @@ Log::change_configuration()
 /*-------------------------------------------------------------------------
   PeriodicWakeup
 
-  This continuation is invoked each second to wake-up the flush thread,
-  just in case it's sleeping on the job.
+  This continuation is invoked each second to wake-up the preproc and
+  flush threads, just in case they're sleeping on the job.
   -------------------------------------------------------------------------*/
 
 struct PeriodicWakeup;
@@ -1026,6 +1028,7 @@ void
 Log::init(int flags)
 {
   preproc_threads = 1;
+  flush_threads   = 1;
 
   // store the configuration flags
   //
@@ -1047,6 +1050,7 @@ Log::init(int flags)
 
     config->read_configuration_variables();
     preproc_threads = config->preproc_threads;
+    flush_threads   = config->flush_threads;
 
     int val = static_cast<int>(REC_ConfigReadInteger("proxy.config.log.logging_enabled"));
     if (val < LOG_MODE_NONE || val > LOG_MODE_FULL) {
@@ -1103,9 +1107,9 @@ Log::init_when_enabled()
       LogConfig::register_config_callbacks();
     }
 
-    // create the flush thread
+    // create the preproc and flush threads
     create_threads();
-    eventProcessor.schedule_every(new PeriodicWakeup(preproc_threads, 1), HRTIME_SECOND, ET_CALL);
+    eventProcessor.schedule_every(new PeriodicWakeup(preproc_threads, flush_threads), HRTIME_SECOND, ET_CALL);
 
     init_status |= FULLY_INITIALIZED;
   }
@@ -1135,16 +1139,20 @@ Log::create_threads()
     eventProcessor.spawn_thread(preproc_cont, desc, stacksize);
   }
 
-  // Now, only one flush thread is supported.
-  // TODO: Enable multiple flush threads, such as
-  //       one flush thread per file.
+  // start the flush threads
   //
-  flush_notify    = new EventNotify;
-  flush_data_list = new InkAtomicList;
-
-  ink_atomiclist_init(flush_data_list, "Logging flush buffer list", 0);
-  Continuation *flush_cont = new LoggingFlushContinuation(0);
-  eventProcessor.spawn_thread(flush_cont, "[LOG_FLUSH]", stacksize);
+  // each file is written by exactly one of them (see LogFile::flush),
+  // so the writes to a file stay in order while different files are
+  // written in parallel.
+  flush_notify    = new EventNotify[flush_threads];
+  flush_data_list = new InkAtomicList[flush_threads];
+
+  for (int i = 0; i < flush_threads; i++) {
+    ink_atomiclist_init(&flush_data_list[i], "Logging flush buffer list", 0);
+    Continuation *flush_cont = new LoggingFlushContinuation(i);
+    snprintf(desc, sizeof(desc), "[LOG_FLUSH %d]", i);
+    eventProcessor.spawn_thread(flush_cont, desc, stacksize);
+  }
 }
 
 /*-------------------------------------------------------------------------
@@ -1307,22 +1315,25 @@ Log::preproc_thread_main(void *args)
 }
 
 void *
-Log::flush_thread_main(void * /* args ATS_UNUSED */)
+Log::flush_thread_main(void *args)
 {
+  int idx = *static_cast<int *>(args);
   LogBuffer *logbuffer;
   LogFlushData *fdata;
   ink_hrtime now, last_time = 0;
   int len, total_bytes;
   SLL<LogFlushData, LogFlushData::Link_link> link, invert_link;
   ProxyMutex *mutex = this_thread()->mutex.get();
+  LogColumnar columnar;
+  std::vector<char> block;
 
-  Log::flush_notify->lock();
+  Log::flush_notify[idx].lock();
 
   while (true) {
     if (TSSystemState::is_event_system_shut_down()) {
       return nullptr;
     }
-    fdata = static_cast<LogFlushData *>(ink_atomiclist_popall(flush_data_list));
+    fdata = static_cast<LogFlushData *>(ink_atomiclist_popall(&flush_data_list[idx]));
 
     // invert the list
     //
@@ -1345,6 +1356,20 @@ Log::flush_thread_main(void * /* args ATS_UNUSED */)
         buf         = reinterpret_cast<char *>(buffer_header);
         total_bytes = buffer_header->byte_count;
 
+      } else if (logfile->m_file_format == LOG_FILE_COLUMNAR) {
+        logbuffer                      = static_cast<LogBuffer *>(fdata->m_data);
+        LogBufferHeader *buffer_header = logbuffer->header();
+
+        // Buffers that can not be stored in columns are written as is, readers tell the
+        // two apart by their cookie.
+        total_bytes = columnar.encode(buffer_header, block);
+        if (total_bytes < 0) {
+          buf         = reinterpret_cast<char *>(buffer_header);
+          total_bytes = buffer_header->byte_count;
+        } else {
+          buf = block.data();
+        }
+
       } else if (logfile->m_file_format == LOG_FILE_ASCII || logfile->m_file_format == LOG_FILE_PIPE) {
         buf         = static_cast<char *>(fdata->m_data);
         total_bytes = fdata->m_len;
@@ -1353,44 +1378,50 @@ Log::flush_thread_main(void * /* args ATS_UNUSED */)
         ink_release_assert(!"Unknown file format type!");
       }
 
-      // make sure we're open & ready to write
-      logfile->check_fd();
-      if (!logfile->is_open()) {
-        SiteThrottledWarning("File:%s was closed, have dropped (%d) bytes.", logfile->get_name(), total_bytes);
-
-        RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_lost_before_written_to_disk_stat, total_bytes);
-        delete fdata;
-        continue;
-      }
-
-      int logfilefd = logfile->get_fd();
-      // This should always be true because we just checked it.
-      ink_assert(logfilefd >= 0);
+      {
+        // rolling and reopening happen on the first flush thread, keep them
+        // from closing the file under this write
+        std::lock_guard<std::mutex> lock(logfile->m_write_mutex);
 
-      // write *all* data to target file as much as possible
-      //
-      while (total_bytes - bytes_written) {
-        if (Log::config->logging_space_exhausted) {
-          Debug("log", "logging space exhausted, failed to write file:%s, have dropped (%d) bytes.", logfile->get_name(),
-                (total_bytes - bytes_written));
+        // make sure we're open & ready to write
+        logfile->check_fd();
+        if (!logfile->is_open()) {
+          SiteThrottledWarning("File:%s was closed, have dropped (%d) bytes.", logfile->get_name(), total_bytes);
 
-          RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_lost_before_written_to_disk_stat,
-                         total_bytes - bytes_written);
-          break;
+          RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_lost_before_written_to_disk_stat, total_bytes);
+          delete fdata;
+          continue;
         }
 
-        len = ::write(logfilefd, &buf[bytes_written], total_bytes - bytes_written);
-
-        if (len < 0) {
-          SiteThrottledError("Failed to write log to %s: [tried %d, wrote %d, %s]", logfile->get_name(),
-                             total_bytes - bytes_written, bytes_written, strerror(errno));
-
-          RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_lost_before_written_to_disk_stat,
-                         total_bytes - bytes_written);
-          break;
+        int logfilefd = logfile->get_fd();
+        // This should always be true because we just checked it.
+        ink_assert(logfilefd >= 0);
+
+        // write *all* data to target file as much as possible
+        //
+        while (total_bytes - bytes_written) {
+          if (Log::config->logging_space_exhausted) {
+            Debug("log", "logging space exhausted, failed to write file:%s, have dropped (%d) bytes.", logfile->get_name(),
+                  (total_bytes - bytes_written));
+
+            RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_lost_before_written_to_disk_stat,
+                           total_bytes - bytes_written);
+            break;
+          }
+
+          len = ::write(logfilefd, &buf[bytes_written], total_bytes - bytes_written);
+
+          if (len < 0) {
+            SiteThrottledError("Failed to write log to %s: [tried %d, wrote %d, %s]", logfile->get_name(),
+                               total_bytes - bytes_written, bytes_written, strerror(errno));
+
+            RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_lost_before_written_to_disk_stat,
+                           total_bytes - bytes_written);
+            break;
+          }
+          Debug("log", "Successfully wrote some stuff to %s", logfile->get_name());
+          bytes_written += len;
         }
-        Debug("log", "Successfully wrote some stuff to %s", logfile->get_name());
-        bytes_written += len;
       }
 
       RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_written_to_disk_stat, bytes_written);
@@ -1402,10 +1433,12 @@ Log::flush_thread_main(void * /* args ATS_UNUSED */)
       delete fdata;
     }
 
-    // Time to work on periodic events??
+    // Time to work on periodic events?? Only the first flush thread
+    // runs them, rolling is serialized with the writes of the other
+    // threads by the LogFile write mutex.
     //
     now = ink_get_hrtime() / HRTIME_SECOND;
-    if (now >= last_time + periodic_tasks_interval) {
+    if (idx == 0 && now >= last_time + periodic_tasks_interval) {
       Debug("log-preproc", "periodic tasks for %" PRId64, (int64_t)now);
       periodic_tasks(now);
       last_time = ink_get_hrtime() / HRTIME_SECOND;
@@ -1415,10 +1448,10 @@ Log::flush_thread_main(void * /* args ATS_UNUSED */)
     // check the queue and find there is nothing to do, then wait
     // again.
     //
-    Log::flush_notify->wait();
+    Log::flush_notify[idx].wait();
   }
 
   /* NOTREACHED */
-  Log::flush_notify->unlock();
+  Log::flush_notify[idx].unlock();
   return nullptr;
 }
@@ -87,6 +87,7 @@ public:
   {
     switch (m_logfile->m_file_format) {
     case LOG_FILE_BINARY:
+    case LOG_FILE_COLUMNAR:
       logbuffer = static_cast<LogBuffer *>(m_data);
       LogBuffer::destroy(logbuffer);
       break;
@@ -193,6 +194,7 @@ public:
   static void *flush_thread_main(void *args);
 
   static int preproc_threads;
+  static int flush_threads;
 
   // reconfiguration stuff
   static void change_configuration();
@@ -53,8 +53,9 @@ enum {
   FIELDLIST_CACHE_SIZE = 256,
 };
 
-FieldListCacheElement fieldlist_cache[FIELDLIST_CACHE_SIZE];
-int fieldlist_cache_entries = 0;
+// Per thread, the preproc threads format ASCII buffers in parallel.
+thread_local FieldListCacheElement fieldlist_cache[FIELDLIST_CACHE_SIZE];
+thread_local int fieldlist_cache_entries = 0;
 int32_t LogBuffer::M_ID;
 
 /*-------------------------------------------------------------------------
@@ -0,0 +1,428 @@
+/** @file
+
+  Columnar, block compressed log file format.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "tscore/ink_config.h"
+#include "tscore/ink_align.h"
+#include "tscore/Diags.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <zlib.h>
+#ifdef HAVE_ZSTD_H
+#include <zstd.h>
+#endif
+
+#include "LogColumnar.h"
+#include "LogAccess.h"
+#include "LogField.h"
+#include "LogFormat.h"
+#include "LogLimits.h"
+
+#define LOG_COLUMNAR_ZSTD_LEVEL 3
+#define LOG_COLUMNAR_ZLIB_LEVEL 6
+
+namespace
+{
+// String and IP values vary in size, their columns start with the size of each value.
+inline bool
+variable_width(uint32_t type)
+{
+  return type == LogField::STRING || type == LogField::IP;
+}
+
+inline void
+append(std::vector<char> &v, const void *data, size_t len)
+{
+  const char *p = static_cast<const char *>(data);
+  v.insert(v.end(), p, p + len);
+}
+
+inline void
+pad(std::vector<char> &v)
+{
+  v.resize(INK_ALIGN(v.size(), INK_MIN_ALIGN), 0);
+}
+} // namespace
+
+LogColumnar::LogColumnar() : _scratch(LOG_MAX_FORMATTED_LINE) {}
+
+LogColumnar::~LogColumnar()
+{
+#ifdef HAVE_ZSTD_H
+  ZSTD_freeCCtx(_zstd_cctx);
+  ZSTD_freeDCtx(_zstd_dctx);
+#endif
+}
+
+LogColumnarCompression
+LogColumnar::default_compression()
+{
+#ifdef HAVE_ZSTD_H
+  return LOG_COLUMNAR_ZSTD;
+#else
+  return LOG_COLUMNAR_ZLIB;
+#endif
+}
+
+LogFieldList *
+LogColumnar::fieldlist(const char *symbol_str)
+{
+  auto spot = _fieldlists.find(symbol_str);
+
+  if (spot == _fieldlists.end()) {
+    auto fields              = std::make_unique<LogFieldList>();
+    bool contains_aggregates = false;
+
+    LogFormat::parse_symbol_string(symbol_str, fields.get(), &contains_aggregates);
+    // Aggregate buffers hold a single summary entry, there is nothing to gain from columns.
+    if (contains_aggregates || fields->count() == 0 || fields->count() >= UINT16_MAX) {
+      fields.reset();
+    }
+    spot = _fieldlists.emplace(symbol_str, std::move(fields)).first;
+  }
+  return spot->second.get();
+}
+
+int
+LogColumnar::compress_column(LogColumnarCompression compression, const std::vector<char> &src, std::vector<char> &out)
+{
+  size_t start = out.size();
+
+  switch (compression) {
+#ifdef HAVE_ZSTD_H
+  case LOG_COLUMNAR_ZSTD: {
+    if (!_zstd_cctx) {
+      _zstd_cctx = ZSTD_createCCtx();
+    }
+    out.resize(start + ZSTD_compressBound(src.size()));
+    size_t n =
+      ZSTD_compressCCtx(_zstd_cctx, out.data() + start, out.size() - start, src.data(), src.size(), LOG_COLUMNAR_ZSTD_LEVEL);
+    if (ZSTD_isError(n)) {
+      Debug("log-columnar", "zstd compression failed: %s", ZSTD_getErrorName(n));
+      out.resize(start);
+      return -1;
+    }
+    out.resize(start + n);
+    return n;
+  }
+#endif
+  case LOG_COLUMNAR_ZLIB: {
+    uLongf n = compressBound(src.size());
+    out.resize(start + n);
+    if (compress2(reinterpret_cast<Bytef *>(out.data() + start), &n, reinterpret_cast<const Bytef *>(src.data()), src.size(),
+                  LOG_COLUMNAR_ZLIB_LEVEL) != Z_OK) {
+      Debug("log-columnar", "zlib compression failed");
+      out.resize(start);
+      return -1;
+    }
+    out.resize(start + n);
+    return n;
+  }
+  case LOG_COLUMNAR_NONE:
+    append(out, src.data(), src.size());
+    return src.size();
+  default:
+    return -1;
+  }
+}
+
+bool
+LogColumnar::decompress_column(LogColumnarCompression compression, const char *src, uint32_t len, char *dst, uint32_t raw_len)
+{
+  switch (compression) {
+#ifdef HAVE_ZSTD_H
+  case LOG_COLUMNAR_ZSTD: {
+    if (!_zstd_dctx) {
+      _zstd_dctx = ZSTD_createDCtx();
+    }
+    size_t n = ZSTD_decompressDCtx(_zstd_dctx, dst, raw_len, src, len);
+    return !ZSTD_isError(n) && n == raw_len;
+  }
+#endif
+  case LOG_COLUMNAR_ZLIB: {
+    uLongf n = raw_len;
+    return uncompress(reinterpret_cast<Bytef *>(dst), &n, reinterpret_cast<const Bytef *>(src), len) == Z_OK && n == raw_len;
+  }
+  case LOG_COLUMNAR_NONE:
+    if (len != raw_len) {
+      return false;
+    }
+    memcpy(dst, src, len);
+    return true;
+  default:
+    Debug("log-columnar", "unsupported compression %d", compression);
+    return false;
+  }
+}
+
+int
+LogColumnar::encode(LogBufferHeader *header, std::vector<char> &out, LogColumnarCompression compression)
+{
+  char *symbol_str = header->fmt_fieldlist();
+  if (!symbol_str || header->version != LOG_SEGMENT_VERSION || header->data_offset < sizeof(LogBufferHeader) ||
+      header->data_offset > header->byte_count) {
+    return -1;
+  }
+
+  LogFieldList *fields = fieldlist(symbol_str);
+  if (!fields) {
+    return -1;
+  }
+
+  unsigned n_columns = fields->count() + 1;
+  std::vector<LogColumnarColumn> directory(n_columns);
+
+  _columns.resize(n_columns);
+  _lengths.resize(n_columns);
+  for (unsigned idx = 0; idx < n_columns; ++idx) {
+    _columns[idx].clear();
+    _lengths[idx].clear();
+    directory[idx].min = INT64_MAX;
+    directory[idx].max = INT64_MIN;
+  }
+  directory[0].type = LogColumnarColumn::ENTRY_HEADER;
+  {
+    unsigned idx = 1;
+    for (LogField *f = fields->first(); f; f = fields->next(f)) {
+      directory[idx++].type = f->type();
+    }
+  }
+
+  // Transpose the entries, finding the size of each marshalled value without formatting it
+  // where the type allows.
+  LogBufferIterator iter(header);
+  LogEntryHeader *entry;
+
+  while ((entry = iter.next())) {
+    char *ptr = reinterpret_cast<char *>(entry) + sizeof(LogEntryHeader);
+    char *end = reinterpret_cast<char *>(entry) + entry->entry_len;
+
+    append(_columns[0], entry, sizeof(LogEntryHeader));
+    directory[0].min = std::min(directory[0].min, entry->timestamp);
+    directory[0].max = std::max(directory[0].max, entry->timestamp);
+
+    unsigned idx = 1;
+    for (LogField *f = fields->first(); f; f = fields->next(f), ++idx) {
+      char *value = ptr;
+
+      switch (f->type()) {
+      case LogField::sINT:
+      case LogField::dINT: {
+        int64_t v          = LogAccess::unmarshal_int(&ptr);
+        directory[idx].min = std::min(directory[idx].min, v);
+        directory[idx].max = std::max(directory[idx].max, v);
+        break;
+      }
+      case LogField::IP: {
+        IpEndpoint ip;
+        LogAccess::unmarshal_ip(&ptr, &ip);
+        break;
+      }
+      default:
+        f->unmarshal(&ptr, _scratch.data(), _scratch.size());
+        break;
+      }
+
+      if (ptr > end) {
+        Debug("log-columnar", "field %s overruns its entry, buffer not stored in columns", f->symbol());
+        return -1;
+      }
+      append(_columns[idx], value, ptr - value);
+      if (variable_width(directory[idx].type)) {
+        _lengths[idx].push_back(ptr - value);
+      }
+    }
+  }
+
+  size_t format_length = header->data_offset;
+
+  out.clear();
+  out.resize(sizeof(LogColumnarBlockHeader));
+  append(out, header, format_length);
+  pad(out);
+
+  for (unsigned idx = 0; idx < n_columns; ++idx) {
+    LogColumnarColumn &col = directory[idx];
+    std::vector<char> *raw = &_columns[idx];
+
+    if (variable_width(col.type)) {
+      _raw.clear();
+      append(_raw, _lengths[idx].data(), _lengths[idx].size() * sizeof(uint32_t));
+      append(_raw, raw->data(), raw->size());
+      raw = &_raw;
+    }
+    if (col.min > col.max) {
+      col.min = col.max = 0;
+    }
+
+    col.offset     = out.size();
+    col.raw_length = raw->size();
+    int n          = compress_column(compression, *raw, out);
+    if (n < 0) {
+      return -1;
+    }
+    col.length = n;
+    pad(out);
+  }
+
+  uint32_t directory_offset = out.size();
+  append(out, directory.data(), n_columns * sizeof(LogColumnarColumn));
+
+  LogColumnarBlockHeader *block = reinterpret_cast<LogColumnarBlockHeader *>(out.data());
+  block->cookie                 = LOG_COLUMNAR_COOKIE;
+  block->version                = LOG_COLUMNAR_VERSION;
+  block->byte_count             = out.size();
+  block->entry_count            = header->entry_count;
+  block->low_timestamp          = header->low_timestamp;
+  block->high_timestamp         = header->high_timestamp;
+  block->column_count           = n_columns;
+  block->compression            = compression;
+  block->format_length          = format_length;
+  block->directory_offset       = directory_offset;
+  block->reserved               = 0;
+
+  Debug("log-columnar", "encoded %u entries, %u bytes as %zu bytes in %u columns", header->entry_count, header->byte_count,
+        out.size(), n_columns);
+  return out.size();
+}
+
+const LogColumnarColumn *
+LogColumnar::column(const LogColumnarBlockHeader *block, unsigned idx)
+{
+  if (idx >= block->column_count || block->directory_offset < sizeof(LogColumnarBlockHeader) ||
+      block->directory_offset + static_cast<size_t>(block->column_count) * sizeof(LogColumnarColumn) > block->byte_count) {
+    return nullptr;
+  }
+  return reinterpret_cast<const LogColumnarColumn *>(reinterpret_cast<const char *>(block) + block->directory_offset) + idx;
+}
+
+bool
+LogColumnar::decode_column(const LogColumnarBlockHeader *block, unsigned idx, std::vector<char> &out)
+{
+  const LogColumnarColumn *col = column(block, idx);
+
+  if (block->version != LOG_COLUMNAR_VERSION || !col || col->offset < sizeof(LogColumnarBlockHeader) ||
+      col->offset + static_cast<size_t>(col->length) > block->directory_offset) {
+    return false;
+  }
+  out.resize(col->raw_length);
+  return decompress_column(static_cast<LogColumnarCompression>(block->compression),
+                           reinterpret_cast<const char *>(block) + col->offset, col->length, out.data(), col->raw_length);
+}
+
+bool
+LogColumnar::decode(const LogColumnarBlockHeader *block, std::vector<char> &out, const std::vector<bool> *columns)
+{
+  const LogBufferHeader *header = buffer_header(block);
+  size_t format_length          = block->format_length;
+  unsigned n_columns            = block->column_count;
+
+  if (block->version != LOG_COLUMNAR_VERSION || format_length < sizeof(LogBufferHeader) ||
+      sizeof(LogColumnarBlockHeader) + format_length > block->byte_count || header->data_offset != format_length ||
+      header->byte_count < format_length || n_columns == 0) {
+    return false;
+  }
+
+  auto wanted = [columns](unsigned idx) { return idx == 0 || !columns || (idx < columns->size() && (*columns)[idx]); };
+
+  _columns.resize(n_columns);
+  for (unsigned idx = 0; idx < n_columns; ++idx) {
+    if (!wanted(idx)) {
+      _columns[idx].clear();
+    } else if (!decode_column(block, idx, _columns[idx])) {
+      Debug("log-columnar", "column %u of block is corrupt", idx);
+      return false;
+    }
+  }
+  if (column(block, 0)->type != LogColumnarColumn::ENTRY_HEADER ||
+      _columns[0].size() != static_cast<size_t>(block->entry_count) * sizeof(LogEntryHeader)) {
+    return false;
+  }
+
+  // Values of variable width columns follow the array of their sizes.
+  std::vector<size_t> pos(n_columns);
+  for (unsigned idx = 1; idx < n_columns; ++idx) {
+    if (wanted(idx) && variable_width(column(block, idx)->type)) {
+      pos[idx] = static_cast<size_t>(block->entry_count) * sizeof(uint32_t);
+      if (pos[idx] > _columns[idx].size()) {
+        return false;
+      }
+    }
+  }
+
+  // A field that was not decoded gets the smallest value of its type, "-" for strings, 0 for
+  // integers and no address for IPs, so the entry can still be walked by position. Since every
+  // marshalled value takes at least INK_MIN_ALIGN bytes, entries only shrink.
+  const char placeholder[INK_MIN_ALIGN]        = {0};
+  const char string_placeholder[INK_MIN_ALIGN] = DEFAULT_STR;
+
+  // Interleave the columns back into entries.
+  out.assign(header->byte_count, 0);
+  memcpy(out.data(), header, format_length);
+
+  size_t offset = format_length;
+  for (unsigned i = 0; i < block->entry_count; ++i) {
+    LogEntryHeader entry;
+    memcpy(&entry, _columns[0].data() + i * sizeof(LogEntryHeader), sizeof(LogEntryHeader));
+    if (entry.entry_len < sizeof(LogEntryHeader) || offset + entry.entry_len > out.size()) {
+      return false;
+    }
+
+    size_t field = offset + sizeof(LogEntryHeader);
+    size_t limit = offset + entry.entry_len;
+    for (unsigned idx = 1; idx < n_columns; ++idx) {
+      uint32_t type = column(block, idx)->type;
+      uint32_t n    = INK_MIN_ALIGN;
+
+      if (!wanted(idx)) {
+        if (field + n > limit) {
+          return false;
+        }
+        memcpy(out.data() + field, type == LogField::STRING ? string_placeholder : placeholder, n);
+        field += n;
+        continue;
+      }
+      if (variable_width(type)) {
+        memcpy(&n, _columns[idx].data() + i * sizeof(uint32_t), sizeof(uint32_t));
+      }
+      if (pos[idx] + n > _columns[idx].size() || field + n > limit) {
+        return false;
+      }
+      memcpy(out.data() + field, _columns[idx].data() + pos[idx], n);
+      pos[idx] += n;
+      field    += n;
+    }
+    if (columns) {
+      entry.entry_len = field - offset;
+    }
+    memcpy(out.data() + offset, &entry, sizeof(LogEntryHeader));
+    offset += entry.entry_len;
+  }
+
+  if (columns) {
+    out.resize(offset);
+    reinterpret_cast<LogBufferHeader *>(out.data())->byte_count = offset;
+  }
+  return true;
+}
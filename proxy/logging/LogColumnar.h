@@ -0,0 +1,153 @@
+/** @file
+
+  Columnar, block compressed log file format.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  Each LogBuffer is written as one block. The entries are transposed so that the marshalled
+  values of a field are stored together, and every column is compressed on its own. A column
+  directory at the end of the block records where each column lives and, for the integer
+  columns, the smallest and largest value in the block, so readers can skip blocks and
+  decompress only the columns they need.
+
+  Block layout:
+
+    LogColumnarBlockHeader
+    LogBufferHeader and its strings, as written by the proxy (format_length bytes)
+    column payloads, each padded to 8 bytes
+    LogColumnarColumn directory (column_count entries, at directory_offset)
+
+  Column 0 holds the LogEntryHeader of every entry, the remaining columns hold the fields in
+  the order of the format's field list. Integer columns are a packed array of the marshalled
+  values. String and IP columns are prefixed with the marshalled length of each entry's value.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "LogBuffer.h"
+
+class LogFieldList;
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+#define LOG_COLUMNAR_COOKIE  0xc01face
+#define LOG_COLUMNAR_VERSION 1
+
+enum LogColumnarCompression : uint16_t {
+  LOG_COLUMNAR_NONE = 0,
+  LOG_COLUMNAR_ZLIB,
+  LOG_COLUMNAR_ZSTD,
+};
+
+struct LogColumnarBlockHeader {
+  uint32_t cookie;           // LOG_COLUMNAR_COOKIE, shares its position with LogBufferHeader::cookie
+  uint32_t version;          // LOG_COLUMNAR_VERSION
+  uint32_t byte_count;       // size of the whole block
+  uint32_t entry_count;      // number of entries in the block
+  uint32_t low_timestamp;    // lowest timestamp value of entries
+  uint32_t high_timestamp;   // highest timestamp value of entries
+  uint16_t column_count;     // number of directory entries
+  uint16_t compression;      // LogColumnarCompression of every column
+  uint32_t format_length;    // bytes of the LogBufferHeader copy that follows this header
+  uint32_t directory_offset; // offset of the column directory from the start of the block
+  uint32_t reserved;
+};
+
+struct LogColumnarColumn {
+  /// Type of column 0, the others use LogField::Type.
+  static constexpr uint32_t ENTRY_HEADER = 0xffffffff;
+
+  uint32_t offset;     // offset of the compressed column from the start of the block
+  uint32_t length;     // compressed length
+  uint32_t raw_length; // decompressed length
+  uint32_t type;       // LogField::Type or ENTRY_HEADER
+  int64_t min;         // smallest value, integer and entry header (timestamp) columns only
+  int64_t max;         // largest value, integer and entry header (timestamp) columns only
+};
+
+/**
+   Encoder and decoder for columnar blocks.
+
+   An instance keeps its scratch space, compression contexts and parsed field lists between
+   blocks, so each thread that encodes or decodes should use its own instance.
+ */
+class LogColumnar
+{
+public:
+  LogColumnar();
+  ~LogColumnar();
+
+  /// The compression used for new blocks, the best one this build supports.
+  static LogColumnarCompression default_compression();
+
+  /** Encode the entries of @a header as a block into @a out.
+
+      @return The size of the block, or -1 if the buffer can not be stored in columns (e.g. it
+      holds aggregates), in which case the caller should write the buffer as is.
+   */
+  int encode(LogBufferHeader *header, std::vector<char> &out, LogColumnarCompression compression = default_compression());
+
+  /** Rebuild the LogBuffer a block was encoded from into @a out.
+
+      @a columns selects the columns to decompress, by index. The fields of the other columns are
+      filled with a default value ("-", 0 or no address), so readers that need only a few fields
+      can still walk the entries by position. If @a columns is nullptr, every column is decoded.
+
+      @return false if the block is corrupt.
+   */
+  bool decode(const LogColumnarBlockHeader *block, std::vector<char> &out, const std::vector<bool> *columns = nullptr);
+
+  /// Decompress only column @a idx of a block into @a out. Returns false if the block is corrupt.
+  bool decode_column(const LogColumnarBlockHeader *block, unsigned idx, std::vector<char> &out);
+
+  /// The directory entry of column @a idx, or nullptr if out of range.
+  static const LogColumnarColumn *column(const LogColumnarBlockHeader *block, unsigned idx);
+
+  /// The LogBufferHeader the block was encoded from, without any entries.
+  static const LogBufferHeader *
+  buffer_header(const LogColumnarBlockHeader *block)
+  {
+    return reinterpret_cast<const LogBufferHeader *>(block + 1);
+  }
+
+  /// Whether @a header starts a columnar block rather than a LogBuffer.
+  static bool
+  is_block(const void *header)
+  {
+    return static_cast<const LogColumnarBlockHeader *>(header)->cookie == LOG_COLUMNAR_COOKIE;
+  }
+
+private:
+  LogFieldList *fieldlist(const char *symbol_str);
+  int compress_column(LogColumnarCompression compression, const std::vector<char> &src, std::vector<char> &out);
+  bool decompress_column(LogColumnarCompression compression, const char *src, uint32_t len, char *dst, uint32_t raw_len);
+
+  std::unordered_map<std::string, std::unique_ptr<LogFieldList>> _fieldlists;
+  std::vector<std::vector<char>> _columns;     // raw column values
+  std::vector<std::vector<uint32_t>> _lengths; // value sizes of the variable width columns while encoding
+  std::vector<char> _raw;                      // a variable width column with its sizes
+  std::vector<char> _scratch;                  // target of values that must be unmarshalled to be measured
+  ZSTD_CCtx_s *_zstd_cctx = nullptr;
+  ZSTD_DCtx_s *_zstd_dctx = nullptr;
+};
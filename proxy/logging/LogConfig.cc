@@ -75,11 +75,13 @@ LogConfig::setup_default_values()
   max_secs_per_buffer   = 5;
   max_space_mb_for_logs = 100;
   max_space_mb_headroom = 10;
+  ring_size_mb          = 64;
   error_log_filename    = ats_strdup("error.log");
   logfile_perm          = 0644;
   logfile_dir           = ats_strdup(".");
 
   preproc_threads = 1;
+  flush_threads   = 1;
 
   rolling_enabled          = Log::NO_ROLLING;
   rolling_interval_sec     = 86400; // 24 hours
@@ -150,6 +152,11 @@ LogConfig::read_configuration_variables()
     max_space_mb_headroom = val;
   }
 
+  val = static_cast<int>(REC_ConfigReadInteger("proxy.config.log.ring_size_mb"));
+  if (val > 0 && val <= 4096) {
+    ring_size_mb = val;
+  }
+
   val = static_cast<int>(REC_ConfigReadInteger("proxy.config.log.io.max_buffer_index"));
   if (val > 0) {
     logbuffer_max_iobuf_index = val;
@@ -193,6 +200,11 @@ LogConfig::read_configuration_variables()
     preproc_threads = val;
   }
 
+  val = static_cast<int>(REC_ConfigReadInteger("proxy.config.log.flush_threads"));
+  if (val > 0 && val <= 128) {
+    flush_threads = val;
+  }
+
   // ROLLING
 
   // we don't check for valid values of rolling_enabled, rolling_interval_sec,
@@ -378,12 +390,14 @@ LogConfig::display(FILE *fd)
   fprintf(fd, "   max_secs_per_buffer = %d\n", max_secs_per_buffer);
   fprintf(fd, "   max_space_mb_for_logs = %d\n", max_space_mb_for_logs);
   fprintf(fd, "   max_space_mb_headroom = %d\n", max_space_mb_headroom);
+  fprintf(fd, "   ring_size_mb = %d\n", ring_size_mb);
   fprintf(fd, "   hostname = %s\n", hostname);
   fprintf(fd, "   logfile_dir = %s\n", logfile_dir);
   fprintf(fd, "   logfile_perm = 0%o\n", logfile_perm);
   fprintf(fd, "   error_log_filename = %s\n", error_log_filename);
 
   fprintf(fd, "   preproc_threads = %d\n", preproc_threads);
+  fprintf(fd, "   flush_threads = %d\n", flush_threads);
   fprintf(fd, "   rolling_enabled = %d\n", rolling_enabled);
   fprintf(fd, "   rolling_interval_sec = %d\n", rolling_interval_sec);
   fprintf(fd, "   rolling_offset_hr = %d\n", rolling_offset_hr);
@@ -540,6 +554,10 @@ LogConfig::register_stat_callbacks()
                      (int)log_stat_num_flush_to_disk_stat, RecRawStatSyncSum);
   RecRegisterRawStat(log_rsb, RECT_PROCESS, "proxy.process.log.num_lost_before_flush_to_disk", RECD_COUNTER, RECP_PERSISTENT,
                      (int)log_stat_num_lost_before_flush_to_disk_stat, RecRawStatSyncSum);
+  RecRegisterRawStat(log_rsb, RECT_PROCESS, "proxy.process.log.num_lost_before_preproc", RECD_COUNTER, RECP_PERSISTENT,
+                     (int)log_stat_num_lost_before_preproc_stat, RecRawStatSyncSum);
+  RecRegisterRawStat(log_rsb, RECT_PROCESS, "proxy.process.log.buffer_full_stalls", RECD_COUNTER, RECP_PERSISTENT,
+                     (int)log_stat_buffer_full_stalls_stat, RecRawStatSyncSum);
   RecRegisterRawStat(log_rsb, RECT_PROCESS, "proxy.process.log.bytes_lost_before_preproc", RECD_INT, RECP_PERSISTENT,
                      (int)log_stat_bytes_lost_before_preproc_stat, RecRawStatSyncSum);
   RecRegisterRawStat(log_rsb, RECT_PROCESS, "proxy.process.log.bytes_sent_to_network", RECD_INT, RECP_PERSISTENT,
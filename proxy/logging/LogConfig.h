@@ -56,6 +56,8 @@ enum {
   log_stat_num_received_from_network_stat,
   log_stat_num_flush_to_disk_stat,
   log_stat_num_lost_before_flush_to_disk_stat,
+  log_stat_num_lost_before_preproc_stat,
+  log_stat_buffer_full_stalls_stat,
 
   log_stat_bytes_lost_before_preproc_stat,
   log_stat_bytes_sent_to_network_stat,
@@ -186,9 +188,11 @@ public:
   int max_secs_per_buffer;
   int max_space_mb_for_logs;
   int max_space_mb_headroom;
+  int ring_size_mb;
   int logfile_perm;
 
   int preproc_threads;
+  int flush_threads;
 
   Log::RollingEnabledValues rolling_enabled;
   int rolling_interval_sec;
@@ -30,6 +30,8 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <functional>
+#include <string_view>
 
 #include "tscore/ink_platform.h"
 #include "tscore/SimpleTokenizer.h"
@@ -70,9 +72,13 @@ LogFile::LogFile(const char *name, const char *header, LogFileFormat format, uin
     m_header(ats_strdup(header)),
     m_signature(signature),
     m_max_line_size(max_line_size),
-    m_pipe_buffer_size(pipe_buffer_size)
+    m_pipe_buffer_size(pipe_buffer_size),
+    m_flush_hash(std::hash<std::string_view>{}(name))
 {
-  if (m_file_format != LOG_FILE_PIPE) {
+  if (m_file_format == LOG_FILE_RING) {
+    m_log  = nullptr;
+    m_ring = std::make_unique<LogRing>();
+  } else if (m_file_format != LOG_FILE_PIPE) {
     m_log = new BaseLogFile(name, m_signature);
     // Use Log::config->hostname rather than Machine::instance()->hostname
     // because the former is reloadable.
@@ -199,6 +205,10 @@ LogFile::open_file()
       }
     }
 #endif // F_GETPIPE_SZ
+  } else if (m_file_format == LOG_FILE_RING) {
+    if (m_ring->open(m_name, static_cast<size_t>(Log::config->ring_size_mb) * LOG_MEGABYTE, Log::config->logfile_perm) != 0) {
+      return LOG_FILE_COULD_NOT_OPEN_FILE;
+    }
   } else {
     if (m_log) {
       int status = m_log->open_file(Log::config->logfile_perm);
@@ -217,7 +227,7 @@ LogFile::open_file()
   // file.
   //
   if (!file_exists) {
-    if (m_file_format != LOG_FILE_BINARY && m_header && m_log) {
+    if (m_file_format != LOG_FILE_BINARY && m_file_format != LOG_FILE_COLUMNAR && m_header && m_log) {
       Debug("log-file", "writing header to LogFile %s", m_name);
       writeln(m_header, strlen(m_header), fileno(m_log->m_fp), m_name);
     }
@@ -247,6 +257,10 @@ LogFile::close_file()
         RecIncrRawStat(log_rsb, this_thread()->mutex->thread_holding, log_stat_log_files_open_stat, -1);
       }
       m_fd = -1;
+    } else if (m_ring) {
+      m_ring->close();
+      Debug("log-file", "LogFile %s is closed", m_name);
+      RecIncrRawStat(log_rsb, this_thread()->mutex->thread_holding, log_stat_log_files_open_stat, -1);
     } else if (m_log) {
       if (m_log->close_file()) {
         Error("Error closing LogFile %s: %s.", m_log->get_name(), strerror(errno));
@@ -352,10 +366,12 @@ LogFile::roll(long interval_start, long interval_end, bool reopen_after_rolling)
     // the old/new object swap happens within lock/unlock calls within Diags.cc.
     // For logging log files, the rolling is implemented by renaming the original file and closing it.
     // Afterwards, the LogFile object will re-open a new file with the original file name using the original object.
-    // There is no need to protect against contention since the open/close/writes are all executed under a
-    // single log flush thread.
+    // The writes may happen on another log flush thread than the one rolling, so the close is done under
+    // m_write_mutex.
     // Since these two methods of using BaseLogFile are not compatible, we perform the logging log file specific
     // close file operation here within the containing LogFile object.
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+
     if (m_log->roll(interval_start, interval_end)) {
       if (m_log->close_file()) {
         Error("Error closing LogFile %s: %s.", m_log->get_name(), strerror(errno));
@@ -397,6 +413,7 @@ LogFile::reopen_if_moved()
   }
 
   // Both of the following log if there are problems.
+  std::lock_guard<std::mutex> lock(m_write_mutex);
   close_file();
   open_file();
   return true;
@@ -443,7 +460,7 @@ LogFile::preproc_and_try_delete(LogBuffer *lb)
     m_log->m_end_time = buffer_header->high_timestamp;
   }
 
-  if (m_file_format == LOG_FILE_BINARY) {
+  if (m_file_format == LOG_FILE_BINARY || m_file_format == LOG_FILE_COLUMNAR) {
     //
     // Ok, now we need to write the binary buffer to the file, and we
     // can do so in one swift write.  The question is, do we write the
@@ -451,6 +468,8 @@ LogFile::preproc_and_try_delete(LogBuffer *lb)
     // Even though we'll be puttint down redundant data (things that
     // don't change between buffers), it's not worth trying to separate
     // out the buffer-dependent data from the buffer-independent data.
+    // Columnar buffers are transposed and compressed by the flush
+    // thread, off the preprocessing path.
     //
     LogFlushData *flush_data = new LogFlushData(this, lb);
 
@@ -460,9 +479,7 @@ LogFile::preproc_and_try_delete(LogBuffer *lb)
 
     RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_flush_to_disk_stat, lb->header()->byte_count);
 
-    ink_atomiclist_push(Log::flush_data_list, flush_data);
-
-    Log::flush_notify->signal();
+    flush(flush_data);
 
     //
     // LogBuffer will be deleted in flush thread
@@ -471,6 +488,13 @@ LogFile::preproc_and_try_delete(LogBuffer *lb)
   } else if (m_file_format == LOG_FILE_ASCII || m_file_format == LOG_FILE_PIPE) {
     write_ascii_logbuffer3(buffer_header);
     ret = 0;
+  } else if (m_file_format == LOG_FILE_RING) {
+    // The buffer is published as is by this preproc thread, there is
+    // nothing left for a flush thread to do.
+    if (!is_open()) {
+      open_file();
+    }
+    ret = m_ring->preproc_and_try_delete(lb);
   } else {
     Note("Cannot write LogBuffer to LogFile %s; invalid file format: %d", m_name, m_file_format);
   }
@@ -480,6 +504,28 @@ done:
   return ret;
 }
 
+/*-------------------------------------------------------------------------
+  LogFile::flush
+
+  Queue the data for the flush thread that owns this file.  A file is
+  always written by the same thread, so its writes stay in order.
+  -------------------------------------------------------------------------*/
+void
+LogFile::flush(LogFlushData *flush_data)
+{
+  int idx = flush_thread();
+
+  ink_atomiclist_push(&Log::flush_data_list[idx], flush_data);
+
+  Log::flush_notify[idx].signal();
+}
+
+int
+LogFile::flush_thread() const
+{
+  return m_flush_hash % Log::flush_threads;
+}
+
 /*-------------------------------------------------------------------------
   LogFile::write_ascii_logbuffer
 
@@ -642,9 +688,7 @@ LogFile::write_ascii_logbuffer3(LogBufferHeader *buffer_header, const char *alt_
 
     RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_flush_to_disk_stat, fmt_buf_bytes);
 
-    ink_atomiclist_push(Log::flush_data_list, flush_data);
-
-    Log::flush_notify->signal();
+    flush(flush_data);
 
     total_bytes += fmt_buf_bytes;
   }
@@ -713,8 +757,9 @@ LogFile::writeln(char *data, int len, int fd, const char *path)
 void
 LogFile::check_fd()
 {
-  static bool failure_last_call    = false;
-  static unsigned stat_check_count = 1;
+  // per flush thread, each one checks its own files
+  static thread_local bool failure_last_call    = false;
+  static thread_local unsigned stat_check_count = 1;
 
   if ((stat_check_count % Log::config->file_stat_frequency) == 0) {
     //
@@ -754,6 +799,8 @@ LogFile::is_open()
 {
   if (m_file_format == LOG_FILE_PIPE) {
     return m_fd >= 0;
+  } else if (m_ring) {
+    return m_ring->is_open();
   } else {
     return m_log && m_log->is_open();
   }
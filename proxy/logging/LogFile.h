@@ -25,11 +25,15 @@
 
 #include <cstdarg>
 #include <cstdio>
+#include <memory>
+#include <mutex>
 
 #include "tscore/ink_platform.h"
 #include "LogBufferSink.h"
+#include "LogRing.h"
 
 class LogBuffer;
+class LogFlushData;
 struct LogBufferHeader;
 class LogObject;
 class BaseLogFile;
@@ -92,7 +96,18 @@ public:
   const char *
   get_format_name() const
   {
-    return (m_file_format == LOG_FILE_BINARY ? "binary" : (m_file_format == LOG_FILE_PIPE ? "ascii_pipe" : "ascii"));
+    switch (m_file_format) {
+    case LOG_FILE_BINARY:
+      return "binary";
+    case LOG_FILE_PIPE:
+      return "ascii_pipe";
+    case LOG_FILE_COLUMNAR:
+      return "columnar";
+    case LOG_FILE_RING:
+      return "ring";
+    default:
+      return "ascii";
+    }
   }
 
   static int write_ascii_logbuffer(LogBufferHeader *buffer_header, int fd, const char *path, const char *alt_format = nullptr);
@@ -103,10 +118,13 @@ public:
   void display(FILE *fd = stdout);
   int open_file();
 
+  /// Index of the flush thread that writes this file.
+  int flush_thread() const;
+
   off_t
   get_size_bytes() const
   {
-    if (m_file_format == LOG_FILE_PIPE)
+    if (m_file_format == LOG_FILE_PIPE || m_file_format == LOG_FILE_RING)
       return 0;
     else if (m_log)
       return m_log->get_size_bytes();
@@ -131,11 +149,15 @@ private:
 public:
   BaseLogFile *m_log; // BaseLogFile backs the actual file on disk
   char *m_header;
-  uint64_t m_signature;       // signature of log object stored
-  size_t m_ascii_buffer_size; // size of ascii buffer
-  size_t m_max_line_size;     // size of longest log line (record)
-  int m_pipe_buffer_size;     // this is the size of the pipe buffer set by fcntl
-  int m_fd;                   // this could back m_log or a pipe, depending on the situation
+  uint64_t m_signature;            // signature of log object stored
+  size_t m_ascii_buffer_size;      // size of ascii buffer
+  size_t m_max_line_size;          // size of longest log line (record)
+  int m_pipe_buffer_size;          // this is the size of the pipe buffer set by fcntl
+  int m_fd;                        // this could back m_log or a pipe, depending on the situation
+  std::unique_ptr<LogRing> m_ring; // the shared memory ring for LOG_FILE_RING, instead of m_log or a pipe
+
+  /// Held by the flush thread while it writes and while the file is rolled or reopened.
+  std::mutex m_write_mutex;
 
 public:
   Link<LogFile> link;
@@ -143,6 +165,11 @@ public:
   LogFile &operator=(const LogFile &) = delete;
 
 private:
+  /// Hand @a flush_data to the flush thread that writes this file.
+  void flush(LogFlushData *flush_data);
+
+  size_t m_flush_hash; // picks the flush thread, fixed by the name so a reconfigured file keeps its thread
+
   // -- member functions not allowed --
   LogFile();
 };
@@ -27,13 +27,16 @@
 
  ***************************************************************************/
 
+#include <algorithm>
 #include <memory>
+#include <string_view>
 
 #include "swoc/BufferWriter.h"
 #include "swoc/bwf_ex.h"
 #include "swoc/bwf_ip.h"
 
 #include "tscore/ink_platform.h"
+#include "tscore/Random.h"
 #include "tscpp/util/ts_errata.h"
 
 #include "LogUtils.h"
@@ -47,7 +50,7 @@
 #include "Log.h"
 
 const char *LogFilter::OPERATOR_NAME[] = {"MATCH", "CASE_INSENSITIVE_MATCH", "CONTAIN", "CASE_INSENSITIVE_CONTAIN"};
-const char *LogFilter::ACTION_NAME[]   = {"REJECT", "ACCEPT", "WIPE_FIELD_VALUE"};
+const char *LogFilter::ACTION_NAME[]   = {"REJECT", "ACCEPT", "WIPE_FIELD_VALUE", "SAMPLE"};
 
 /*-------------------------------------------------------------------------
   LogFilter::LogFilter
@@ -59,8 +62,9 @@ const char *LogFilter::ACTION_NAME[]   = {"REJECT", "ACCEPT", "WIPE_FIELD_VALUE"
 LogFilter::LogFilter(const char *name, LogField *field, LogFilter::Action action, LogFilter::Operator oper)
   : m_name(ats_strdup(name)), m_field(nullptr), m_action(action), m_operator(oper), m_type(INT_FILTER), m_num_values(0)
 {
-  m_field = new LogField(*field);
-  ink_assert(m_field);
+  if (field) {
+    m_field = new LogField(*field);
+  }
 }
 
 /*-------------------------------------------------------------------------
@@ -72,23 +76,17 @@ LogFilter::~LogFilter()
   delete m_field;
 }
 
-LogFilter *
-LogFilter::parse(const char *name, Action action, const char *condition)
+/*-------------------------------------------------------------------------
+  find_field
+
+  Look up the field named by the symbol @a field_str, which may be changed
+  in place, for filter @a name.
+  -------------------------------------------------------------------------*/
+static std::unique_ptr<LogField>
+find_field(const char *name, char *field_str)
 {
-  SimpleTokenizer tok(condition);
   std::unique_ptr<LogField> logfield;
 
-  ink_release_assert(action != N_ACTIONS);
-
-  if (tok.getNumTokensRemaining() < 3) {
-    Error("Invalid condition syntax '%s'; cannot create filter '%s'", condition, name);
-    return nullptr;
-  }
-
-  char *field_str = tok.getNext();
-  char *oper_str  = tok.getNext();
-  char *val_str   = tok.getRest();
-
   // validate field symbol
   if (strlen(field_str) > 2 && field_str[0] == '%' && field_str[1] == '<') {
     Debug("log", "Field symbol has <> form: %s", field_str);
@@ -141,6 +139,29 @@ LogFilter::parse(const char *name, Action action, const char *condition)
 
   if (!logfield) {
     Error("'%s' is not a valid field; cannot create filter '%s'", field_str, name);
+  }
+
+  return logfield;
+}
+
+LogFilter *
+LogFilter::parse(const char *name, Action action, const char *condition)
+{
+  SimpleTokenizer tok(condition);
+
+  ink_release_assert(action != N_ACTIONS);
+
+  if (tok.getNumTokensRemaining() < 3) {
+    Error("Invalid condition syntax '%s'; cannot create filter '%s'", condition, name);
+    return nullptr;
+  }
+
+  char *field_str = tok.getNext();
+  char *oper_str  = tok.getNext();
+  char *val_str   = tok.getRest();
+
+  std::unique_ptr<LogField> logfield = find_field(name, field_str);
+  if (!logfield) {
     return nullptr;
   }
 
@@ -875,6 +896,216 @@ LogFilterIP::display(FILE *fd)
   }
 }
 
+/*-------------------------------------------------------------------------
+  LogFilterSample::LogFilterSample
+  -------------------------------------------------------------------------*/
+LogFilterSample::LogFilterSample(const char *name, LogFilter *condition, LogField *key, double ratio, double rate, double burst)
+  : LogFilter(name, key, SAMPLE, MATCH), m_condition(condition), m_ratio(ratio), m_rate(rate), m_burst(burst)
+{
+  m_type       = SAMPLE_FILTER;
+  m_num_values = 1;
+
+  if (m_rate > 0) {
+    m_interval  = std::max<ink_hrtime>(1, HRTIME_SECOND / m_rate);
+    m_tolerance = static_cast<ink_hrtime>((std::max(m_burst, 1.0) - 1) * m_interval);
+    m_tat       = std::make_unique<std::atomic<ink_hrtime>[]>(m_field ? KEY_SLOTS : 1);
+  }
+}
+
+LogFilterSample::LogFilterSample(const LogFilterSample &rhs)
+  : LogFilterSample(rhs.m_name, rhs.m_condition ? copy_filter(rhs.m_condition) : nullptr, rhs.m_field, rhs.m_ratio, rhs.m_rate,
+                    rhs.m_burst)
+{
+}
+
+/*-------------------------------------------------------------------------
+  LogFilterSample::~LogFilterSample
+  -------------------------------------------------------------------------*/
+
+LogFilterSample::~LogFilterSample()
+{
+  delete m_condition;
+}
+
+/*-------------------------------------------------------------------------
+  LogFilterSample::operator==
+  -------------------------------------------------------------------------*/
+
+bool
+LogFilterSample::operator==(LogFilterSample &rhs)
+{
+  if (m_ratio != rhs.m_ratio || m_rate != rhs.m_rate || m_burst != rhs.m_burst) {
+    return false;
+  }
+  if ((m_field == nullptr) != (rhs.m_field == nullptr) || (m_field && !(*m_field == *rhs.m_field))) {
+    return false;
+  }
+  if (m_condition && rhs.m_condition) {
+    return filters_are_equal(m_condition, rhs.m_condition);
+  }
+  return m_condition == rhs.m_condition;
+}
+
+/*-------------------------------------------------------------------------
+  LogFilterSample::parse
+  -------------------------------------------------------------------------*/
+
+LogFilter *
+LogFilterSample::parse(const char *name, const char *condition, const char *key, double ratio, double rate, double burst)
+{
+  if (!(ratio > 0 && ratio <= 1)) {
+    Error("ratio %g is not in (0, 1]; cannot create filter '%s'", ratio, name);
+    return nullptr;
+  }
+  if (rate < 0 || burst < 0) {
+    Error("rate and burst can not be negative; cannot create filter '%s'", name);
+    return nullptr;
+  }
+  if (ratio == 1 && rate == 0) {
+    Error("neither a ratio below 1 nor a rate is set; cannot create filter '%s'", name);
+    return nullptr;
+  }
+
+  std::unique_ptr<LogField> keyfield;
+  if (key) {
+    std::string key_str(key);
+    keyfield = find_field(name, key_str.data());
+    if (!keyfield) {
+      return nullptr;
+    }
+  }
+
+  LogFilter *cond = nullptr;
+  if (condition) {
+    cond = LogFilter::parse(name, ACCEPT, condition);
+    if (!cond) {
+      return nullptr;
+    }
+  }
+
+  if (burst == 0) {
+    burst = rate;
+  }
+
+  return new LogFilterSample(name, cond, keyfield.get(), ratio, rate, burst);
+}
+
+/*-------------------------------------------------------------------------
+  LogFilterSample::key_hash
+
+  Marshal the key field into a zeroed buffer so that the hash does not see
+  the padding, and hash the value.
+  -------------------------------------------------------------------------*/
+
+uint64_t
+LogFilterSample::key_hash(LogAccess *lad)
+{
+  static const unsigned BUFSIZE = 1024;
+  char small_buf[BUFSIZE];
+  std::unique_ptr<char[]> big_buf;
+  char *buf        = small_buf;
+  size_t marsh_len = m_field->marshal_len(lad);
+
+  if (marsh_len > BUFSIZE) {
+    big_buf.reset(new char[marsh_len]);
+    buf = big_buf.get();
+  }
+  memset(buf, 0, marsh_len);
+  m_field->marshal(lad, buf);
+
+  if (m_field->type() == LogField::STRING) {
+    marsh_len = strnlen(buf, marsh_len);
+  }
+  return std::hash<std::string_view>{}(std::string_view(buf, marsh_len));
+}
+
+/*-------------------------------------------------------------------------
+  LogFilterSample::admit
+
+  Take a token from the bucket whose next theoretical arrival time is @a tat.
+  The bucket is empty when that time runs more than the tolerance ahead of now.
+  -------------------------------------------------------------------------*/
+
+bool
+LogFilterSample::admit(std::atomic<ink_hrtime> &tat, ink_hrtime now)
+{
+  ink_hrtime t = tat.load(std::memory_order_relaxed);
+  ink_hrtime next;
+
+  do {
+    ink_hrtime start = std::max(t, now);
+    if (start - now > m_tolerance) {
+      return false;
+    }
+    next = start + m_interval;
+  } while (!tat.compare_exchange_weak(t, next, std::memory_order_relaxed));
+
+  return true;
+}
+
+/*-------------------------------------------------------------------------
+  LogFilterSample::toss_this_entry
+  -------------------------------------------------------------------------*/
+
+bool
+LogFilterSample::toss_this_entry(LogAccess *lad)
+{
+  if (lad == nullptr || (m_condition && m_condition->toss_this_entry(lad))) {
+    return false;
+  }
+
+  return toss(m_field ? key_hash(lad) : 0, ink_get_hrtime());
+}
+
+bool
+LogFilterSample::toss(uint64_t hash, ink_hrtime now)
+{
+  if (m_ratio < 1) {
+    // with a key, use the high bits of the hash so a key value is always kept or always tossed
+    double p = m_field ? (hash >> 11) * 0x1.0p-53 : ts::Random::drandom();
+    if (p >= m_ratio) {
+      return true;
+    }
+  }
+
+  if (m_tat) {
+    size_t slot = m_field ? hash % KEY_SLOTS : 0;
+    return !admit(m_tat[slot], now);
+  }
+  return false;
+}
+
+bool
+LogFilterSample::wipe_this_entry(LogAccess * /* lad ATS_UNUSED */)
+{
+  return false;
+}
+
+/*-------------------------------------------------------------------------
+  LogFilterSample::display
+  -------------------------------------------------------------------------*/
+
+void
+LogFilterSample::display(FILE *fd)
+{
+  ink_assert(fd != nullptr);
+  fprintf(fd, "Filter \"%s\" SAMPLES records", m_name);
+  if (m_ratio < 1) {
+    fprintf(fd, ", ratio %g", m_ratio);
+  }
+  if (m_rate > 0) {
+    fprintf(fd, ", rate %g/s burst %g", m_rate, m_burst);
+  }
+  if (m_field) {
+    fprintf(fd, " per %s", m_field->symbol());
+  }
+  fprintf(fd, "\n");
+  if (m_condition) {
+    fprintf(fd, "  selected by: ");
+    m_condition->display(fd);
+  }
+}
+
 bool
 filters_are_equal(LogFilter *filt1, LogFilter *filt2)
 {
@@ -889,6 +1120,8 @@ filters_are_equal(LogFilter *filt1, LogFilter *filt2)
       ret = (*((LogFilterIP *)filt1) == *((LogFilterIP *)filt2));
     } else if (filt1->type() == LogFilter::STRING_FILTER) {
       ret = (*((LogFilterString *)filt1) == *((LogFilterString *)filt2));
+    } else if (filt1->type() == LogFilter::SAMPLE_FILTER) {
+      ret = (*((LogFilterSample *)filt1) == *((LogFilterSample *)filt2));
     } else {
       ink_assert(!"invalid filter type");
     }
@@ -898,6 +1131,21 @@ filters_are_equal(LogFilter *filt1, LogFilter *filt2)
   return ret;
 }
 
+LogFilter *
+copy_filter(LogFilter *filter)
+{
+  switch (filter->type()) {
+  case LogFilter::INT_FILTER:
+    return new LogFilterInt(*((LogFilterInt *)filter));
+  case LogFilter::IP_FILTER:
+    return new LogFilterIP(*((LogFilterIP *)filter));
+  case LogFilter::SAMPLE_FILTER:
+    return new LogFilterSample(*((LogFilterSample *)filter));
+  default:
+    return new LogFilterString(*((LogFilterString *)filter));
+  }
+}
+
 /*-------------------------------------------------------------------------
   LogFilterList
 
@@ -964,19 +1212,18 @@ LogFilterList::add(LogFilter *filter, bool copy)
 {
   ink_assert(filter != nullptr);
   if (copy) {
-    if (filter->type() == LogFilter::INT_FILTER) {
-      LogFilterInt *f = new LogFilterInt(*((LogFilterInt *)filter));
-      m_filter_list.enqueue(f);
-    } else if (filter->type() == LogFilter::IP_FILTER) {
-      LogFilterIP *f = new LogFilterIP(*((LogFilterIP *)filter));
-      m_filter_list.enqueue(f);
-    } else {
-      LogFilterString *f = new LogFilterString(*((LogFilterString *)filter));
-      m_filter_list.enqueue(f);
+    filter = copy_filter(filter);
+  }
+
+  // keep the sample filters last, so they only count the entries that the
+  // other filters keep
+  LogFilter *after = m_filter_list.tail;
+  if (filter->type() != LogFilter::SAMPLE_FILTER) {
+    while (after && after->type() == LogFilter::SAMPLE_FILTER) {
+      after = (after->link).prev;
     }
-  } else {
-    m_filter_list.enqueue(filter);
   }
+  m_filter_list.insert(filter, after);
 }
 
 /*-------------------------------------------------------------------------
@@ -23,9 +23,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include "swoc/swoc_ip.h"
 
 #include "tscore/ink_platform.h"
+#include "tscore/ink_hrtime.h"
 #include "tscore/Ptr.h"
 #include "LogAccess.h"
 #include "LogField.h"
@@ -46,6 +50,7 @@ public:
     INT_FILTER = 0,
     STRING_FILTER,
     IP_FILTER,
+    SAMPLE_FILTER,
     N_TYPES,
   };
 
@@ -53,6 +58,7 @@ public:
     REJECT = 0,
     ACCEPT,
     WIPE_FIELD_VALUE,
+    SAMPLE,
     N_ACTIONS,
   };
 
@@ -246,7 +252,70 @@ private:
   LogFilterIP();
 };
 
+/*-------------------------------------------------------------------------
+  LogFilterSample
+
+  Keeps only a sample of the entries that match its condition, entries that
+  do not match (or that another filter of the list tosses) are not counted.
+  Like every filter it runs before the entry is marshalled, so a tossed
+  entry costs only the marshalling of the condition and key fields.
+
+  The ratio keeps each entry with that probability, or with a key, keeps
+  every entry of that fraction of the key values. The rate caps the entries
+  kept per second, a token bucket of burst entries kept as the theoretical
+  arrival time of the next entry (GCRA), so it needs no lock. With a key,
+  every key value gets its own bucket, in a table of KEY_SLOTS buckets that
+  colliding values share.
+  -------------------------------------------------------------------------*/
+class LogFilterSample : public LogFilter
+{
+public:
+  static constexpr unsigned KEY_SLOTS = 1024;
+
+  LogFilterSample(const char *name, LogFilter *condition, LogField *key, double ratio, double rate, double burst);
+  LogFilterSample(const LogFilterSample &rhs);
+  ~LogFilterSample() override;
+  bool operator==(LogFilterSample &rhs);
+
+  bool toss_this_entry(LogAccess *lad) override;
+  bool wipe_this_entry(LogAccess *lad) override;
+  void display(FILE *fd = stdout) override;
+
+  /** Whether to toss an entry that matches the condition, at time @a now.
+
+      @a hash is the hash of the entry's key value, it is not used without a key.
+   */
+  bool toss(uint64_t hash, ink_hrtime now);
+
+  /** Create a sample filter.
+
+      @a condition and @a key may be nullptr, a filter without a condition
+      samples every entry. Returns nullptr if the arguments are not valid.
+   */
+  static LogFilter *parse(const char *name, const char *condition, const char *key, double ratio, double rate, double burst);
+
+  // noncopyable
+  LogFilterSample &operator=(LogFilterSample &rhs) = delete;
+
+private:
+  uint64_t key_hash(LogAccess *lad);
+  bool admit(std::atomic<ink_hrtime> &tat, ink_hrtime now);
+
+  LogFilter *m_condition = nullptr; // an ACCEPT filter selecting the sampled entries
+  double m_ratio         = 1.0;     // fraction of the entries (or key values) kept
+  double m_rate          = 0;       // entries per second, 0 for no cap
+  double m_burst         = 0;       // entries the bucket holds
+  ink_hrtime m_interval  = 0;       // time between entries at the rate
+  ink_hrtime m_tolerance = 0;       // how far ahead of now the next arrival time may run
+
+  std::unique_ptr<std::atomic<ink_hrtime>[]> m_tat; // theoretical arrival time of the next entry, per key slot
+
+  // -- member functions that are not allowed --
+  LogFilterSample();
+};
+
 bool filters_are_equal(LogFilter *filt1, LogFilter *filt2);
+LogFilter *copy_filter(LogFilter *filter);
 
 /*-------------------------------------------------------------------------
   LogFilterList
@@ -38,7 +38,9 @@ enum LogFormatType {
 enum LogFileFormat {
   LOG_FILE_BINARY,
   LOG_FILE_ASCII,
-  LOG_FILE_PIPE, // ie. ASCII pipe
+  LOG_FILE_PIPE,     // ie. ASCII pipe
+  LOG_FILE_COLUMNAR, // binary, stored by column and compressed
+  LOG_FILE_RING,     // binary, published to a shared memory ring
   N_LOGFILE_TYPES
 };
 
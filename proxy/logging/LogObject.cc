@@ -38,6 +38,7 @@
 #include "tscore/TestBox.h"
 
 #include <algorithm>
+#include <atomic>
 #include <vector>
 #include <thread>
 #include <map>
@@ -54,6 +55,16 @@ should_roll_on_size(Log::RollingEnabledValues roll)
   return roll == Log::ROLL_ON_SIZE_ONLY || roll == Log::ROLL_ON_TIME_OR_SIZE;
 }
 
+/// The preproc thread a logging thread hands its full buffers to. Fixed per thread, so the threads
+/// do not all bump one shared counter next to the object's buffer head.
+static unsigned
+buffer_manager_shard()
+{
+  static std::atomic<unsigned> next_shard{0};
+  thread_local unsigned shard = next_shard++;
+  return shard;
+}
+
 size_t
 LogBufferManager::preproc_buffers(LogBufferSink *sink)
 {
@@ -68,6 +79,8 @@ LogBufferManager::preproc_buffers(LogBufferSink *sink)
       Warning("Dropping log buffer, can't keep up.");
       RecIncrRawStat(log_rsb, this_thread()->mutex->thread_holding, log_stat_bytes_lost_before_preproc_stat,
                      b->header()->byte_count);
+      RecIncrRawStat(log_rsb, this_thread()->mutex->thread_holding, log_stat_num_lost_before_preproc_stat,
+                     b->m_state.s.num_entries);
       delete b;
     } else {
       new_q.push(b);
@@ -117,6 +130,10 @@ LogObject::LogObject(LogConfig *cfg, const LogFormat *format, const char *log_di
     m_flags |= BINARY;
   } else if (file_format == LOG_FILE_PIPE) {
     m_flags |= WRITES_TO_PIPE;
+  } else if (file_format == LOG_FILE_COLUMNAR) {
+    m_flags |= COLUMNAR;
+  } else if (file_format == LOG_FILE_RING) {
+    m_flags |= WRITES_TO_RING;
   }
 
   generate_filenames(log_dir, basename, file_format);
@@ -215,6 +232,14 @@ LogObject::generate_filenames(const char *log_dir, const char *basename, LogFile
       ext     = LOG_FILE_PIPE_OBJECT_FILENAME_EXTENSION;
       ext_len = 5;
       break;
+    case LOG_FILE_COLUMNAR:
+      ext     = LOG_FILE_COLUMNAR_OBJECT_FILENAME_EXTENSION;
+      ext_len = 5;
+      break;
+    case LOG_FILE_RING:
+      ext     = LOG_FILE_RING_OBJECT_FILENAME_EXTENSION;
+      ext_len = 5;
+      break;
     default:
       ink_assert(!"unknown file format");
     }
@@ -280,8 +305,18 @@ LogObject::compute_signature(LogFormat *format, char *filename, unsigned int fla
     int buf_size = strlen(fl) + strlen(ps) + strlen(filename) + 2;
     char *buffer = static_cast<char *>(ats_malloc(buf_size));
 
-    ink_string_concatenate_strings(buffer, fl, ps, filename,
-                                   flags & LogObject::BINARY ? "B" : (flags & LogObject::WRITES_TO_PIPE ? "P" : "A"), NULL);
+    const char *mode = "A";
+    if (flags & LogObject::BINARY) {
+      mode = "B";
+    } else if (flags & LogObject::WRITES_TO_PIPE) {
+      mode = "P";
+    } else if (flags & LogObject::COLUMNAR) {
+      mode = "C";
+    } else if (flags & LogObject::WRITES_TO_RING) {
+      mode = "R";
+    }
+
+    ink_string_concatenate_strings(buffer, fl, ps, filename, mode, NULL);
 
     CryptoHash hash;
     CryptoContext().hash_immediate(hash, buffer, buf_size - 1);
@@ -383,7 +418,7 @@ LogObject::_checkout_write(size_t *write_offset, size_t bytes_needed)
       if (FREELIST_POINTER(old_h) == FREELIST_POINTER(h)) {
         ink_atomic_increment(&buffer->m_references, FREELIST_VERSION(old_h) - 1);
 
-        int idx = m_buffer_manager_idx++ % m_flush_threads;
+        int idx = buffer_manager_shard() % m_flush_threads;
         Debug("log-logbuffer", "adding buffer %d to flush list after checkout", buffer->get_id());
         m_buffer_manager[idx].add_to_flush_queue(buffer);
         Log::preproc_notify[idx].signal();
@@ -396,6 +431,7 @@ LogObject::_checkout_write(size_t *write_offset, size_t bytes_needed)
     case LogBuffer::LB_RETRY:
       // no more room, but another thread should be taking care of creating a new buffer, so yield to let
       // the other thread finish, then try again
+      RecIncrRawStat(log_rsb, this_thread()->mutex->thread_holding, log_stat_buffer_full_stalls_stat, 1);
       std::this_thread::yield();
       break;
 
@@ -562,7 +598,7 @@ ThreadLocalLogBufferManager::thread_local_buffer(LogObject *o, size_t *offset, s
 void
 LogObject::flush_buffer(LogBuffer *buffer)
 {
-  int idx = m_buffer_manager_idx++ % m_flush_threads;
+  int idx = buffer_manager_shard() % m_flush_threads;
   Debug("log-logbuffer", "adding buffer %d to flush list after checkout", buffer->get_id());
   m_buffer_manager[idx].add_to_flush_queue(buffer);
   Log::preproc_notify[idx].signal();
@@ -575,10 +611,10 @@ LogObject::log(LogAccess *lad, std::string_view text_entry)
   size_t offset       = 0; // prevent warning
   size_t bytes_needed = 0, bytes_used = 0;
 
-  // log to a pipe even if space is exhausted since pipe uses no space
-  // likewise, send data to a remote client even if local space is exhausted
-  // (if there is a remote client, m_logFile will be NULL
-  if (Log::config->logging_space_exhausted && !writes_to_pipe() && m_logFile) {
+  // log to a pipe or ring even if space is exhausted since they use no
+  // more space; likewise, send data to a remote client even if local
+  // space is exhausted (if there is a remote client, m_logFile will be NULL
+  if (Log::config->logging_space_exhausted && !writes_to_pipe() && !writes_to_ring() && m_logFile) {
     Debug("log", "logging space exhausted, can't write to:%s, drop this entry", m_logFile->get_name());
     return Log::FULL;
   }
@@ -819,8 +855,8 @@ LogObject::_roll_files(long last_roll_time, long time_now)
   unsigned num_rolled = 0;
 
   if (m_logFile) {
-    // no need to roll if object writes to a pipe
-    if (!writes_to_pipe()) {
+    // no need to roll if object writes to a pipe or ring
+    if (!writes_to_pipe() && !writes_to_ring()) {
       num_rolled += m_logFile->roll(last_roll_time, time_now, m_reopen_after_rolling);
 
       if (Log::config->auto_delete_rolled_files && m_max_rolled > 0) {
@@ -1030,7 +1066,12 @@ LogObjectManager::_solve_filename_conflicts(LogObject *log_object, int maxConfli
 
         bool roll_file = true;
 
-        if (log_object->writes_to_pipe()) {
+        if (log_object->writes_to_ring()) {
+          // Rings have no meta file. Keep the existing file, the unread
+          // buffers in it are still wanted and LogRing::open reinitializes
+          // it if it is not a ring of the right size.
+          roll_file = false;
+        } else if (log_object->writes_to_pipe()) {
           // Verify whether the existing file is a pipe. If it is,
           // disable the roll_file flag so we don't attempt rolling.
           struct stat s;
@@ -1207,12 +1248,12 @@ LogObjectManager::add_filter_to_all(LogFilter *filter)
 void
 LogObjectManager::open_local_pipes()
 {
-  // for all local objects that write to a pipe, call open_file to force
-  // the creation of the pipe so that any potential reader can see it
+  // for all local objects that write to a pipe or ring, call open_file to
+  // force their creation so that any potential reader can see them
   //
   for (unsigned i = 0; i < this->_objects.size(); i++) {
     LogObject *obj = _objects[i];
-    if (obj->writes_to_pipe()) {
+    if (obj->writes_to_pipe() || obj->writes_to_ring()) {
       obj->m_logFile->open_file();
     }
   }
@@ -45,9 +45,11 @@
   consist of a list of LogObjects.
   -------------------------------------------------------------------------*/
 
-#define LOG_FILE_ASCII_OBJECT_FILENAME_EXTENSION  ".log"
-#define LOG_FILE_BINARY_OBJECT_FILENAME_EXTENSION ".blog"
-#define LOG_FILE_PIPE_OBJECT_FILENAME_EXTENSION   ".pipe"
+#define LOG_FILE_ASCII_OBJECT_FILENAME_EXTENSION    ".log"
+#define LOG_FILE_BINARY_OBJECT_FILENAME_EXTENSION   ".blog"
+#define LOG_FILE_PIPE_OBJECT_FILENAME_EXTENSION     ".pipe"
+#define LOG_FILE_COLUMNAR_OBJECT_FILENAME_EXTENSION ".clog"
+#define LOG_FILE_RING_OBJECT_FILENAME_EXTENSION     ".ring"
 
 #define FLUSH_ARRAY_SIZE (512 * 4)
 
@@ -88,10 +90,14 @@ public:
     BINARY                   = 1,
     WRITES_TO_PIPE           = 4,
     LOG_OBJECT_FMT_TIMESTAMP = 8, // always format a timestamp into each log line (for raw text logs)
+    COLUMNAR                 = 16,
+    WRITES_TO_RING           = 32,
   };
 
   // BINARY: log is written in binary format (rather than ascii)
   // WRITES_TO_PIPE: object writes to a named pipe rather than to a file
+  // COLUMNAR: log is written in the columnar binary format
+  // WRITES_TO_RING: object publishes its buffers to a shared memory ring rather than to a file
 
   LogObject(LogConfig *cfg, const LogFormat *format, const char *log_dir, const char *basename, LogFileFormat file_format,
             const char *header, Log::RollingEnabledValues rolling_enabled, int flush_threads, int rolling_interval_sec = 0,
@@ -208,6 +214,11 @@ public:
     return (m_flags & WRITES_TO_PIPE) ? true : false;
   }
   inline bool
+  writes_to_ring() const
+  {
+    return (m_flags & WRITES_TO_RING) ? true : false;
+  }
+  inline bool
   writes_to_disk()
   {
     return (m_logFile && !(m_flags & WRITES_TO_PIPE) ? true : false);
@@ -0,0 +1,345 @@
+/** @file
+
+  Shared memory ring of raw LogBuffers, read by a local collector.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "tscore/ink_align.h"
+#include "tscore/Diags.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "P_EventSystem.h"
+#include "LogRing.h"
+#include "LogBuffer.h"
+#include "LogConfig.h"
+
+namespace
+{
+/// Map @a size bytes of @a fd shared, or return nullptr.
+void *
+map_ring(int fd, size_t size)
+{
+  void *map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  return map == MAP_FAILED ? nullptr : map;
+}
+
+bool
+valid_header(const LogRingHeader *header, size_t map_size)
+{
+  if (header->cookie != LOG_RING_COOKIE) {
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  uint64_t capacity = header->capacity;
+  return header->version == LOG_RING_VERSION && capacity && (capacity & (capacity - 1)) == 0 &&
+         LOG_RING_DATA_OFFSET + capacity == map_size;
+}
+} // namespace
+
+/// A ring file mapped by the proxy, unmapped when its last LogRing is closed.
+struct LogRingMap {
+  std::mutex mutex; // held by the producer
+  LogRingHeader *header = nullptr;
+  char *data            = nullptr;
+  size_t size           = 0;
+
+  ~LogRingMap() { munmap(header, size); }
+};
+
+namespace
+{
+// The rings mapped by this process, by path. A second mapping of a ring would have a producer of
+// its own, and reinitializing the file could truncate it under the first mapping.
+std::mutex ring_maps_mutex;
+std::unordered_map<std::string, std::weak_ptr<LogRingMap>> ring_maps;
+} // namespace
+
+/*-------------------------------------------------------------------------
+  LogRing
+  -------------------------------------------------------------------------*/
+
+LogRing::~LogRing()
+{
+  close();
+}
+
+int
+LogRing::open(const char *path, size_t capacity, int perm)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (m_map) {
+    return 0;
+  }
+
+  uint64_t ring_capacity = 1;
+  while (ring_capacity < capacity) {
+    ring_capacity <<= 1;
+  }
+  size_t size = LOG_RING_DATA_OFFSET + ring_capacity;
+
+  std::lock_guard<std::mutex> maps_lock(ring_maps_mutex);
+  std::weak_ptr<LogRingMap> &shared = ring_maps[path];
+
+  if ((m_map = shared.lock())) {
+    if (m_map->header->capacity != ring_capacity) {
+      Warning("Log ring %s is in use with %" PRIu64 " bytes, it is resized when traffic_server restarts", path,
+              m_map->header->capacity);
+    }
+    Debug("log-ring", "Sharing log ring %s", path);
+    return 0;
+  }
+
+  int fd = ::open(path, O_RDWR | O_CREAT, perm);
+  if (fd < 0) {
+    SiteThrottledError("Could not open log ring %s: %s", path, strerror(errno));
+    return -1;
+  }
+
+  // Allocate every block up front, a store to a hole of the mapping that can not be filled
+  // would kill the proxy with SIGBUS.
+  struct stat s;
+  bool reuse = fstat(fd, &s) == 0 && static_cast<size_t>(s.st_size) == size;
+  int err    = 0;
+  if (!reuse) {
+    err = ftruncate(fd, 0) == 0 ? posix_fallocate(fd, 0, size) : errno;
+  }
+  void *map = err ? nullptr : map_ring(fd, size);
+
+  if (map == nullptr) {
+    SiteThrottledError("Could not map log ring %s: %s", path, strerror(err ? err : errno));
+    ::close(fd);
+    return -1;
+  }
+  ::close(fd);
+
+  LogRingHeader *header = static_cast<LogRingHeader *>(map);
+  if (reuse && valid_header(header, size) && header->head.load() - header->tail.load() <= ring_capacity) {
+    Debug("log-ring", "Reusing log ring %s, %" PRIu64 " bytes unread", path, header->head.load() - header->tail.load());
+  } else {
+    header->cookie   = 0;
+    header->version  = LOG_RING_VERSION;
+    header->capacity = ring_capacity;
+    header->head.store(0);
+    header->dropped.store(0);
+    header->tail.store(0);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->cookie = LOG_RING_COOKIE;
+    Debug("log-ring", "Created log ring %s of %" PRIu64 " bytes", path, ring_capacity);
+  }
+
+  m_map         = std::make_shared<LogRingMap>();
+  m_map->header = header;
+  m_map->data   = static_cast<char *>(map) + LOG_RING_DATA_OFFSET;
+  m_map->size   = size;
+  shared        = m_map;
+  return 0;
+}
+
+void
+LogRing::close()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_map.reset();
+}
+
+bool
+LogRing::is_open()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_map != nullptr;
+}
+
+bool
+LogRing::publish(const LogBufferHeader *buffer)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (!m_map) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> producer_lock(m_map->mutex);
+  LogRingHeader *header = m_map->header;
+  char *data            = m_map->data;
+  uint64_t capacity     = header->capacity;
+  uint64_t head         = header->head.load(std::memory_order_relaxed);
+  uint64_t tail         = header->tail.load(std::memory_order_acquire);
+  uint64_t length       = INK_ALIGN(sizeof(LogRingRecord) + buffer->byte_count, 8);
+  uint64_t offset       = head & (capacity - 1);
+  uint64_t pad          = offset + length > capacity ? capacity - offset : 0;
+
+  if (head + pad + length - tail > capacity) {
+    header->dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  if (pad) {
+    LogRingRecord *record = reinterpret_cast<LogRingRecord *>(data + offset);
+    record->length        = pad;
+    record->type          = LogRingRecord::PAD;
+    offset                = 0;
+  }
+
+  LogRingRecord *record = reinterpret_cast<LogRingRecord *>(data + offset);
+  record->length        = length;
+  record->type          = LogRingRecord::BUFFER;
+  memcpy(record + 1, buffer, buffer->byte_count);
+
+  header->head.store(head + pad + length, std::memory_order_release);
+  return true;
+}
+
+int
+LogRing::preproc_and_try_delete(LogBuffer *lb)
+{
+  ProxyMutex *mutex       = this_thread()->mutex.get();
+  LogBufferHeader *header = lb->header();
+  int ret                 = -1;
+
+  ink_atomic_increment(&lb->m_references, 1);
+
+  if (header && header->entry_count) {
+    if (publish(header)) {
+      RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_num_flush_to_disk_stat, header->entry_count);
+      RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_flush_to_disk_stat, header->byte_count);
+      RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_written_to_disk_stat, header->byte_count);
+      ret = 0;
+    } else {
+      SiteThrottledWarning("Log ring is full or not open, dropped %u entries", header->entry_count);
+      RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_num_lost_before_flush_to_disk_stat, header->entry_count);
+      RecIncrRawStat(log_rsb, mutex->thread_holding, log_stat_bytes_lost_before_flush_to_disk_stat, header->byte_count);
+    }
+  }
+
+  LogBuffer::destroy(lb);
+  return ret;
+}
+
+/*-------------------------------------------------------------------------
+  LogRingReader
+  -------------------------------------------------------------------------*/
+
+LogRingReader::~LogRingReader()
+{
+  close();
+}
+
+bool
+LogRingReader::open(const char *path)
+{
+  struct stat s;
+  int fd = ::open(path, O_RDWR);
+
+  if (fd < 0) {
+    return false;
+  }
+  if (fstat(fd, &s) != 0 || static_cast<size_t>(s.st_size) <= LOG_RING_DATA_OFFSET) {
+    ::close(fd);
+    return false;
+  }
+
+  size_t size = s.st_size;
+  void *map   = map_ring(fd, size);
+  ::close(fd);
+
+  if (map == nullptr) {
+    return false;
+  }
+  if (!valid_header(static_cast<LogRingHeader *>(map), size)) {
+    munmap(map, size);
+    return false;
+  }
+
+  m_header   = static_cast<LogRingHeader *>(map);
+  m_data     = static_cast<char *>(map) + LOG_RING_DATA_OFFSET;
+  m_map_size = size;
+  m_capacity = m_header->capacity;
+  m_length   = 0;
+  m_corrupt  = false;
+  return true;
+}
+
+void
+LogRingReader::close()
+{
+  if (m_header) {
+    munmap(m_header, m_map_size);
+    m_header = nullptr;
+  }
+}
+
+LogBufferHeader *
+LogRingReader::next()
+{
+  if (!m_header || m_corrupt) {
+    return nullptr;
+  }
+
+  uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+  uint64_t head = m_header->head.load(std::memory_order_acquire);
+
+  while (tail != head) {
+    uint64_t offset       = tail & (m_capacity - 1);
+    LogRingRecord *record = reinterpret_cast<LogRingRecord *>(m_data + offset);
+    uint32_t length       = record->length;
+
+    if (length < sizeof(LogRingRecord) || length % 8 || length > head - tail || offset + length > m_capacity) {
+      m_corrupt = true;
+      return nullptr;
+    }
+
+    if (record->type == LogRingRecord::PAD) {
+      tail += length;
+      m_header->tail.store(tail, std::memory_order_release);
+      continue;
+    }
+
+    LogBufferHeader *buffer = reinterpret_cast<LogBufferHeader *>(record + 1);
+    if (record->type != LogRingRecord::BUFFER || buffer->cookie != LOG_SEGMENT_COOKIE ||
+        buffer->byte_count < sizeof(LogBufferHeader) || buffer->byte_count > length - sizeof(LogRingRecord)) {
+      m_corrupt = true;
+      return nullptr;
+    }
+
+    m_length = length;
+    return buffer;
+  }
+
+  return nullptr;
+}
+
+void
+LogRingReader::consume()
+{
+  if (m_header && m_length) {
+    m_header->tail.store(m_header->tail.load(std::memory_order_relaxed) + m_length, std::memory_order_release);
+    m_length = 0;
+  }
+}
@@ -0,0 +1,152 @@
+/** @file
+
+  Shared memory ring of raw LogBuffers, read by a local collector.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  The ring is a file that the proxy and one collector process both map. The proxy copies each
+  LogBuffer, still marshalled, into the ring and the collector reads it in place, so entries are
+  never formatted by the proxy nor copied through a pipe. The proxy never waits for the
+  collector: a buffer that does not fit in the free space is dropped and counted.
+
+  File layout:
+
+    LogRingHeader, padded to LOG_RING_DATA_OFFSET
+    data area of capacity bytes, a power of 2
+
+  The data area holds records, each a LogRingRecord followed by a LogBuffer and padded to 8
+  bytes. Records do not wrap, the space left at the end of the data area is filled with a pad
+  record instead. head and tail count the bytes ever published and consumed, head - tail is the
+  space in use. Only the proxy stores head and only the collector stores tail.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "LogBufferSink.h"
+
+#define LOG_RING_COOKIE      0x1091a9ed
+#define LOG_RING_VERSION     1
+#define LOG_RING_DATA_OFFSET 4096
+
+struct LogRingHeader {
+  uint32_t cookie;                        // LOG_RING_COOKIE, stored last when the ring is initialized
+  uint32_t version;                       // LOG_RING_VERSION
+  uint64_t capacity;                      // bytes in the data area
+  alignas(64) std::atomic<uint64_t> head; // bytes published
+  std::atomic<uint64_t> dropped;          // buffers dropped because the ring was full
+  alignas(64) std::atomic<uint64_t> tail; // bytes consumed
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the ring is shared between processes");
+static_assert(sizeof(LogRingHeader) <= LOG_RING_DATA_OFFSET);
+
+struct LogRingRecord {
+  enum Type : uint32_t {
+    PAD = 0,
+    BUFFER,
+  };
+
+  uint32_t length; // bytes of the record, including this header and the padding
+  uint32_t type;   // Type
+};
+
+struct LogRingMap;
+
+/**
+   The proxy side of a ring, a LogBufferSink that publishes every buffer it is given.
+
+   Several preproc threads may publish to the same ring, they are serialized by a mutex so the
+   ring itself has a single producer. The LogRings of the same path, e.g. those of the old and new
+   log objects during a reconfiguration, share one mapping and one mutex.
+ */
+class LogRing : public LogBufferSink
+{
+public:
+  LogRing() = default;
+  ~LogRing() override;
+
+  /** Map the ring file @a path, creating it with mode @a perm if needed.
+
+      The data area is @a capacity bytes rounded up to a power of 2. An existing ring of the same
+      capacity is reused with the buffers the collector did not read yet, any other file is
+      reinitialized. A ring already mapped by this process is shared as is, whatever its capacity.
+
+      @return 0 on success, -1 on failure.
+   */
+  int open(const char *path, size_t capacity, int perm);
+  void close();
+  bool is_open();
+
+  /// Publish the buffer and release it. Returns 0 if it was published, -1 if it was dropped.
+  int preproc_and_try_delete(LogBuffer *lb) override;
+
+  /// Copy @a buffer into the ring. Returns false if the ring is not open or has too little free space.
+  bool publish(const LogBufferHeader *buffer);
+
+private:
+  std::mutex m_mutex;
+  std::shared_ptr<LogRingMap> m_map;
+};
+
+/**
+   The collector side of a ring. The buffers are read in place, each stays valid until it is
+   consumed.
+ */
+class LogRingReader
+{
+public:
+  LogRingReader() = default;
+  ~LogRingReader();
+
+  /// Map the ring file @a path. Returns false if it can not be mapped or is not a ring.
+  bool open(const char *path);
+  void close();
+
+  /// The next buffer, or nullptr if the ring is empty or corrupt().
+  LogBufferHeader *next();
+  /// Hand the space of the buffer returned by next() back to the proxy.
+  void consume();
+
+  /// Whether next() found a record that is not valid, the ring can not be read any further.
+  bool
+  corrupt() const
+  {
+    return m_corrupt;
+  }
+
+  /// Buffers the proxy dropped because the ring was full.
+  uint64_t
+  dropped() const
+  {
+    return m_header ? m_header->dropped.load(std::memory_order_relaxed) : 0;
+  }
+
+private:
+  LogRingHeader *m_header = nullptr;
+  char *m_data            = nullptr;
+  size_t m_map_size       = 0;
+  uint64_t m_capacity     = 0;
+  uint32_t m_length       = 0; // length of the record returned by next()
+  bool m_corrupt          = false;
+};
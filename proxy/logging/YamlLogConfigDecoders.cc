@@ -28,8 +28,9 @@
 #include <algorithm>
 #include <memory>
 
-std::set<std::string> valid_log_format_keys = {"name", "format", "interval", "escape"};
-std::set<std::string> valid_log_filter_keys = {"name", "action", "condition"};
+std::set<std::string> valid_log_format_keys  = {"name", "format", "interval", "escape"};
+std::set<std::string> valid_log_filter_keys  = {"name", "action", "condition", "ratio", "rate", "burst", "key"};
+std::set<std::string> sample_log_filter_keys = {"ratio", "rate", "burst", "key"};
 
 namespace YAML
 {
@@ -98,16 +99,14 @@ convert<std::unique_ptr<LogFilter>>::decode(const Node &node, std::unique_ptr<Lo
     }
   }
 
-  // we require all keys for LogFilter
-  for (auto &&item : valid_log_filter_keys) {
+  for (auto &&item : {"name", "action"}) {
     if (!node[item]) {
-      throw YAML::ParserException(node.Mark(), "missing '" + item + "' argument");
+      throw YAML::ParserException(node.Mark(), std::string("missing '") + item + "' argument");
     }
   }
 
-  auto name      = node["name"].as<std::string>();
-  auto action    = node["action"].as<std::string>();
-  auto condition = node["condition"].as<std::string>();
+  auto name   = node["name"].as<std::string>();
+  auto action = node["action"].as<std::string>();
 
   auto action_str       = action.c_str();
   LogFilter::Action act = LogFilter::REJECT; /* lv: make gcc happy */
@@ -124,6 +123,29 @@ convert<std::unique_ptr<LogFilter>>::decode(const Node &node, std::unique_ptr<Lo
     return false;
   }
 
+  // a sample filter without a condition samples every entry, the other filters need one
+  if (act == LogFilter::SAMPLE) {
+    std::string condition = node["condition"] ? node["condition"].as<std::string>() : "";
+    std::string key       = node["key"] ? node["key"].as<std::string>() : "";
+    double ratio          = node["ratio"] ? node["ratio"].as<double>() : 1.0;
+    double rate           = node["rate"] ? node["rate"].as<double>() : 0;
+    double burst          = node["burst"] ? node["burst"].as<double>() : 0;
+
+    logFilter.reset(LogFilterSample::parse(name.c_str(), condition.empty() ? nullptr : condition.c_str(),
+                                           key.empty() ? nullptr : key.c_str(), ratio, rate, burst));
+    return true;
+  }
+
+  if (!node["condition"]) {
+    throw YAML::ParserException(node.Mark(), "missing 'condition' argument");
+  }
+  for (auto &&item : sample_log_filter_keys) {
+    if (node[item]) {
+      throw YAML::ParserException(node.Mark(), "filter: '" + item + "' is only valid with the sample action");
+    }
+  }
+
+  auto condition = node["condition"].as<std::string>();
   logFilter.reset(LogFilter::parse(name.c_str(), act, condition.c_str()));
 
   return true;
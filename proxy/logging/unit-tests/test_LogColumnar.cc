@@ -0,0 +1,240 @@
+/** @file
+
+  Catch-based tests for LogColumnar.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "tscore/ink_config.h"
+#include "tscore/ink_align.h"
+#include "tscore/ink_inet.h"
+#include "tscore/I_Version.h"
+
+#include "Log.h"
+#include "LogAccess.h"
+#include "LogBuffer.h"
+#include "LogColumnar.h"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+AppVersionInfo appVersionInfo;
+
+namespace
+{
+// Integer, IP and string fields, in the columns 1 to 6.
+const char FIELDS[] = "cqtq,ttms,chi,pssc,cqhm,pquc";
+
+enum { COLUMN_CQTQ = 1, COLUMN_TTMS, COLUMN_CHI, COLUMN_PSSC, COLUMN_CQHM, COLUMN_PQUC, N_COLUMNS };
+
+std::string
+method(unsigned i)
+{
+  return i % 4 == 3 ? "" : i % 2 ? "POST" : "GET";
+}
+
+std::string
+url(unsigned i)
+{
+  return "http://example.com/" + std::string(i % 40, 'x') + "/" + std::to_string(i);
+}
+
+// IPv4, IPv6 and no address.
+IpEndpoint
+address(unsigned i)
+{
+  IpEndpoint ip;
+  if (i % 3 == 0) {
+    ats_ip_pton("192.0.2." + std::to_string(i % 256), &ip);
+  } else if (i % 3 == 1) {
+    ats_ip_pton("2001:db8::" + std::to_string(i % 1000), &ip);
+  } else {
+    ats_ip_invalidate(&ip);
+  }
+  return ip;
+}
+
+// A LogBuffer with the entries @a first to @a first + n - 1.
+std::vector<char>
+make_buffer(unsigned first, unsigned n)
+{
+  size_t data_offset = INK_ALIGN(sizeof(LogBufferHeader) + sizeof(FIELDS), INK_MIN_ALIGN);
+  std::vector<char> buf(data_offset);
+  memcpy(buf.data() + sizeof(LogBufferHeader), FIELDS, sizeof(FIELDS));
+
+  for (unsigned i = first; i < first + n; ++i) {
+    IpEndpoint ip        = address(i);
+    std::string m        = method(i);
+    std::string u        = url(i);
+    size_t ip_len        = LogAccess::marshal_ip(nullptr, ats_is_ip(&ip) ? &ip.sa : nullptr);
+    size_t entry_len     = sizeof(LogEntryHeader) + 3 * INK_MIN_ALIGN + ip_len + LogAccess::strlen(m.c_str()) +
+                           LogAccess::strlen(u.c_str());
+    size_t offset        = buf.size();
+    LogEntryHeader entry = {1000 + i, static_cast<int32_t>(i), static_cast<uint32_t>(entry_len)};
+
+    buf.resize(offset + entry_len);
+    char *p = buf.data() + offset;
+    memcpy(p, &entry, sizeof(entry));
+    p += sizeof(entry);
+    LogAccess::marshal_int(p, entry.timestamp);
+    p += INK_MIN_ALIGN;
+    LogAccess::marshal_int(p, i * 7);
+    p += INK_MIN_ALIGN;
+    p += LogAccess::marshal_ip(p, ats_is_ip(&ip) ? &ip.sa : nullptr);
+    LogAccess::marshal_int(p, 200 + i % 3);
+    p += INK_MIN_ALIGN;
+    LogAccess::marshal_str(p, m.c_str(), LogAccess::strlen(m.c_str()));
+    p += LogAccess::strlen(m.c_str());
+    LogAccess::marshal_str(p, u.c_str(), LogAccess::strlen(u.c_str()));
+  }
+
+  LogBufferHeader *header      = reinterpret_cast<LogBufferHeader *>(buf.data());
+  header->cookie               = LOG_SEGMENT_COOKIE;
+  header->version              = LOG_SEGMENT_VERSION;
+  header->byte_count           = buf.size();
+  header->entry_count          = n;
+  header->low_timestamp        = 1000 + first;
+  header->high_timestamp       = 1000 + first + n - 1;
+  header->fmt_fieldlist_offset = sizeof(LogBufferHeader);
+  header->data_offset          = data_offset;
+  return buf;
+}
+
+const LogColumnarBlockHeader *
+block_of(const std::vector<char> &v)
+{
+  return reinterpret_cast<const LogColumnarBlockHeader *>(v.data());
+}
+} // namespace
+
+TEST_CASE("LogColumnar round trip", "[LogColumnar]")
+{
+  Log::init_fields();
+
+  std::vector<LogColumnarCompression> compressions = {LOG_COLUMNAR_NONE, LOG_COLUMNAR_ZLIB};
+#ifdef HAVE_ZSTD_H
+  compressions.push_back(LOG_COLUMNAR_ZSTD);
+#endif
+
+  LogColumnar columnar;
+  std::vector<char> block, decoded;
+
+  for (auto compression : compressions) {
+    // Several blocks of different sizes through the same instance.
+    unsigned first = 0;
+    for (unsigned n : {1, 17, 300, 5}) {
+      std::vector<char> buf = make_buffer(first, n);
+      LogBufferHeader *header = reinterpret_cast<LogBufferHeader *>(buf.data());
+
+      int size                = columnar.encode(header, block, compression);
+      REQUIRE(size == static_cast<int>(block.size()));
+      REQUIRE(LogColumnar::is_block(block.data()));
+      CHECK(block_of(block)->byte_count == block.size());
+      CHECK(block_of(block)->entry_count == n);
+      CHECK(block_of(block)->column_count == N_COLUMNS);
+      CHECK(block_of(block)->compression == compression);
+      CHECK(block_of(block)->low_timestamp == 1000 + first);
+      CHECK(block_of(block)->high_timestamp == 1000 + first + n - 1);
+
+      CHECK(LogColumnar::column(block_of(block), 0)->type == LogColumnarColumn::ENTRY_HEADER);
+      CHECK(LogColumnar::column(block_of(block), COLUMN_CHI)->type == LogField::IP);
+      CHECK(LogColumnar::column(block_of(block), COLUMN_PQUC)->type == LogField::STRING);
+      CHECK(LogColumnar::column(block_of(block), COLUMN_TTMS)->min == first * 7);
+      CHECK(LogColumnar::column(block_of(block), COLUMN_TTMS)->max == (first + n - 1) * 7);
+      CHECK(LogColumnar::column(block_of(block), N_COLUMNS) == nullptr);
+
+      REQUIRE(columnar.decode(block_of(block), decoded));
+      REQUIRE(decoded.size() == buf.size());
+      CHECK(memcmp(decoded.data(), buf.data(), buf.size()) == 0);
+
+      first += n;
+    }
+  }
+}
+
+TEST_CASE("LogColumnar column decoding", "[LogColumnar]")
+{
+  Log::init_fields();
+
+  LogColumnar columnar;
+  std::vector<char> block, decoded, column;
+  std::vector<char> buf = make_buffer(10, 50);
+
+  REQUIRE(columnar.encode(reinterpret_cast<LogBufferHeader *>(buf.data()), block) > 0);
+
+  SECTION("a variable width column starts with the size of each value")
+  {
+    REQUIRE(columnar.decode_column(block_of(block), COLUMN_PQUC, column));
+    size_t pos = 50 * sizeof(uint32_t);
+    for (unsigned i = 10; i < 60; ++i) {
+      uint32_t len;
+      memcpy(&len, column.data() + (i - 10) * sizeof(uint32_t), sizeof(len));
+      CHECK(len == static_cast<uint32_t>(LogAccess::strlen(url(i).c_str())));
+      CHECK(url(i) == column.data() + pos);
+      pos += len;
+    }
+    CHECK(pos == column.size());
+  }
+
+  SECTION("only the requested columns are decoded")
+  {
+    std::vector<bool> columns(N_COLUMNS, false);
+    columns[COLUMN_TTMS] = true;
+    columns[COLUMN_PQUC] = true;
+
+    REQUIRE(columnar.decode(block_of(block), decoded, &columns));
+    LogBufferHeader *header = reinterpret_cast<LogBufferHeader *>(decoded.data());
+    REQUIRE(header->byte_count == decoded.size());
+    CHECK(header->byte_count < buf.size());
+    CHECK(header->entry_count == 50);
+    CHECK(std::string(header->fmt_fieldlist()) == FIELDS);
+
+    LogBufferIterator iter(header);
+    LogEntryHeader *entry;
+    unsigned i = 10;
+    while ((entry = iter.next())) {
+      char *p = reinterpret_cast<char *>(entry) + sizeof(LogEntryHeader);
+      CHECK(entry->timestamp == 1000 + i);
+      CHECK(LogAccess::unmarshal_int(&p) == 0);
+      CHECK(LogAccess::unmarshal_int(&p) == i * 7);
+      IpEndpoint ip;
+      LogAccess::unmarshal_ip(&p, &ip);
+      CHECK_FALSE(ats_is_ip(&ip));
+      CHECK(LogAccess::unmarshal_int(&p) == 0);
+      CHECK(std::string(p) == DEFAULT_STR);
+      p += LogAccess::strlen(p);
+      CHECK(std::string(p) == url(i));
+      p += LogAccess::strlen(p);
+      CHECK(p == reinterpret_cast<char *>(entry) + entry->entry_len);
+      ++i;
+    }
+    CHECK(i == 60);
+  }
+
+  SECTION("a corrupt block is refused")
+  {
+    LogColumnarBlockHeader *header = reinterpret_cast<LogColumnarBlockHeader *>(block.data());
+    header->directory_offset       = header->byte_count;
+    CHECK_FALSE(columnar.decode(header, decoded));
+  }
+}
@@ -0,0 +1,185 @@
+/** @file
+
+  Catch based unit tests for LogFile, the flush thread of a file and rolling it
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tscore/I_Layout.h"
+#include "tscore/BaseLogFile.h"
+#include "tscore/Diags.h"
+#include "tscore/I_Version.h"
+#include "records/I_RecProcess.h"
+#include "records/I_RecordsConfig.h"
+#include "I_EventSystem.h"
+#include "I_Machine.h"
+
+#include "Log.h"
+#include "LogConfig.h"
+#include "LogFile.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+AppVersionInfo appVersionInfo;
+
+namespace
+{
+// What Log::init sets up for a LogFile, without starting the logging threads.
+void
+init_logging()
+{
+  Layout::create();
+  RecProcessInit();
+  LibRecordsConfigInit();
+
+  EThread *main_thread = new EThread;
+  main_thread->set_specific();
+
+  Machine::init();
+  Log::config = new LogConfig;
+  log_rsb     = RecAllocateRawStatBlock(static_cast<int>(log_stat_count));
+}
+
+// Sum of the sizes of the files in @a dir.
+off_t
+bytes_in(const std::string &dir)
+{
+  off_t total = 0;
+  DIR *d      = opendir(dir.c_str());
+  REQUIRE(d != nullptr);
+  while (struct dirent *entry = readdir(d)) {
+    struct stat st;
+    std::string path = dir + '/' + entry->d_name;
+    if (entry->d_name[0] != '.' && stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+      total += st.st_size;
+    }
+  }
+  closedir(d);
+  return total;
+}
+
+// Number of rolled files in @a dir.
+int
+rolled_in(const std::string &dir)
+{
+  int count = 0;
+  DIR *d    = opendir(dir.c_str());
+  REQUIRE(d != nullptr);
+  while (struct dirent *entry = readdir(d)) {
+    count += LogFile::rolled_logfile(entry->d_name);
+  }
+  closedir(d);
+  return count;
+}
+} // namespace
+
+TEST_CASE("LogFile flush thread", "[LogFile]")
+{
+  int const saved = Log::flush_threads;
+
+  Log::flush_threads = 4;
+  std::vector<int> files(Log::flush_threads);
+  for (int i = 0; i < 64; ++i) {
+    std::string name = "/tmp/test_LogFile." + std::to_string(i) + ".log";
+    LogFile file(name.c_str(), nullptr, LOG_FILE_ASCII, 0);
+    int idx = file.flush_thread();
+    REQUIRE(idx >= 0);
+    REQUIRE(idx < Log::flush_threads);
+    ++files[idx];
+
+    // The thread only depends on the name, a file that is configured again keeps it.
+    LogFile again(name.c_str(), "header", LOG_FILE_BINARY, 1);
+    CHECK(again.flush_thread() == idx);
+  }
+  // The files are spread over all the threads.
+  for (int n : files) {
+    CHECK(n > 0);
+  }
+
+  Log::flush_threads = 1;
+  CHECK(LogFile("/tmp/test_LogFile.log", nullptr, LOG_FILE_ASCII, 0).flush_thread() == 0);
+
+  Log::flush_threads = saved;
+}
+
+TEST_CASE("LogFile roll while another flush thread writes", "[LogFile]")
+{
+  char tmpl[] = "/tmp/test_LogFile.XXXXXX";
+  REQUIRE(mkdtemp(tmpl) != nullptr);
+  std::string dir{tmpl};
+  std::string name = dir + "/roll.log";
+
+  LogFile file(name.c_str(), nullptr, LOG_FILE_ASCII, 0);
+  REQUIRE(file.open_file() == LogFile::LOG_FILE_NO_ERROR);
+
+  constexpr int N_LINES  = 20000;
+  constexpr int N_ROLLS  = 50;
+  const std::string line = "0123456789abcdef0123456789abcdef\n";
+  std::atomic<int> failed{0};
+
+  // Writes the way the flush thread of the file does, under its write mutex.
+  std::thread writer([&]() {
+    for (int i = 0; i < N_LINES; ++i) {
+      std::lock_guard<std::mutex> lock(file.m_write_mutex);
+      int fd = file.is_open() ? file.get_fd() : -1;
+      if (fd < 0 || ::write(fd, line.data(), line.size()) != static_cast<ssize_t>(line.size())) {
+        ++failed;
+      }
+    }
+  });
+
+  // Rolls the way the first flush thread does, reopening right away.
+  int rolls = 0;
+  for (int i = 0; i < N_ROLLS; ++i) {
+    rolls += file.roll(1000 + i, 2000 + i, true);
+    std::this_thread::yield();
+  }
+  writer.join();
+
+  CHECK(failed == 0);
+  CHECK(rolls > 0);
+  CHECK(rolled_in(dir) == rolls);
+  // Every line is in the current file or in one of the rolled ones.
+  CHECK(bytes_in(dir) == static_cast<off_t>(N_LINES * line.size()));
+
+  file.close_file();
+  std::string rm = "rm -rf " + dir;
+  CHECK(system(rm.c_str()) == 0);
+}
+
+int
+main(int argc, const char **argv)
+{
+  DiagsPtr::set(new Diags("test_LogFile", nullptr, nullptr, new BaseLogFile("stderr")));
+  init_logging();
+
+  return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,234 @@
+/** @file
+
+  Catch-based tests for LogFilterSample.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tscore/ink_hrtime.h"
+#include "tscore/I_Version.h"
+
+#include "Log.h"
+#include "LogFilter.h"
+#include "YamlLogConfigDecoders.h"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+AppVersionInfo appVersionInfo;
+
+namespace
+{
+// A time well after the start of every bucket.
+constexpr ink_hrtime START = 1000 * HRTIME_SECOND;
+
+std::unique_ptr<LogFilterSample>
+make_sample(const char *key, double ratio, double rate = 0, double burst = 0)
+{
+  Log::init_fields();
+  LogFilter *filter = LogFilterSample::parse("sample", nullptr, key, ratio, rate, burst);
+  REQUIRE(filter != nullptr);
+  REQUIRE(filter->type() == LogFilter::SAMPLE_FILTER);
+  return std::unique_ptr<LogFilterSample>(static_cast<LogFilterSample *>(filter));
+}
+
+uint64_t
+hash_of(unsigned i)
+{
+  return std::hash<std::string>{}("key-" + std::to_string(i));
+}
+
+// How many of @a n entries at time @a now the filter keeps.
+unsigned
+kept(LogFilterSample &filter, uint64_t hash, ink_hrtime now, unsigned n)
+{
+  unsigned count = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    count += !filter.toss(hash, now);
+  }
+  return count;
+}
+
+// The names of the filters of a list the filters @a names are added to, in list order.
+std::vector<std::string>
+list_order(const std::vector<std::string> &names)
+{
+  LogFilterList list;
+  for (auto &name : names) {
+    LogFilter *filter;
+    if (name.rfind("sample", 0) == 0) {
+      filter = LogFilterSample::parse(name.c_str(), nullptr, nullptr, 0.5, 0, 0);
+    } else if (name == "accept") {
+      filter = LogFilter::parse(name.c_str(), LogFilter::ACCEPT, "cqhm MATCH GET");
+    } else if (name == "reject") {
+      filter = LogFilter::parse(name.c_str(), LogFilter::REJECT, "pssc MATCH 404");
+    } else {
+      filter = LogFilter::parse(name.c_str(), LogFilter::WIPE_FIELD_VALUE, "cqu CONTAIN secret");
+    }
+    REQUIRE(filter != nullptr);
+    list.add(filter, false);
+  }
+
+  std::vector<std::string> order;
+  for (LogFilter *f = list.first(); f; f = list.next(f)) {
+    order.emplace_back(f->name());
+  }
+  return order;
+}
+
+std::unique_ptr<LogFilter>
+load_filter(const std::string &yaml)
+{
+  return YAML::Load(yaml).as<std::unique_ptr<LogFilter>>();
+}
+} // namespace
+
+TEST_CASE("LogFilterSample ratio", "[LogFilterSample]")
+{
+  constexpr unsigned N = 100000;
+
+  SECTION("without a key, each entry is kept with the ratio")
+  {
+    auto filter = make_sample(nullptr, 0.1);
+    unsigned n  = kept(*filter, 0, START, N);
+    CHECK(n > N * 0.09);
+    CHECK(n < N * 0.11);
+  }
+
+  SECTION("with a key, the ratio of the key values is kept")
+  {
+    auto filter    = make_sample("cqhm", 0.25);
+    unsigned count = 0;
+    for (unsigned i = 0; i < N; ++i) {
+      count += !filter->toss(hash_of(i), START);
+    }
+    CHECK(count > N * 0.24);
+    CHECK(count < N * 0.26);
+  }
+
+  SECTION("with a key, a key value is always kept or always tossed")
+  {
+    auto filter = make_sample("cqhm", 0.5);
+    for (unsigned i = 0; i < 1000; ++i) {
+      unsigned n = kept(*filter, hash_of(i), START + i, 20);
+      CHECK((n == 0 || n == 20));
+    }
+  }
+}
+
+TEST_CASE("LogFilterSample rate", "[LogFilterSample]")
+{
+  SECTION("the burst is kept at once, then the rate")
+  {
+    auto filter = make_sample(nullptr, 1.0, 10, 5);
+
+    CHECK(kept(*filter, 0, START, 100) == 5);
+    // One entry per 100ms.
+    CHECK(kept(*filter, 0, START + 50 * HRTIME_MSECOND, 10) == 0);
+    CHECK(kept(*filter, 0, START + 100 * HRTIME_MSECOND, 10) == 1);
+    CHECK(kept(*filter, 0, START + 400 * HRTIME_MSECOND, 10) == 3);
+    // An idle bucket fills up to the burst only.
+    CHECK(kept(*filter, 0, START + 60 * HRTIME_SECOND, 100) == 5);
+  }
+
+  SECTION("the burst defaults to the rate")
+  {
+    auto filter = make_sample(nullptr, 1.0, 20);
+    CHECK(kept(*filter, 0, START, 100) == 20);
+  }
+
+  SECTION("every key value has its own bucket")
+  {
+    auto filter = make_sample("cqhm", 1.0, 10, 2);
+
+    CHECK(kept(*filter, 1, START, 10) == 2);
+    CHECK(kept(*filter, 2, START, 10) == 2);
+    // Values in the same slot share a bucket.
+    CHECK(kept(*filter, 1 + LogFilterSample::KEY_SLOTS, START, 10) == 0);
+    CHECK(kept(*filter, 1, START + 100 * HRTIME_MSECOND, 10) == 1);
+  }
+
+  SECTION("the rate caps the entries the ratio keeps")
+  {
+    auto filter    = make_sample("cqhm", 0.5, 10, 10);
+    unsigned count = 0;
+    for (unsigned i = 0; i < 1000; ++i) {
+      count += !filter->toss(hash_of(i) / LogFilterSample::KEY_SLOTS * LogFilterSample::KEY_SLOTS, START);
+    }
+    CHECK(count == 10);
+  }
+}
+
+TEST_CASE("LogFilterList keeps sample filters last", "[LogFilterSample]")
+{
+  Log::init_fields();
+
+  std::vector<std::string> names = {"sample1", "accept", "sample2", "reject", "wipe"};
+  std::vector<std::string> order;
+
+  SECTION("in the order they are added")
+  {
+    order = list_order(names);
+    CHECK(order == std::vector<std::string>{"accept", "reject", "wipe", "sample1", "sample2"});
+  }
+
+  SECTION("in reverse order")
+  {
+    order = list_order({names.rbegin(), names.rend()});
+    CHECK(order == std::vector<std::string>{"wipe", "reject", "accept", "sample2", "sample1"});
+  }
+
+  SECTION("samples first")
+  {
+    order = list_order({"sample1", "sample2", "accept", "reject"});
+    CHECK(order == std::vector<std::string>{"accept", "reject", "sample1", "sample2"});
+  }
+}
+
+TEST_CASE("LogFilterSample YAML", "[LogFilterSample]")
+{
+  Log::init_fields();
+
+  SECTION("sample filters take the sample keys")
+  {
+    auto filter = load_filter("{name: s, action: sample, key: chi, ratio: 0.5, rate: 100, burst: 10}");
+    REQUIRE(filter != nullptr);
+    CHECK(filter->type() == LogFilter::SAMPLE_FILTER);
+
+    filter = load_filter("{name: s, action: sample, condition: 'cqhm MATCH GET', rate: 100}");
+    REQUIRE(filter != nullptr);
+    CHECK(filter->type() == LogFilter::SAMPLE_FILTER);
+  }
+
+  SECTION("the sample keys are rejected with the other actions")
+  {
+    for (const char *action : {"accept", "reject", "wipe_field_value"}) {
+      for (const char *key : {"ratio: 0.5", "rate: 100", "burst: 10", "key: chi"}) {
+        std::string yaml = std::string("{name: f, action: ") + action + ", condition: 'cqhm MATCH GET', " + key + "}";
+        CAPTURE(yaml);
+        CHECK_THROWS_AS(load_filter(yaml), YAML::ParserException);
+      }
+    }
+  }
+}
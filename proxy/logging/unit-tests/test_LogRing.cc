@@ -0,0 +1,230 @@
+/** @file
+
+  Catch-based tests for LogRing and LogRingReader.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tscore/ink_align.h"
+#include "tscore/BaseLogFile.h"
+#include "tscore/Diags.h"
+#include "tscore/I_Version.h"
+
+#include "LogBuffer.h"
+#include "LogRing.h"
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+AppVersionInfo appVersionInfo;
+
+namespace
+{
+constexpr size_t CAPACITY = 64 * 1024;
+
+// A LogBuffer of @a size bytes, its bytes after the header are derived from @a seq.
+std::vector<char>
+make_buffer(uint32_t size, uint32_t seq)
+{
+  std::vector<char> buf(size);
+  for (size_t i = sizeof(LogBufferHeader); i < size; ++i) {
+    buf[i] = static_cast<char>(seq + i);
+  }
+
+  LogBufferHeader *header = reinterpret_cast<LogBufferHeader *>(buf.data());
+  header->cookie          = LOG_SEGMENT_COOKIE;
+  header->version         = LOG_SEGMENT_VERSION;
+  header->byte_count      = size;
+  header->entry_count     = seq;
+  return buf;
+}
+
+const LogBufferHeader *
+header_of(const std::vector<char> &buf)
+{
+  return reinterpret_cast<const LogBufferHeader *>(buf.data());
+}
+
+// Whether the next buffer of @a reader is @a expected, which is then consumed.
+bool
+read_back(LogRingReader &reader, const std::vector<char> &expected)
+{
+  LogBufferHeader *buffer = reader.next();
+  bool same               = buffer && buffer->byte_count == expected.size() &&
+                            memcmp(buffer, expected.data(), expected.size()) == 0;
+  reader.consume();
+  return same;
+}
+
+off_t
+file_size(const std::string &path)
+{
+  struct stat s;
+  return stat(path.c_str(), &s) == 0 ? s.st_size : -1;
+}
+
+struct TempRing {
+  std::string path;
+
+  TempRing()
+  {
+    char name[] = "/tmp/test_LogRing.XXXXXX";
+    int fd      = mkstemp(name);
+    REQUIRE(fd >= 0);
+    close(fd);
+    path = name;
+  }
+  ~TempRing() { unlink(path.c_str()); }
+};
+} // namespace
+
+TEST_CASE("LogRing", "[LogRing]")
+{
+  TempRing file;
+  LogRing ring;
+  LogRingReader reader;
+
+  REQUIRE(ring.open(file.path.c_str(), CAPACITY - 1000, 0644) == 0);
+  REQUIRE(ring.is_open());
+  CHECK(file_size(file.path) == LOG_RING_DATA_OFFSET + CAPACITY);
+  REQUIRE(reader.open(file.path.c_str()));
+  CHECK(reader.next() == nullptr);
+
+  SECTION("buffers of varying sizes are read back across the wrap point")
+  {
+    // Follow the head the way the ring does to know that records were padded at the end.
+    uint64_t head = 0;
+    unsigned pads = 0;
+
+    for (uint32_t seq = 0; seq < 500; ++seq) {
+      uint32_t size         = sizeof(LogBufferHeader) + (seq * 977) % 9000;
+      std::vector<char> buf = make_buffer(size, seq);
+
+      REQUIRE(ring.publish(header_of(buf)));
+      uint64_t length = INK_ALIGN(sizeof(LogRingRecord) + size, 8);
+      if (head % CAPACITY + length > CAPACITY) {
+        head += CAPACITY - head % CAPACITY;
+        ++pads;
+      }
+      head += length;
+
+      // Leave a few buffers unread for a while, so that pads are both read and published ahead.
+      if (seq % 4 == 3) {
+        for (uint32_t i = seq - 3; i <= seq; ++i) {
+          CHECK(read_back(reader, make_buffer(sizeof(LogBufferHeader) + (i * 977) % 9000, i)));
+        }
+      }
+    }
+
+    CHECK(head > 10 * CAPACITY);
+    CHECK(pads > 10);
+    CHECK(reader.next() == nullptr);
+    CHECK_FALSE(reader.corrupt());
+    CHECK(reader.dropped() == 0);
+  }
+
+  SECTION("a full ring drops buffers")
+  {
+    std::vector<char> buf = make_buffer(4000, 1);
+    unsigned published    = 0;
+
+    while (ring.publish(header_of(buf))) {
+      ++published;
+    }
+    CHECK(published == CAPACITY / INK_ALIGN(sizeof(LogRingRecord) + 4000, 8));
+    CHECK(reader.dropped() == 1);
+    CHECK_FALSE(ring.publish(header_of(buf)));
+    CHECK(reader.dropped() == 2);
+
+    // A small buffer still fits in what is left.
+    std::vector<char> small = make_buffer(sizeof(LogBufferHeader), 2);
+    CHECK(ring.publish(header_of(small)));
+
+    for (unsigned i = 0; i < published; ++i) {
+      CHECK(read_back(reader, buf));
+    }
+    CHECK(read_back(reader, small));
+    CHECK(reader.next() == nullptr);
+
+    // Consumed space is published to again.
+    CHECK(ring.publish(header_of(buf)));
+    CHECK(read_back(reader, buf));
+  }
+
+  SECTION("a ring of the same size is reused on reopen")
+  {
+    std::vector<char> bufs[] = {make_buffer(200, 1), make_buffer(3000, 2), make_buffer(900, 3)};
+    for (auto &buf : bufs) {
+      REQUIRE(ring.publish(header_of(buf)));
+    }
+    CHECK(read_back(reader, bufs[0]));
+    reader.close();
+    ring.close();
+    CHECK_FALSE(ring.is_open());
+
+    LogRing reopened;
+    REQUIRE(reopened.open(file.path.c_str(), CAPACITY, 0644) == 0);
+    REQUIRE(reader.open(file.path.c_str()));
+    CHECK(read_back(reader, bufs[1]));
+    CHECK(read_back(reader, bufs[2]));
+    CHECK(reader.next() == nullptr);
+    reader.close();
+    reopened.close();
+
+    // A ring of another size is created anew.
+    REQUIRE(reopened.open(file.path.c_str(), 2 * CAPACITY, 0644) == 0);
+    CHECK(file_size(file.path) == LOG_RING_DATA_OFFSET + 2 * CAPACITY);
+    REQUIRE(reader.open(file.path.c_str()));
+    CHECK(reader.next() == nullptr);
+  }
+
+  SECTION("rings of the same path share one mapping")
+  {
+    LogRing other;
+    REQUIRE(other.open(file.path.c_str(), 2 * CAPACITY, 0644) == 0);
+    CHECK(file_size(file.path) == LOG_RING_DATA_OFFSET + CAPACITY);
+
+    std::vector<char> first = make_buffer(500, 1), second = make_buffer(700, 2);
+    REQUIRE(ring.publish(header_of(first)));
+    REQUIRE(other.publish(header_of(second)));
+
+    // The ring stays mapped until its last LogRing is closed.
+    ring.close();
+    CHECK(other.is_open());
+    CHECK(read_back(reader, first));
+    CHECK(read_back(reader, second));
+    CHECK(reader.next() == nullptr);
+  }
+}
+
+int
+main(int argc, const char **argv)
+{
+  // LogRing warns when a ring in use is opened with another size.
+  DiagsPtr::set(new Diags("test_LogRing", nullptr, nullptr, new BaseLogFile("stderr")));
+
+  return Catch::Session().run(argc, argv);
+}
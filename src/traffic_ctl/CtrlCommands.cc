@@ -580,6 +580,9 @@ ServerCommand::ServerCommand(ts::Arguments *args) : CtrlCommand(args)
   if (get_parsed_arguments()->get(DRAIN_STR)) {
     _printer      = std::make_unique<GenericPrinter>(printOpts);
     _invoked_func = [&]() { server_drain(); };
+  } else if (get_parsed_arguments()->get(STALLS_STR)) {
+    _printer      = std::make_unique<ServerStallsPrinter>(printOpts);
+    _invoked_func = [&]() { server_stalls(); };
   }
 }
 
@@ -599,6 +602,13 @@ ServerCommand::server_drain()
 
   _printer->write_output(response);
 }
+
+void
+ServerCommand::server_stalls()
+{
+  auto response = invoke_rpc(ServerGetStallsRequest{});
+  _printer->write_output(response);
+}
 // //------------------------------------------------------------------------------------------------------------------------------------
 StorageCommand::StorageCommand(ts::Arguments *args) : CtrlCommand(args)
 {
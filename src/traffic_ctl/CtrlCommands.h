@@ -217,8 +217,10 @@ private:
   static inline const std::string DRAIN_STR{"drain"};
   static inline const std::string UNDO_STR{"undo"};
   static inline const std::string NO_NEW_CONN_STR{"no-new-connection"};
+  static inline const std::string STALLS_STR{"stalls"};
 
   void server_drain();
+  void server_stalls();
 };
 //
 // -----------------------------------------------------------------------------------------------------------------------------------
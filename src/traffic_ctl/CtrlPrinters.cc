@@ -332,6 +332,29 @@ CacheDiskStorageOfflinePrinter::write_output(YAML::Node const &result)
 }
 //------------------------------------------------------------------------------------------------------------------------------------
 void
+ServerStallsPrinter::write_output(YAML::Node const &result)
+{
+  auto const threshold = helper::try_extract<int>(result, "threshold_ms");
+  if (threshold <= 0) {
+    std::cout << "Stall recording is disabled, see proxy.config.thread.stall_threshold_mseconds\n";
+  }
+
+  std::string text;
+  for (auto &&stall : result["stalls"]) {
+    std::cout << swoc::bwprint(text, "thread {} {}ms ago: {}ms in {} event {}", helper::try_extract<int>(stall, "thread"),
+                               helper::try_extract<int64_t>(stall, "age_ms"), helper::try_extract<int64_t>(stall, "duration_ms"),
+                               helper::try_extract<std::string>(stall, "type"), helper::try_extract<int>(stall, "event"));
+    if (auto name = stall["handler_name"]) {
+      std::cout << " (" << name.as<std::string>() << ')';
+    }
+    if (auto plugin = stall["plugin_function"]) {
+      std::cout << " plugin function " << plugin.as<std::string>();
+    }
+    std::cout << '\n';
+  }
+}
+//------------------------------------------------------------------------------------------------------------------------------------
+void
 RPCAPIPrinter::write_output(YAML::Node const &result)
 {
   if (auto methods = result["methods"]) {
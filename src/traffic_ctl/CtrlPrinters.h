@@ -251,6 +251,14 @@ public:
   CacheDiskStorageOfflinePrinter(BasePrinter::Options opt) : BasePrinter(opt) {}
 };
 //------------------------------------------------------------------------------------------------------------------------------------
+class ServerStallsPrinter : public BasePrinter
+{
+  void write_output(YAML::Node const &result) override;
+
+public:
+  ServerStallsPrinter(BasePrinter::Options opt) : BasePrinter(opt) {}
+};
+//------------------------------------------------------------------------------------------------------------------------------------
 class RPCAPIPrinter : public BasePrinter
 {
   void write_output(YAML::Node const &result) override;
@@ -187,6 +187,15 @@ struct ServerStopDrainRequest : shared::rpc::ClientRequest {
   }
 };
 //------------------------------------------------------------------------------------------------------------------------------------
+struct ServerGetStallsRequest : shared::rpc::ClientRequest {
+  using super = shared::rpc::ClientRequest;
+  std::string
+  get_method() const override
+  {
+    return "admin_server_get_stalls";
+  }
+};
+//------------------------------------------------------------------------------------------------------------------------------------
 struct SetStorageDeviceOfflineRequest : shared::rpc::ClientRequest {
   using super = shared::rpc::ClientRequest;
   struct Params {
@@ -185,6 +185,8 @@ main(int argc, const char **argv)
     .add_example_usage("traffic_ctl server drain [OPTIONS]")
     .add_option("--no-new-connection", "-N", "Wait for new connections down to threshold before starting draining")
     .add_option("--undo", "-U", "Recover server from the drain mode");
+  server_command.add_command("stalls", "Show the recent slow event handler calls", [&]() { command->execute(); })
+    .add_example_usage("traffic_ctl server stalls");
 
   // storage commands
   storage_command
@@ -26,8 +26,9 @@
 #include "tscore/I_Layout.h"
 #include "tscore/runroot.h"
 
-#define PROGRAM_NAME       "traffic_logcat"
-#define MAX_LOGBUFFER_SIZE 65536
+#define PROGRAM_NAME            "traffic_logcat"
+#define MAX_LOGBUFFER_SIZE      65536
+#define MAX_COLUMNAR_BLOCK_SIZE (16 * 1024 * 1024)
 
 #include <poll.h>
 
@@ -41,6 +42,8 @@
 #include "LogObject.h"
 #include "LogConfig.h"
 #include "LogBuffer.h"
+#include "LogColumnar.h"
+#include "LogRing.h"
 #include "LogUtils.h"
 #include "Log.h"
 
@@ -115,6 +118,111 @@ follow_rotate(const char *input_file, ino_t old_inode_num)
   }
 }
 
+/*
+ * Reads exactly @a len bytes, waiting for more data when following a file.
+ *
+ * @returns 0 on success, 1 on failure
+ */
+static int
+read_fully(int in_fd, char *buf, int len)
+{
+  int nread = 0;
+
+  while (nread < len) {
+    int rc = read(in_fd, buf + nread, len - nread);
+
+    if (rc > 0) {
+      nread += rc;
+    } else if (!follow_flag) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*
+ * Reads the rest of a columnar block and writes its entries in ASCII
+ *
+ * @param first the start of the block header, already read
+ * @param first_read_size bytes of the block header in @a first
+ * @returns 0 on success, 1 on failure
+ */
+static int
+process_columnar_block(int in_fd, int out_fd, const char *first, unsigned first_read_size)
+{
+  static LogColumnar columnar;
+  static std::vector<char> block, entries;
+  LogColumnarBlockHeader header;
+
+  memcpy(&header, first, first_read_size);
+  if (read_fully(in_fd, reinterpret_cast<char *>(&header) + first_read_size, sizeof(header) - first_read_size) != 0) {
+    fprintf(stderr, "Bad columnar block header read!\n");
+    return 1;
+  }
+  if (header.byte_count < sizeof(header) || header.byte_count > MAX_COLUMNAR_BLOCK_SIZE) {
+    fprintf(stderr, "Bad columnar block size %u!\n", header.byte_count);
+    return 1;
+  }
+
+  block.resize(header.byte_count);
+  memcpy(block.data(), &header, sizeof(header));
+  if (read_fully(in_fd, block.data() + sizeof(header), header.byte_count - sizeof(header)) != 0) {
+    fprintf(stderr, "Bad columnar block read!\n");
+    return 1;
+  }
+
+  if (!columnar.decode(reinterpret_cast<LogColumnarBlockHeader *>(block.data()), entries)) {
+    fprintf(stderr, "Bad columnar block!\n");
+    return 1;
+  }
+
+  LogBufferHeader *buffer_header = reinterpret_cast<LogBufferHeader *>(entries.data());
+  if (buffer_header->fmt_fieldlist()) {
+    LogFile::write_ascii_logbuffer(buffer_header, out_fd, ".", nullptr);
+  }
+  return 0;
+}
+
+/*
+ * Writes the buffers of a log ring in ASCII, reading them in place, and hands
+ * their space back to the proxy. Only one reader may consume a ring at a time.
+ *
+ * @returns 0 on success, 1 on failure
+ */
+static int
+process_ring(const char *ring_file, int out_fd)
+{
+  LogRingReader ring;
+
+  if (!ring.open(ring_file)) {
+    fprintf(stderr, "Error opening log ring %s\n", ring_file);
+    return 1;
+  }
+
+  uint64_t dropped = ring.dropped();
+  while (true) {
+    while (LogBufferHeader *header = ring.next()) {
+      if (header->fmt_fieldlist()) {
+        LogFile::write_ascii_logbuffer(header, out_fd, ".", nullptr);
+      }
+      ring.consume();
+    }
+
+    if (ring.corrupt()) {
+      fprintf(stderr, "Bad log ring %s!\n", ring_file);
+      return 1;
+    }
+    if (ring.dropped() != dropped) {
+      fprintf(stderr, "The proxy dropped %" PRIu64 " buffers, the log ring %s was full\n", ring.dropped() - dropped, ring_file);
+      dropped = ring.dropped();
+    }
+    if (!follow_flag) {
+      return 0;
+    }
+    usleep(10000);
+  }
+}
+
 static int
 process_file(int in_fd, int out_fd)
 {
@@ -139,6 +247,15 @@ process_file(int in_fd, int out_fd)
       return 0;
     }
 
+    // columnar blocks and plain buffers may be mixed in a columnar log
+    //
+    if (LogColumnar::is_block(header)) {
+      if (process_columnar_block(in_fd, out_fd, buffer, first_read_size) != 0) {
+        return 1;
+      }
+      continue;
+    }
+
     // ensure that this is a valid logbuffer header
     //
     if (header->cookie != LOG_SEGMENT_COOKIE) {
@@ -294,7 +411,6 @@ main(int /* argc ATS_UNUSED */, const char *argv[])
   int error = NO_ERROR;
 
   if (n_file_arguments) {
-    int bin_ext_len   = strlen(LOG_FILE_BINARY_OBJECT_FILENAME_EXTENSION);
     int ascii_ext_len = strlen(LOG_FILE_ASCII_OBJECT_FILENAME_EXTENSION);
 
     for (unsigned i = 0; i < n_file_arguments; ++i) {
@@ -316,13 +432,17 @@ main(int /* argc ATS_UNUSED */, const char *argv[])
         posix_fadvise(in_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
 #endif
         if (auto_filenames) {
-          // change .blog to .log
+          // change .blog, .clog or .ring to .log
           //
-          int n = strlen(file_arguments[i]);
-          int copy_len =
-            (n >= bin_ext_len ?
-               (strcmp(&file_arguments[i][n - bin_ext_len], LOG_FILE_BINARY_OBJECT_FILENAME_EXTENSION) == 0 ? n - bin_ext_len : n) :
-               n);
+          int n        = strlen(file_arguments[i]);
+          int copy_len = n;
+          for (const char *ext : {LOG_FILE_BINARY_OBJECT_FILENAME_EXTENSION, LOG_FILE_COLUMNAR_OBJECT_FILENAME_EXTENSION,
+                                  LOG_FILE_RING_OBJECT_FILENAME_EXTENSION}) {
+            int ext_len = strlen(ext);
+            if (n >= ext_len && strcmp(&file_arguments[i][n - ext_len], ext) == 0) {
+              copy_len = n - ext_len;
+            }
+          }
 
           char *out_filename = (char *)ats_malloc(copy_len + ascii_ext_len + 1);
 
@@ -338,6 +458,19 @@ main(int /* argc ATS_UNUSED */, const char *argv[])
             continue;
           }
         }
+
+        // a ring is read in place and followed through its head, not read
+        // like a file
+        //
+        uint32_t cookie = 0;
+        if (pread(in_fd, &cookie, sizeof(cookie), 0) == sizeof(cookie) && cookie == LOG_RING_COOKIE) {
+          close(in_fd);
+          if (process_ring(file_arguments[i], out_fd) != 0) {
+            error = DATA_PROCESSING_ERROR;
+          }
+          continue;
+        }
+
         if (follow_flag) {
           lseek(in_fd, 0, SEEK_END);
         }
@@ -35,6 +35,7 @@
 #include "LogStandalone.cc"
 
 #include "LogObject.h"
+#include "LogColumnar.h"
 #include "hdrs/HTTP.h"
 
 #include <sys/utsname.h>
@@ -62,10 +63,11 @@ using namespace std;
 // Constants, please update the VERSION number when you make a new build!!!
 #define PROGRAM_NAME "traffic_logstats"
 
-const int MAX_LOGBUFFER_SIZE = 65536;
-const int DEFAULT_LINE_LEN   = 78;
-const double LOG10_1024      = 3.0102999566398116;
-const int MAX_ORIG_STRING    = 4096;
+const int MAX_LOGBUFFER_SIZE            = 65536;
+const unsigned MAX_COLUMNAR_BLOCK_SIZE = 16 * 1024 * 1024;
+const int DEFAULT_LINE_LEN             = 78;
+const double LOG10_1024                = 3.0102999566398116;
+const int MAX_ORIG_STRING              = 4096;
 
 // Optimizations for "strcmp()", treat some fixed length (3 or 4 bytes) strings
 // as integers.
@@ -1756,6 +1758,69 @@ parse_log_buff(LogBufferHeader *buf_header, bool summary = false, bool aggregate
   return 0;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Process a columnar block, the first first_read_size bytes of which are already read.
+// Blocks that are too old are skipped by their header, without reading their columns.
+int
+process_columnar_block(int in_fd, const char *first, unsigned first_read_size, unsigned max_age)
+{
+  static LogColumnar columnar;
+  static std::vector<char> block, entries;
+  LogColumnarBlockHeader header;
+
+  memcpy(&header, first, first_read_size);
+  int nread = read(in_fd, reinterpret_cast<char *>(&header) + first_read_size, sizeof(header) - first_read_size);
+  if (nread != static_cast<int>(sizeof(header) - first_read_size)) {
+    Debug("logstats", "Read of columnar block header failed, nread=%d, errno=%d.", nread, errno);
+    return 1;
+  }
+  if (header.byte_count < sizeof(header) || header.byte_count > MAX_COLUMNAR_BLOCK_SIZE) {
+    Debug("logstats", "Columnar block byte count [%u] is wrong.", header.byte_count);
+    return 1;
+  }
+
+  if (header.high_timestamp < max_age) {
+    Debug("logstats", "Skipping old columnar block (age=%d, max=%d)", header.high_timestamp, max_age);
+    if (lseek(in_fd, header.byte_count - sizeof(header), SEEK_CUR) < 0) {
+      return 1;
+    }
+    return 0;
+  }
+
+  block.resize(header.byte_count);
+  memcpy(block.data(), &header, sizeof(header));
+
+  int total_read = sizeof(header);
+  while (total_read < static_cast<int>(header.byte_count)) {
+    nread = read(in_fd, block.data() + total_read, header.byte_count - total_read);
+    if (EOF == nread || !nread) {
+      Debug("logstats", "Read failed while reading columnar block, wanted %d bytes, nread=%d, errno=%d",
+            header.byte_count - total_read, nread, errno);
+      return 1;
+    }
+    total_read += nread;
+  }
+
+  // parse_log_buff() reads the fields by position from ttms (column 2) to psct (column 12). It skips
+  // cqtq and shn and reads caun only per user, those are left at their default value.
+  static std::vector<bool> columns;
+  columns.assign(header.column_count, false);
+  for (unsigned idx = 2; idx <= 12 && idx < columns.size(); ++idx) {
+    columns[idx] = idx != 11 && (idx != 9 || cl.report_per_user);
+  }
+
+  if (!columnar.decode(reinterpret_cast<LogColumnarBlockHeader *>(block.data()), entries, &columns)) {
+    Debug("logstats", "Columnar block is corrupt.");
+    return 1;
+  }
+
+  if (parse_log_buff(reinterpret_cast<LogBufferHeader *>(entries.data()), cl.summary != 0, cl.report_per_user != 0) != 0) {
+    Debug("logstats", "Failed to parse columnar block.");
+    return 1;
+  }
+  return 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Process a file (FD)
 int
@@ -1790,7 +1855,7 @@ process_file(int in_fd, off_t offset, unsigned max_age)
           return 0;
         }
         // ensure that this is a valid logbuffer header
-        if (header->cookie && (LOG_SEGMENT_COOKIE == header->cookie)) {
+        if (header->cookie && (LOG_SEGMENT_COOKIE == header->cookie || LogColumnar::is_block(header))) {
           offset = 0;
           break;
         }
@@ -1806,12 +1871,19 @@ process_file(int in_fd, off_t offset, unsigned max_age)
       }
 
       // ensure that this is a valid logbuffer header
-      if (header->cookie != LOG_SEGMENT_COOKIE) {
+      if (header->cookie != LOG_SEGMENT_COOKIE && !LogColumnar::is_block(header)) {
         Debug("logstats", "Invalid segment cookie (expected %d, got %d)", LOG_SEGMENT_COOKIE, header->cookie);
         return 1;
       }
     }
 
+    if (LogColumnar::is_block(header)) {
+      if (process_columnar_block(in_fd, buffer, first_read_size, max_age) != 0) {
+        return 1;
+      }
+      continue;
+    }
+
     Debug("logstats", "LogBuffer version %d, current = %d", header->version, LOG_SEGMENT_VERSION);
     if (header->version != LOG_SEGMENT_VERSION) {
       return 1;
@@ -1455,6 +1455,8 @@ api_init()
   if (init) {
     init = 0;
 
+    EThread::StallLog::plugin_lookup = &INKContInternal::event_function;
+
     /* URL schemes */
     TS_URL_SCHEME_FILE     = URL_SCHEME_FILE;
     TS_URL_SCHEME_FTP      = URL_SCHEME_FTP;
@@ -2863,7 +2865,7 @@ tsapi::c::TSMimeHdrFieldFind(TSMBuffer bufp, TSMLoc hdr_obj, const char *name, i
   }
 
   MIMEHdrImpl *mh = _hdr_mloc_to_mime_hdr_impl(hdr_obj);
-  MIMEField *f    = mime_hdr_field_find(mh, name, length);
+  MIMEField *f    = mime_hdr_field_find(mh, name, length, ((HdrHeapSDKHandle *)bufp)->m_heap);
 
   if (f == nullptr) {
     return TS_NULL_MLOC;
@@ -2922,7 +2924,7 @@ tsapi::c::TSMimeHdrFieldAppend(TSMBuffer bufp, TSMLoc mh_mloc, TSMLoc field_mloc
   ink_assert(field_handle->mh == mh);
   ink_assert(field_handle->field_ptr->m_ptr_name);
 
-  mime_hdr_field_attach(mh, field_handle->field_ptr, 1, nullptr);
+  mime_hdr_field_attach(mh, field_handle->field_ptr, 1, nullptr, ((HdrHeapSDKHandle *)bufp)->m_heap);
   return TS_SUCCESS;
 }
 
@@ -3082,7 +3084,7 @@ tsapi::c::TSMimeHdrFieldCopy(TSMBuffer dest_bufp, TSMLoc dest_hdr, TSMLoc dest_f
                             s_handle->field_ptr->m_len_value, 0, 0, true);
 
   if (dest_attached) {
-    mime_hdr_field_attach(d_handle->mh, d_handle->field_ptr, 1, nullptr);
+    mime_hdr_field_attach(d_handle->mh, d_handle->field_ptr, 1, nullptr, d_heap);
   }
   return TS_SUCCESS;
 }
@@ -3242,7 +3244,7 @@ tsapi::c::TSMimeHdrFieldNameSet(TSMBuffer bufp, TSMLoc hdr, TSMLoc field, const
   handle->field_ptr->name_set(heap, handle->mh, name, length);
 
   if (attached) {
-    mime_hdr_field_attach(handle->mh, handle->field_ptr, 1, nullptr);
+    mime_hdr_field_attach(handle->mh, handle->field_ptr, 1, nullptr, heap);
   }
   return TS_SUCCESS;
 }
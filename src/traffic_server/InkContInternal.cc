@@ -133,6 +133,16 @@ INKContInternal::handle_event_count(int event)
   }
 }
 
+const void *
+INKContInternal::event_function(const Continuation *c)
+{
+  // Plugin continuations, and only they, all run handle_event.
+  if (c->handler != continuation_handler_void_ptr(&INKContInternal::handle_event)) {
+    return nullptr;
+  }
+  return reinterpret_cast<const void *>(static_cast<const INKContInternal *>(c)->m_event_func);
+}
+
 int
 INKContInternal::handle_event(int event, void *edata)
 {
@@ -40,6 +40,7 @@
 #include "tscore/ink_stack_trace.h"
 #include "tscore/ink_syslog.h"
 #include "tscore/hugepages.h"
+#include "tscore/numa.h"
 #include "tscore/runroot.h"
 #include "tscore/Filenames.h"
 
@@ -1857,6 +1858,11 @@ main(int /* argc ATS_UNUSED */, const char **argv)
   Debug("hugepages", "ats_pagesize reporting %zu", ats_pagesize());
   Debug("hugepages", "ats_hugepage_size reporting %zu", ats_hugepage_size());
 
+  // init NUMA arenas, before any thread is bound to a node
+  REC_ReadConfigInteger(enabled, "proxy.config.allocator.numa");
+  ats_numa_init(enabled);
+  ink_freelists_numa_init();
+
   if (!num_accept_threads) {
     REC_ReadConfigInteger(num_accept_threads, "proxy.config.accept_threads");
   }
@@ -2034,6 +2040,13 @@ main(int /* argc ATS_UNUSED */, const char **argv)
   }
 
   REC_ReadConfigInteger(thread_max_heartbeat_mseconds, "proxy.config.thread.max_heartbeat_mseconds");
+  REC_EstablishStaticConfigInt32(thread_stall_threshold_mseconds, "proxy.config.thread.stall_threshold_mseconds");
+  REC_ReadConfigInteger(thread_busy_poll_useconds, "proxy.config.thread.busy_poll_useconds");
+  if (thread_busy_poll_useconds > 0 && ink_number_of_processors() < 2) {
+    // A spinning thread would only delay the thread it waits for.
+    Warning("proxy.config.thread.busy_poll_useconds ignored with a single processor");
+    thread_busy_poll_useconds = 0;
+  }
 
 #if TS_USE_LINUX_IO_URING
   configure_io_uring();
@@ -2080,6 +2093,12 @@ main(int /* argc ATS_UNUSED */, const char **argv)
   }
 #endif
 
+  int work_stealing = 0;
+  REC_ReadConfigInteger(work_stealing, "proxy.config.exec_thread.work_stealing");
+  if (work_stealing & 2) {
+    eventProcessor.thread_group[ET_NET]._stealing = EventProcessor::ThreadGroupDescriptor::STEAL_UNBOUND;
+  }
+
   // !! ET_NET threads start here !!
   // This means any spawn scheduling must be done before this point.
   eventProcessor.start(num_of_net_threads, stacksize);
@@ -2127,6 +2146,9 @@ main(int /* argc ATS_UNUSED */, const char **argv)
     // We don't need task threads in the "command_flag" case.
     tasksProcessor.register_event_type();
     eventProcessor.thread_group[ET_TASK]._afterStartCallback = task_threads_started_callback;
+    if (work_stealing & 1) {
+      eventProcessor.thread_group[ET_TASK]._stealing = EventProcessor::ThreadGroupDescriptor::STEAL_ALL;
+    }
     tasksProcessor.start(num_task_threads, stacksize);
 
     RecProcessStart();
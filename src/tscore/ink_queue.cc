@@ -54,6 +54,7 @@
 #include "tscore/ink_assert.h"
 #include "tscore/ink_align.h"
 #include "tscore/hugepages.h"
+#include "tscore/numa.h"
 #include "tscore/Diags.h"
 #include "tscore/JeMiAllocator.h"
 
@@ -126,6 +127,30 @@ ink_freelist_init_ops(int nofl_class, int nofl_proxy)
   freelist_global_ops = (nofl_class || nofl_proxy) ? ink_freelist_malloc_ops() : ink_freelist_freelist_ops();
 }
 
+// Hugepage chunks stay out of the NUMA arenas, so those freelists keep a single stack.
+static void
+freelist_numa_init(InkFreeList *f)
+{
+  if (!ats_numa_enabled() || f->use_hugepages || f->nodes) {
+    return;
+  }
+
+  int n    = ats_numa_node_count();
+  f->nodes = static_cast<InkFreeListNode *>(ats_memalign(alignof(InkFreeListNode), n * sizeof(InkFreeListNode)));
+  memset(static_cast<void *>(f->nodes), 0, n * sizeof(InkFreeListNode));
+  for (int i = 0; i < n; ++i) {
+    SET_FREELIST_POINTER_VERSION(f->nodes[i].head, FROM_PTR(0), 0);
+  }
+}
+
+void
+ink_freelists_numa_init()
+{
+  for (ink_freelist_list *fll = freelists; fll; fll = fll->next) {
+    freelist_numa_init(fll->fl);
+  }
+}
+
 void
 ink_freelist_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32_t chunk_size, uint32_t alignment,
                   bool use_hugepages)
@@ -171,6 +196,7 @@ ink_freelist_init(InkFreeList **fl, const char *name, uint32_t type_size, uint32
   }
   Debug(DEBUG_TAG "_init", "<%s> Chunk Size request/actual (%" PRIu32 "/%" PRIu32 ")", name, chunk_size, f->chunk_size);
   SET_FREELIST_POINTER_VERSION(f->head, FROM_PTR(0), 0);
+  freelist_numa_init(f);
 
   *fl = f;
 }
@@ -194,6 +220,18 @@ ink_freelist_create(const char *name, uint32_t type_size, uint32_t chunk_size, u
 
 #define ADDRESS_OF_NEXT(x, offset) ((void **)((char *)x + offset))
 
+// The stack an item goes back to, that of the NUMA node owning its memory or the shared one.
+static inline head_p *
+freelist_head(InkFreeList *f, void *item)
+{
+  int node;
+
+  if (f->nodes && (node = ats_numa_node_of(item)) >= 0) {
+    return &f->nodes[node].head;
+  }
+  return &f->head;
+}
+
 void *
 ink_freelist_new(InkFreeList *f)
 {
@@ -206,22 +244,30 @@ ink_freelist_new(InkFreeList *f)
   return ptr;
 }
 
+// Pop an item from @a head, refilling it with a new chunk when empty. The chunk comes from the
+// arena of @a node if that is not -1, in which case nullptr is returned once the arena is exhausted.
 static void *
-freelist_new(InkFreeList *f)
+freelist_pop(InkFreeList *f, head_p *head, int node)
 {
   head_p item;
   head_p next;
   int result = 0;
 
   do {
-    INK_QUEUE_LD(item, f->head);
+    INK_QUEUE_LD(item, *head);
     if (TO_PTR(FREELIST_POINTER(item)) == nullptr) {
       uint32_t i;
       void *newp        = nullptr;
       size_t alloc_size = static_cast<size_t>(f->chunk_size) * f->type_size;
       size_t alignment  = 0;
 
-      if (f->use_hugepages) {
+      if (node >= 0) {
+        alignment = ats_pagesize();
+        newp      = ats_numa_alloc(alloc_size, node);
+        if (newp == nullptr) {
+          return nullptr;
+        }
+      } else if (f->use_hugepages) {
         alignment = ats_hugepage_size();
         newp      = ats_alloc_hugepage(alloc_size);
         if (newp == nullptr) {
@@ -255,7 +301,7 @@ freelist_new(InkFreeList *f)
 
     } else {
       SET_FREELIST_POINTER_VERSION(next, *ADDRESS_OF_NEXT(TO_PTR(FREELIST_POINTER(item)), 0), FREELIST_VERSION(item) + 1);
-      result = ink_atomic_cas(&f->head.data, item.data, next.data);
+      result = ink_atomic_cas(&head->data, item.data, next.data);
 
 #ifdef SANITY
       if (result) {
@@ -277,6 +323,18 @@ freelist_new(InkFreeList *f)
   return TO_PTR(FREELIST_POINTER(item));
 }
 
+static void *
+freelist_new(InkFreeList *f)
+{
+  // A thread bound to a NUMA node takes items of that node, and shared ones once its arena is exhausted.
+  if (int node = ats_numa_thread_node; f->nodes && node >= 0) {
+    if (void *item = freelist_pop(f, &f->nodes[node].head, node); item) {
+      return item;
+    }
+  }
+  return freelist_pop(f, &f->head, -1);
+}
+
 static void *
 malloc_new(InkFreeList *f)
 {
@@ -322,8 +380,9 @@ freelist_free(InkFreeList *f, void *item)
   }
 #endif /* DEADBEEF */
 
+  head_p *stack = freelist_head(f, item);
   while (!result) {
-    INK_QUEUE_LD(h, f->head);
+    INK_QUEUE_LD(h, *stack);
 #ifdef SANITY
     if (TO_PTR(FREELIST_POINTER(h)) == item) {
       ink_abort("ink_freelist_free: trying to free item twice");
@@ -338,7 +397,7 @@ freelist_free(InkFreeList *f, void *item)
     *adr_of_next = FREELIST_POINTER(h);
     SET_FREELIST_POINTER_VERSION(item_pair, FROM_PTR(item), FREELIST_VERSION(h));
     INK_MEMORY_BARRIER;
-    result = ink_atomic_cas(&f->head.data, h.data, item_pair.data);
+    result = ink_atomic_cas(&stack->data, h.data, item_pair.data);
   }
 }
 
@@ -365,12 +424,30 @@ static void
 freelist_bulkfree(InkFreeList *f, void *head, void *tail, size_t num_item)
 {
   void **adr_of_next = ADDRESS_OF_NEXT(tail, 0);
+  head_p *stack       = freelist_head(f, head);
   head_p h;
   head_p item_pair;
   int result = 0;
 
   // ink_assert(!((long)item&(f->alignment-1))); XXX - why is this no longer working? -bcall
 
+  if (f->nodes) {
+    // Items of different NUMA nodes go back one at a time, each to its own stack.
+    void *item = head;
+    size_t i   = 0;
+    for (; i < num_item && freelist_head(f, item) == stack; ++i) {
+      item = *ADDRESS_OF_NEXT(item, 0);
+    }
+    if (i < num_item) {
+      void *next;
+      for (i = 0, item = head; i < num_item; ++i, item = next) {
+        next = *ADDRESS_OF_NEXT(item, 0);
+        freelist_free(f, item);
+      }
+      return;
+    }
+  }
+
 #ifdef DEADBEEF
   {
     static const char str[4] = {static_cast<char>(0xde), static_cast<char>(0xad), static_cast<char>(0xbe), static_cast<char>(0xef)};
@@ -388,7 +465,7 @@ freelist_bulkfree(InkFreeList *f, void *head, void *tail, size_t num_item)
 #endif /* DEADBEEF */
 
   while (!result) {
-    INK_QUEUE_LD(h, f->head);
+    INK_QUEUE_LD(h, *stack);
 #ifdef SANITY
     if (TO_PTR(FREELIST_POINTER(h)) == head) {
       ink_abort("ink_freelist_free: trying to free item twice");
@@ -403,7 +480,7 @@ freelist_bulkfree(InkFreeList *f, void *head, void *tail, size_t num_item)
     *adr_of_next = FREELIST_POINTER(h);
     SET_FREELIST_POINTER_VERSION(item_pair, FROM_PTR(head), FREELIST_VERSION(h));
     INK_MEMORY_BARRIER;
-    result = ink_atomic_cas(&f->head.data, h.data, item_pair.data);
+    result = ink_atomic_cas(&stack->data, h.data, item_pair.data);
   }
 }
 
@@ -0,0 +1,178 @@
+/** @file
+
+  NUMA node local memory arenas.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <sys/mman.h>
+
+#include "tscore/numa.h"
+#include "tscore/Diags.h"
+#include "tscore/ink_align.h"
+#include "tscore/ink_hw.h"
+#include "tscore/ink_memory.h"
+
+#define DEBUG_TAG "numa"
+
+char *ats_numa_arena_base             = nullptr;
+size_t ats_numa_arena_size            = 0;
+thread_local int ats_numa_thread_node = -1;
+
+namespace
+{
+int numa_nodes = 0;
+/// Bytes handed out from each node's arena, the arenas are never returned.
+std::atomic<size_t> numa_arena_used[ATS_NUMA_MAX_NODES];
+/// Arena index by processor OS index.
+std::vector<int> numa_cpu_nodes;
+} // namespace
+
+void
+ats_numa_init(int enabled)
+{
+#if TS_USE_HWLOC
+  if (!enabled) {
+    Debug(DEBUG_TAG "_init", "NUMA arenas not enabled");
+    return;
+  }
+
+  hwloc_topology_t topology = ink_get_topology();
+  int nodes                 = hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_NODE);
+
+  if (nodes < 2) {
+    Debug(DEBUG_TAG "_init", "%d NUMA node(s), arenas not needed", nodes);
+    return;
+  }
+  if (nodes > ATS_NUMA_MAX_NODES) {
+    Warning("%d NUMA nodes, arenas are only used for the first %d", nodes, ATS_NUMA_MAX_NODES);
+    nodes = ATS_NUMA_MAX_NODES;
+  }
+
+  // Reserve address space only, pages are made accessible as the arenas grow.
+  size_t span = size_t(1) << ATS_NUMA_ARENA_SHIFT;
+  size_t size = span * nodes;
+  void *base  = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+  if (base == MAP_FAILED) {
+    Warning("Unable to reserve %zu bytes for NUMA arenas: %s", size, strerror(errno));
+    return;
+  }
+
+  for (int i = 0; i < nodes; ++i) {
+    hwloc_obj_t obj = hwloc_get_obj_by_type(topology, HWLOC_OBJ_NODE, i);
+    void *arena     = static_cast<char *>(base) + span * i;
+#if HWLOC_API_VERSION >= 0x20000
+    int res = hwloc_set_area_membind(topology, arena, span, obj->nodeset, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_BYNODESET);
+#else
+    int res = hwloc_set_area_membind_nodeset(topology, arena, span, obj->nodeset, HWLOC_MEMBIND_BIND, 0);
+#endif
+    if (res != 0) {
+      Warning("Unable to bind the NUMA arena of node %d: %s", i, strerror(errno));
+      munmap(base, size);
+      return;
+    }
+
+    unsigned cpu;
+    hwloc_bitmap_foreach_begin(cpu, obj->cpuset)
+    {
+      if (cpu >= numa_cpu_nodes.size()) {
+        numa_cpu_nodes.resize(cpu + 1, -1);
+      }
+      numa_cpu_nodes[cpu] = i;
+    }
+    hwloc_bitmap_foreach_end();
+  }
+
+  ats_numa_arena_base = static_cast<char *>(base);
+  ats_numa_arena_size = size;
+  numa_nodes          = nodes;
+  Debug(DEBUG_TAG "_init", "Reserved %d NUMA arenas of %zu bytes {%p}", nodes, span, base);
+#else
+  (void)enabled;
+  Debug(DEBUG_TAG "_init", "NUMA arenas require hwloc");
+#endif
+}
+
+void
+ats_numa_init_unbound(int nodes)
+{
+  if (numa_nodes > 0 || nodes < 1 || nodes > ATS_NUMA_MAX_NODES) {
+    return;
+  }
+
+  size_t size = (size_t(1) << ATS_NUMA_ARENA_SHIFT) * nodes;
+  void *base  = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+  if (base == MAP_FAILED) {
+    Warning("Unable to reserve %zu bytes for NUMA arenas: %s", size, strerror(errno));
+    return;
+  }
+
+  ats_numa_arena_base = static_cast<char *>(base);
+  ats_numa_arena_size = size;
+  numa_nodes          = nodes;
+}
+
+bool
+ats_numa_enabled()
+{
+  return numa_nodes > 0;
+}
+
+int
+ats_numa_node_count()
+{
+  return numa_nodes;
+}
+
+int
+ats_numa_cpu_node(int cpu)
+{
+  return (cpu >= 0 && static_cast<size_t>(cpu) < numa_cpu_nodes.size()) ? numa_cpu_nodes[cpu] : -1;
+}
+
+void *
+ats_numa_alloc(size_t s, int node)
+{
+  if (node < 0 || node >= numa_nodes) {
+    return nullptr;
+  }
+
+  size_t size   = INK_ALIGN(s, ats_pagesize());
+  size_t offset = numa_arena_used[node].fetch_add(size, std::memory_order_relaxed);
+
+  if (offset + size > (size_t(1) << ATS_NUMA_ARENA_SHIFT)) {
+    Debug(DEBUG_TAG, "NUMA arena of node %d is exhausted", node);
+    return nullptr;
+  }
+
+  char *mem = ats_numa_arena_base + (static_cast<size_t>(node) << ATS_NUMA_ARENA_SHIFT) + offset;
+  if (mprotect(mem, size, PROT_READ | PROT_WRITE) != 0) {
+    Debug(DEBUG_TAG, "Could not map %zu bytes of the NUMA arena of node %d: %s", size, node, strerror(errno));
+    return nullptr;
+  }
+
+  Debug(DEBUG_TAG, "Request/Allocation (%zu/%zu) node %d {%p}", s, size, node, mem);
+  return mem;
+}
@@ -0,0 +1,182 @@
+/** @file
+
+    Unit tests for TimerWheel
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "tscore/TimerWheel.h"
+#include "catch.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+struct Timer {
+  int id         = 0;
+  bool cancelled = false;
+  TimerWheelLink<Timer> link;
+};
+
+using Wheel = TimerWheel<Timer, TimerWheelLinkAccess<Timer, &Timer::link>>;
+
+constexpr ink_hrtime TICK  = HRTIME_MSECOND;
+constexpr ink_hrtime START = HRTIME_SECONDS(1000) + 123; // not on a tick
+
+auto keep = [](Timer *) { return false; };
+
+std::vector<int>
+expire(Wheel &wheel, ink_hrtime now)
+{
+  std::vector<int> ids;
+
+  wheel.advance(now, keep);
+  while (Timer *t = wheel.pop_ready()) {
+    ids.push_back(t->id);
+  }
+  return ids;
+}
+} // namespace
+
+TEST_CASE("TimerWheel", "[libts][TimerWheel]")
+{
+  Wheel wheel(TICK, START);
+  Timer a, b, c, d;
+  a.id = 1;
+  b.id = 2;
+  c.id = 3;
+  d.id = 4;
+
+  REQUIRE(wheel.size() == 0);
+  REQUIRE(wheel.earliest() >= START + HRTIME_YEAR);
+  REQUIRE(!Wheel::in(&a));
+
+  wheel.insert(&a, START + HRTIME_MSECONDS(10));
+  wheel.insert(&b, START + HRTIME_SECONDS(10));
+  wheel.insert(&c, START + HRTIME_HOURS(10));
+  wheel.insert(&d, START - HRTIME_MSECONDS(1));
+  REQUIRE(wheel.size() == 4);
+  REQUIRE(Wheel::in(&a));
+
+  SECTION("expire in order")
+  {
+    CHECK(wheel.earliest() == START);
+    CHECK(expire(wheel, START) == std::vector<int>{4});
+    CHECK(wheel.earliest() <= START + HRTIME_MSECONDS(10));
+    CHECK(wheel.earliest() > START);
+    CHECK(expire(wheel, START + HRTIME_MSECONDS(9)).empty());
+    CHECK(expire(wheel, START + HRTIME_MSECONDS(10)) == std::vector<int>{1});
+    CHECK(wheel.earliest() <= START + HRTIME_SECONDS(10));
+    CHECK(expire(wheel, START + HRTIME_SECONDS(9)).empty());
+    CHECK(expire(wheel, START + HRTIME_SECONDS(11)) == std::vector<int>{2});
+    CHECK(expire(wheel, START + HRTIME_HOURS(9)).empty());
+    CHECK(expire(wheel, START + HRTIME_HOURS(10)) == std::vector<int>{3});
+    CHECK(wheel.size() == 0);
+    CHECK(!Wheel::in(&c));
+  }
+
+  SECTION("remove")
+  {
+    wheel.remove(&b);
+    wheel.remove(&d);
+    CHECK(!Wheel::in(&b));
+    CHECK(wheel.size() == 2);
+    CHECK(expire(wheel, START + HRTIME_SECONDS(11)) == std::vector<int>{1});
+    wheel.remove(&c);
+    CHECK(wheel.size() == 0);
+  }
+
+  SECTION("discard")
+  {
+    c.cancelled = true;
+    auto cancelled = [](Timer *t) { return t->cancelled; };
+    // The hour long timer is swept eventually, well before it expires.
+    for (ink_hrtime now = START; now < START + HRTIME_SECONDS(30) && Wheel::in(&c); now += HRTIME_MSECONDS(1)) {
+      wheel.advance(now, cancelled);
+    }
+    CHECK(!Wheel::in(&c));
+    CHECK(wheel.size() == 3);
+  }
+}
+
+TEST_CASE("TimerWheel random", "[libts][TimerWheel]")
+{
+  std::mt19937_64 rng(42);
+  std::vector<std::unique_ptr<Timer>> timers;
+  std::set<Timer *> armed;
+  TimerWheelStats stats;
+  ink_hrtime now = START;
+  Wheel wheel(TICK, now);
+
+  wheel.set_stats(&stats);
+  for (int i = 0; i < 2000; ++i) {
+    timers.push_back(std::make_unique<Timer>());
+    timers.back()->id = i;
+  }
+
+  // Delays from the same tick to years ahead.
+  auto delay = [&]() -> ink_hrtime {
+    switch (rng() % 5) {
+    case 0:
+      return rng() % HRTIME_MSECONDS(5);
+    case 1:
+      return rng() % HRTIME_SECONDS(1);
+    case 2:
+      return rng() % HRTIME_SECONDS(300);
+    case 3:
+      return rng() % HRTIME_DAYS(2);
+    default:
+      return rng() % (HRTIME_DAYS(100));
+    }
+  };
+
+  for (int round = 0; round < 20000; ++round) {
+    Timer *t = timers[rng() % timers.size()].get();
+    if (Wheel::in(t)) {
+      if (rng() % 4 == 0) {
+        wheel.remove(t);
+        armed.erase(t);
+      }
+    } else {
+      wheel.insert(t, now + delay());
+      armed.insert(t);
+    }
+
+    // Mostly small steps, some long sleeps.
+    now += rng() % 8 ? rng() % HRTIME_MSECONDS(3) : rng() % HRTIME_SECONDS(rng() % 2 ? 2 : 20000);
+
+    ink_hrtime earliest = wheel.earliest();
+    REQUIRE(std::all_of(armed.begin(), armed.end(), [&](Timer *x) { return earliest <= x->link.expire_at; }));
+
+    wheel.advance(now, keep);
+    while (Timer *x = wheel.pop_ready()) {
+      // Never more than one tick early.
+      REQUIRE(x->link.expire_at / TICK <= now / TICK);
+      REQUIRE(armed.erase(x) == 1);
+    }
+    REQUIRE(std::all_of(armed.begin(), armed.end(), [&](Timer *x) { return x->link.expire_at / TICK > now / TICK; }));
+    REQUIRE(wheel.size() == static_cast<int64_t>(armed.size()));
+  }
+  CHECK(stats.timers == wheel.size());
+  CHECK(stats.expired > 0);
+}
@@ -0,0 +1,119 @@
+/** @file
+
+    Unit tests for WorkStealingDeque
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "tscore/WorkStealingDeque.h"
+#include "catch.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("WorkStealingDeque", "[libts][WorkStealingDeque]")
+{
+  WorkStealingDeque<int, 4> deque;
+  int v[5] = {0, 1, 2, 3, 4};
+
+  REQUIRE(deque.empty());
+  REQUIRE(deque.pop() == nullptr);
+  REQUIRE(deque.steal() == nullptr);
+
+  for (int i = 0; i < 4; ++i) {
+    REQUIRE(deque.push(&v[i]));
+  }
+  REQUIRE(!deque.push(&v[4]));
+  REQUIRE(deque.size() == 4);
+
+  // Owner end is LIFO, thief end FIFO.
+  CHECK(deque.pop() == &v[3]);
+  CHECK(deque.steal() == &v[0]);
+  CHECK(deque.steal() == &v[1]);
+  CHECK(deque.push(&v[4]));
+  CHECK(deque.pop() == &v[4]);
+  CHECK(deque.pop() == &v[2]);
+  CHECK(deque.pop() == nullptr);
+  CHECK(deque.empty());
+
+  // Wraps around the buffer.
+  for (int round = 0; round < 10; ++round) {
+    CHECK(deque.push(&v[round % 5]));
+    CHECK(deque.steal() == &v[round % 5]);
+  }
+}
+
+TEST_CASE("WorkStealingDeque threads", "[libts][WorkStealingDeque]")
+{
+  static constexpr int COUNT   = 200000;
+  static constexpr int THIEVES = 3;
+
+  WorkStealingDeque<int, 256> deque;
+  std::vector<int> items(COUNT);
+  std::vector<std::atomic<int>> seen(COUNT);
+  std::atomic<int> taken{0};
+  std::atomic<bool> done{false};
+
+  auto take = [&](int *item) {
+    seen[item - items.data()].fetch_add(1);
+    taken.fetch_add(1);
+  };
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < THIEVES; ++i) {
+    thieves.emplace_back([&]() {
+      while (!done.load()) {
+        if (int *item = deque.steal()) {
+          take(item);
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < COUNT; ++i) {
+    while (!deque.push(&items[i])) {
+      if (int *item = deque.pop()) {
+        take(item);
+      }
+    }
+    if (i % 3 == 0) {
+      if (int *item = deque.pop()) {
+        take(item);
+      }
+    }
+  }
+  while (int *item = deque.pop()) {
+    take(item);
+  }
+  while (taken.load() < COUNT) {
+    std::this_thread::yield();
+  }
+  done = true;
+  for (auto &t : thieves) {
+    t.join();
+  }
+
+  REQUIRE(taken.load() == COUNT);
+  int wrong = 0;
+  for (auto &s : seen) {
+    wrong += s.load() != 1;
+  }
+  REQUIRE(wrong == 0);
+}
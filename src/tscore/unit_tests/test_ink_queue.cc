@@ -0,0 +1,139 @@
+/** @file
+
+    Unit tests for the NUMA node stacks of ink_queue freelists
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "tscore/ink_queue.h"
+#include "tscore/numa.h"
+#include "catch.hpp"
+
+#include <vector>
+
+namespace
+{
+constexpr int NODES = 2;
+constexpr int ITEMS = 64;
+
+bool
+on_stack(head_p const &head, void *item)
+{
+  for (void *p = TO_PTR(FREELIST_POINTER(head)); p; p = TO_PTR(*static_cast<void **>(p))) {
+    if (p == item) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<void *>
+alloc_on_node(InkFreeList *f, int node, int n)
+{
+  std::vector<void *> items;
+  ats_numa_thread_node = node;
+  for (int i = 0; i < n; ++i) {
+    items.push_back(ink_freelist_new(f));
+  }
+  ats_numa_thread_node = -1;
+  return items;
+}
+} // namespace
+
+TEST_CASE("NUMA node freelists", "[libts][ink_queue]")
+{
+  ats_numa_init_unbound(NODES);
+  REQUIRE(ats_numa_node_count() == NODES);
+
+  InkFreeList *f = ink_freelist_create("test_numa", 64, 16, 8);
+  REQUIRE(f->nodes != nullptr);
+
+  std::vector<void *> items[NODES];
+  for (int node = 0; node < NODES; ++node) {
+    items[node] = alloc_on_node(f, node, ITEMS);
+    for (void *p : items[node]) {
+      CHECK(ats_numa_node_of(p) == node);
+    }
+  }
+  uint32_t allocated = f->allocated;
+
+  // An unbound thread takes shared memory.
+  void *shared = ink_freelist_new(f);
+  CHECK(ats_numa_node_of(shared) == -1);
+  allocated = f->allocated;
+
+  SECTION("free returns items to the stack of their node")
+  {
+    // Freed by a thread of the other node.
+    ats_numa_thread_node = 1;
+    for (void *p : items[0]) {
+      ink_freelist_free(f, p);
+    }
+    ats_numa_thread_node = -1;
+    ink_freelist_free(f, shared);
+
+    for (void *p : items[0]) {
+      CHECK(on_stack(f->nodes[0].head, p));
+      CHECK_FALSE(on_stack(f->nodes[1].head, p));
+      CHECK_FALSE(on_stack(f->head, p));
+    }
+    CHECK(on_stack(f->head, shared));
+
+    // Node 0 gets its own items back without growing the freelist.
+    for (void *p : alloc_on_node(f, 0, ITEMS)) {
+      CHECK(ats_numa_node_of(p) == 0);
+    }
+    CHECK(f->allocated == allocated);
+  }
+
+  SECTION("bulk free of one node's items")
+  {
+    for (size_t i = 0; i + 1 < items[1].size(); ++i) {
+      *static_cast<void **>(items[1][i]) = items[1][i + 1];
+    }
+    ink_freelist_free_bulk(f, items[1].front(), items[1].back(), items[1].size());
+
+    for (void *p : items[1]) {
+      CHECK(on_stack(f->nodes[1].head, p));
+    }
+    CHECK(f->allocated == allocated);
+  }
+
+  SECTION("bulk free of mixed items splits them by node")
+  {
+    std::vector<void *> chain;
+    for (int i = 0; i < ITEMS; ++i) {
+      chain.push_back(items[i % NODES][i]);
+    }
+    chain.push_back(shared);
+    for (size_t i = 0; i + 1 < chain.size(); ++i) {
+      *static_cast<void **>(chain[i]) = chain[i + 1];
+    }
+    ink_freelist_free_bulk(f, chain.front(), chain.back(), chain.size());
+
+    for (int i = 0; i < ITEMS; ++i) {
+      int node = i % NODES;
+      CHECK(on_stack(f->nodes[node].head, items[node][i]));
+      CHECK_FALSE(on_stack(f->nodes[1 - node].head, items[node][i]));
+      CHECK_FALSE(on_stack(f->head, items[node][i]));
+    }
+    CHECK(on_stack(f->head, shared));
+    CHECK(f->allocated == allocated);
+  }
+}
@@ -25,6 +25,11 @@ limitations under the License.
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "I_EventSystem.h"
 #include "I_Thread.h"
 #include "tscore/Allocator.h"
@@ -110,3 +115,124 @@ TEST_CASE("ProxyAllocator", "[iocore]")
 
   delete bench_thread;
 }
+
+namespace
+{
+constexpr int BATCH  = 64;  // Items handed to the next thread at once.
+constexpr int ROUNDS = 256; // Batches allocated by each thread.
+
+struct Mailbox {
+  std::mutex mutex;
+  std::vector<std::vector<BItem *>> batches;
+};
+
+// The thread cache before the magazine depot, refilled from the freelist one item at a time and drained to it in bulk.
+BItem *
+freelist_thread_alloc(ProxyAllocator &l)
+{
+  if (l.freelist) {
+    void *v    = l.freelist;
+    l.freelist = *static_cast<void **>(l.freelist);
+    --(l.allocated);
+    return static_cast<BItem *>(v);
+  }
+  return ioAllocator.alloc();
+}
+
+void
+freelist_thread_free(BItem *item, ProxyAllocator &l)
+{
+  *reinterpret_cast<void **>(item) = l.freelist;
+  l.freelist                       = item;
+  if (++(l.allocated) > thread_freelist_high_watermark) {
+    void *head   = l.freelist;
+    void *tail   = l.freelist;
+    size_t count = 0;
+    while (l.allocated > thread_freelist_low_watermark) {
+      tail       = l.freelist;
+      l.freelist = *static_cast<void **>(l.freelist);
+      --(l.allocated);
+      ++count;
+    }
+    ioAllocator.raw().free_void_bulk(head, tail, count);
+  }
+}
+
+// Each thread allocates batches and frees the batches allocated by the previous thread, so the
+// thread caches of the allocating threads keep running dry.
+void
+cross_thread_free(bool depot, Thread *thread, Mailbox &own, Mailbox &next)
+{
+  thread->set_specific();
+
+  std::vector<std::vector<BItem *>> received;
+  for (int round = 0; round < ROUNDS; ++round) {
+    std::vector<BItem *> batch;
+    batch.reserve(BATCH);
+    for (int i = 0; i < BATCH; ++i) {
+      batch.push_back(depot ? THREAD_ALLOC(ioAllocator, this_thread()) : freelist_thread_alloc(thread->ioAllocator));
+    }
+    {
+      std::lock_guard<std::mutex> lock(next.mutex);
+      next.batches.push_back(std::move(batch));
+    }
+    {
+      std::lock_guard<std::mutex> lock(own.mutex);
+      received.swap(own.batches);
+    }
+    for (auto &items : received) {
+      for (auto item : items) {
+        if (depot) {
+          THREAD_FREE(item, ioAllocator, this_thread());
+        } else {
+          freelist_thread_free(item, thread->ioAllocator);
+        }
+      }
+    }
+    received.clear();
+  }
+}
+} // namespace
+
+TEST_CASE("ProxyAllocator cross thread free", "[iocore]")
+{
+  constexpr int MAX_THREADS = 128;
+
+  thread_freelist_high_watermark = 512;
+  thread_freelist_low_watermark  = 32;
+
+  // The thread caches are kept across the runs, like those of the event threads.
+  std::vector<Thread *> threads;
+  for (int i = 0; i < MAX_THREADS; ++i) {
+    threads.push_back(new BThread());
+  }
+
+  for (bool depot : {false, true}) {
+    for (int n = 1; n <= MAX_THREADS; n *= 2) {
+      BENCHMARK(std::string(depot ? "magazine depot, " : "freelist, ") + std::to_string(n) + " threads")
+      {
+        std::vector<Mailbox> mailboxes(n);
+        std::vector<std::thread> workers;
+        for (int i = 0; i < n; ++i) {
+          workers.emplace_back(cross_thread_free, depot, threads[i], std::ref(mailboxes[i]), std::ref(mailboxes[(i + 1) % n]));
+        }
+        for (auto &worker : workers) {
+          worker.join();
+        }
+        // Batches posted after their receiver finished.
+        for (auto &mailbox : mailboxes) {
+          for (auto &items : mailbox.batches) {
+            for (auto item : items) {
+              ioAllocator.free(item);
+            }
+          }
+        }
+        return n;
+      };
+    }
+  }
+
+  for (auto thread : threads) {
+    delete thread;
+  }
+}
@@ -0,0 +1,162 @@
+/** @file
+
+  Micro Benchmark of the HostDB cache hit path across thread counts - requires Catch2 v2.9.0+
+
+  A HostDBProcessor::getbyname_re that hits the cache is a RefCountCache lookup, which this measures
+  for a small set of popular keys, with and without the partition lock readers used to take.
+
+  - e.g. 16 threads looking up 8 hot keys, with one update per 1000 lookups
+  ```
+  $ taskset -c 0-15 ./benchmark_RefCountCache --ts-nthreads 16 --ts-nkeys 8 --ts-nloop 1000 --ts-nread 1000 --ts-nwrite 1
+  ```
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+      http://www.apache.org/licenses/LICENSE-2.0
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+
+#include "P_RefCountCache.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Args
+struct Conf {
+  int nloop    = 1;
+  int nthreads = 1;
+  int nkeys    = 8;
+  int nread    = 1000;
+  int nwrite   = 1;
+};
+
+Conf conf;
+
+struct Record : public RefCountObj {
+  uint64_t key;
+};
+
+// Each thread reads nread times and updates nwrite times per loop, writers publish a new Record like HostDB does
+template <bool locked>
+uint64_t
+run(RefCountCache<Record> &cache, std::vector<uint64_t> const &keys)
+{
+  std::vector<std::thread> list;
+  std::atomic<uint64_t> hits{0};
+
+  for (int i = 0; i < conf.nthreads; i++) {
+    list.emplace_back([&cache, &keys, &hits, i]() {
+      uint64_t h = 0;
+      size_t k   = i;
+      for (int j = 0; j < conf.nloop; ++j) {
+        // reader
+        for (int r = 0; r < conf.nread; ++r) {
+          uint64_t key = keys[k++ % keys.size()];
+          Ptr<Record> record;
+          if constexpr (locked) {
+            std::shared_lock<ts::shared_mutex> lock{cache.lock_for_key(key)};
+            record = cache.get(key);
+          } else {
+            record = cache.get(key);
+          }
+          h += record && record->key == key;
+        }
+
+        // writer
+        for (int w = 0; w < conf.nwrite; ++w) {
+          uint64_t key   = keys[k++ % keys.size()];
+          Record *record = new Record;
+          record->key    = key;
+          std::unique_lock<ts::shared_mutex> lock{cache.lock_for_key(key)};
+          cache.put(key, record);
+        }
+      }
+      hits += h;
+    });
+  }
+
+  for (auto &t : list) {
+    t.join();
+  }
+
+  return hits;
+}
+
+} // namespace
+
+TEST_CASE("Micro benchmark of RefCountCache hits", "")
+{
+  RefCountCache<Record> cache(64, -1, 120000);
+  std::vector<uint64_t> keys;
+
+  for (int i = 0; i < conf.nkeys; ++i) {
+    uint64_t key   = 0x9e3779b97f4a7c15ULL * (i + 1);
+    Record *record = new Record;
+    record->key    = key;
+    keys.push_back(key);
+    cache.put(key, record);
+  }
+
+  SECTION("shared lock and get")
+  {
+    BENCHMARK("shared lock and get")
+    {
+      return run<true>(cache, keys);
+    };
+  }
+
+  SECTION("lock free get")
+  {
+    BENCHMARK("lock free get")
+    {
+      return run<false>(cache, keys);
+    };
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  Catch::Session session;
+
+  using namespace Catch::clara;
+
+  // clang-format off
+  auto cli = session.cli() |
+    Opt(conf.nthreads, "")["--ts-nthreads"]("number of threads (default: 1)") |
+    Opt(conf.nkeys, "")["--ts-nkeys"]("number of popular keys (default: 8)") |
+    Opt(conf.nread, "")["--ts-nread"]("number of lookups per loop (default: 1000)") |
+    Opt(conf.nwrite, "")["--ts-nwrite"]("number of updates per loop (default: 1)") |
+    Opt(conf.nloop, "")["--ts-nloop"]("number of read-write loop (default: 1)");
+  // clang-format on
+
+  session.cli(cli);
+
+  int returnCode = session.applyCommandLine(argc, argv);
+  if (returnCode != 0) {
+    return returnCode;
+  }
+
+  return session.run();
+}